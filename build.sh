@@ -1,5 +1,8 @@
 #nRF9160 SiP
 west build -b thingy91_nrf9160_ns -p -- -DOVERLAY_CONFIG=./project.conf
 
+# Debug build, counts CPU wakeups from idle
+# west build -b thingy91_nrf9160_ns -p -- -DOVERLAY_CONFIG="./project.conf;./debug.conf"
+
 # Flash board
 # west flash
\ No newline at end of file
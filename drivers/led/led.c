@@ -1,11 +1,43 @@
 #include <zephyr.h>
 #include <drivers/gpio.h>
 #include "led.h"
+#include "src/energy/energy.h"
 
 static struct gpio_dt_spec red_led = GPIO_DT_SPEC_GET(DT_ALIAS(led0), gpios);
 static struct gpio_dt_spec green_led = GPIO_DT_SPEC_GET(DT_ALIAS(led1), gpios);
 static struct gpio_dt_spec blue_led = GPIO_DT_SPEC_GET(DT_ALIAS(led2), gpios);
 
+/**
+ * @brief Set a LED and account the time any LED is on
+ *
+ * @param led the LED
+ * @param led_bit bit of the LED in the mask of LEDs that are on
+ * @param state 0 for OFF, 1 for ON, -1 to toggle
+ * @return int 0 on sucess, negative on fail
+ */
+static int led_state_set(const struct gpio_dt_spec *led, uint8_t led_bit, int state)
+{
+    static atomic_t on_mask;
+    int retval = 0;
+
+    retval = (state < 0) ? gpio_pin_toggle_dt(led) : gpio_pin_set_dt(led, state);
+    if (0 != retval) {
+        return retval;
+    }
+
+    if (state < 0) {
+        atomic_xor(&on_mask, led_bit);
+    } else if (state) {
+        atomic_or(&on_mask, led_bit);
+    } else {
+        atomic_and(&on_mask, ~led_bit);
+    }
+    energy_state_set(ENERGY_LED, 0 != atomic_get(&on_mask));
+
+    return 0;
+}
+
+
 int led_init(void)
 {
     int retval = 0;
@@ -20,35 +52,35 @@ int led_init(void)
 
 int led_red_state_set(uint8_t state)
 {
-    return gpio_pin_set_dt(&red_led, state);
+    return led_state_set(&red_led, BIT(0), state);
 }
 
 
 int led_red_state_toggle(void)
 {
-    return gpio_pin_toggle_dt(&red_led);
+    return led_state_set(&red_led, BIT(0), -1);
 }
 
 
 int led_green_state_set(uint8_t state)
 {
-    return gpio_pin_set_dt(&green_led, state);
+    return led_state_set(&green_led, BIT(1), state);
 }
 
 
 int led_green_state_toggle(void)
 {
-    return gpio_pin_toggle_dt(&green_led);
+    return led_state_set(&green_led, BIT(1), -1);
 }
 
 
 int led_blue_state_set(uint8_t state)
 {
-    return gpio_pin_set_dt(&blue_led, state);
+    return led_state_set(&blue_led, BIT(2), state);
 }
 
 
 int led_blue_state_toggle(void)
 {
-    return gpio_pin_toggle_dt(&blue_led);
+    return led_state_set(&blue_led, BIT(2), -1);
 }
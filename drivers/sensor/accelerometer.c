@@ -2,26 +2,98 @@
 #include <stdio.h>
 #include <string.h>
 #include <zephyr/drivers/sensor.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/sys/byteorder.h>
 #include <stdlib.h>
 
 #include "accelerometer.h"
+#include "src/lib/instr.h"
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(accelerometer, CONFIG_ACCELEROMETER_DRIVER_LOG_LEVEL);
 
-/* Convert to s/m2 depending on the maximum measured range used for adxl362. */
+/* Samples are kept as integers in mg. A raw sample is 1, 2 or 4 mg per LSB depending on the measuring range used for
+ *   adxl362, so the conversion is a shift. The range used for adxl362 at build is the initial range.
+ */
 #if defined(CONFIG_ADXL362_ACCEL_RANGE_2G)
-# define ADXL362_RANGE_MAX_M_S2 19.6133
+# define ADXL362_RANGE_SHIFT_DEFAULT    0
 #elif defined(CONFIG_ADXL362_ACCEL_RANGE_4G)
-# define ADXL362_RANGE_MAX_M_S2 39.2266
+# define ADXL362_RANGE_SHIFT_DEFAULT    1
 #elif defined(CONFIG_ADXL362_ACCEL_RANGE_8G)
-# define ADXL362_RANGE_MAX_M_S2 78.4532
+# define ADXL362_RANGE_SHIFT_DEFAULT    2
 #endif
 
+#define ADXL362_RANGE_MAX_MG(_shift)    (2000 << (_shift))
+
 #define ADXL362_THRESHOLD_RESOLUTION_DECIMAL_MAX 2048
 
-/* Local accelerometer threshold value. Used to filter out unwanted values in the callback from the accelerometer.
+/* ADXL362 registers and SPI commands used to read the samples next to the Zephyr driver */
+#define ADXL362_CMD_WRITE_REG           0x0A
+#define ADXL362_CMD_READ_REG            0x0B
+#define ADXL362_REG_XDATA_L             0x0E
+#define ADXL362_REG_TIME_ACT            0x22
+#define ADXL362_REG_FILTER_CTL          0x2C
+#define ADXL362_REG_POWER_CTL           0x2D
+#define ADXL362_FILTER_CTL_RANGE_POS    6
+#define ADXL362_FILTER_CTL_MASK         0xC7
+#define ADXL362_POWER_CTL_MEASURE_MASK  0x03
+
+/* Timer value in samples at the output data rate */
+#define ADXL362_TIME_SAMPLES(_ms)       ((uint64_t)(_ms) * odr_mhz / (MSEC_PER_SEC * MSEC_PER_SEC))
+
+/* Output data rates [mHz], the index is the ODR code in FILTER_CTL */
+static const uint32_t odr_codes[] = { 12500, 25000, 50000, 100000, 200000, 400000 };
+
+#if defined(CONFIG_ACCELEROMETER_ACT_INACT)
+
+# define ADXL362_REG_STATUS             0x0B
+# define ADXL362_REG_THRESH_INACT_L     0x23
+# define ADXL362_REG_THRESH_INACT_H     0x24
+# define ADXL362_REG_TIME_INACT_L       0x25
+# define ADXL362_REG_TIME_INACT_H       0x26
+# define ADXL362_REG_ACT_INACT_CTL      0x27
+# define ADXL362_STATUS_AWAKE           BIT(6)
+# define ADXL362_ACT_INACT_CTL_ACT_EN   BIT(0)
+# define ADXL362_ACT_INACT_CTL_ACT_REF  BIT(1)
+# define ADXL362_ACT_INACT_CTL_INACT_EN BIT(2)
+# define ADXL362_ACT_INACT_CTL_INACT_REF    BIT(3)
+# define ADXL362_ACT_INACT_CTL_LINKED   (0x01 << 4)
+# define ADXL362_POWER_CTL_AUTOSLEEP    BIT(2)
+
+#endif /* if defined(CONFIG_ACCELEROMETER_ACT_INACT) */
+
+#if defined(CONFIG_ACCELEROMETER_FIFO)
+
+# define ADXL362_CMD_READ_FIFO          0x0D
+# define ADXL362_REG_FIFO_ENTRIES_L     0x0C
+# define ADXL362_REG_FIFO_CONTROL       0x28
+# define ADXL362_REG_FIFO_SAMPLES       0x29
+# define ADXL362_REG_INTMAP1            0x2A
+# define ADXL362_FIFO_CONTROL_AH        BIT(3)
+# define ADXL362_FIFO_CONTROL_STREAM    0x02
+# define ADXL362_INTMAP1_FIFO_WATERMARK BIT(2)
+
+/* Each FIFO entry holds one axis, bits 15:14 tell which */
+# define ADXL362_FIFO_ENTRY_AXIS(_entry)    (((_entry) >> 14) & 0x03)
+# define ADXL362_FIFO_ENTRY_DATA(_entry)    ((int16_t)((_entry) << 2) >> 2)
+# define ADXL362_FIFO_AXIS_Z                2
+
+# define ACCELEROMETER_FIFO_ENTRIES     (CONFIG_ACCELEROMETER_FIFO_WATERMARK * ACCELEROMETER_CHANNELS)
+
+/* Batch buffers, only used from the sensor trigger thread */
+static uint16_t fifo_raw[ACCELEROMETER_FIFO_ENTRIES];
+static int16_t fifo_xyz[CONFIG_ACCELEROMETER_FIFO_WATERMARK][ACCELEROMETER_CHANNELS];
+#endif /* if defined(CONFIG_ACCELEROMETER_FIFO) */
+
+static const struct spi_dt_spec accel_spi = SPI_DT_SPEC_GET(DT_ALIAS(accelerometer),
+    SPI_WORD_SET(8) | SPI_TRANSFER_MSB, 0);
+
+/* Local accelerometer threshold value [mg]. Used to filter out unwanted values in the callback from the accelerometer.
  */
-double threshold = ADXL362_RANGE_MAX_M_S2;
+static int threshold_mg = ADXL362_RANGE_MAX_MG(ADXL362_RANGE_SHIFT_DEFAULT);
+static uint8_t range_shift = ADXL362_RANGE_SHIFT_DEFAULT;
+static uint32_t odr_mhz = ACCELEROMETER_ODR_MHZ;
+/* Time above the threshold before a trigger [ms] */
+static uint16_t debounce_ms;
 static accelerometer_handler_t evt_handler;
 static bool initial_trigger;
 
@@ -36,13 +108,284 @@ static struct env_sensor accel_sensor = {
     .dev = DEVICE_DT_GET(DT_ALIAS(accelerometer)),
 };
 
+/**
+ * @brief Write an ADXL362 register
+ *
+ * @param reg the register
+ * @param value the value to write
+ * @return int 0 on success, negative on fail
+ */
+static int accelerometer_reg_write(uint8_t reg, uint8_t value)
+{
+    uint8_t cmd[] = { ADXL362_CMD_WRITE_REG, reg, value };
+    const struct spi_buf tx_buf = { .buf = cmd, .len = sizeof(cmd) };
+    const struct spi_buf_set tx = { .buffers = &tx_buf, .count = 1 };
+
+    return spi_write_dt(&accel_spi, &tx);
+}
+
+
+/**
+ * @brief Read consecutive ADXL362 registers in one SPI transaction
+ *
+ * @param reg the first register
+ * @param data where the register values are stored
+ * @param len number of registers to read
+ * @return int 0 on success, negative on fail
+ */
+static int accelerometer_reg_read(uint8_t reg, uint8_t *data, size_t len)
+{
+    uint8_t cmd[] = { ADXL362_CMD_READ_REG, reg };
+    const struct spi_buf tx_buf = { .buf = cmd, .len = sizeof(cmd) };
+    const struct spi_buf_set tx = { .buffers = &tx_buf, .count = 1 };
+    const struct spi_buf rx_bufs[] = {
+        { .buf = NULL, .len = sizeof(cmd) },
+        { .buf = data, .len = len },
+    };
+    const struct spi_buf_set rx = { .buffers = rx_bufs, .count = ARRAY_SIZE(rx_bufs) };
+
+    return spi_transceive_dt(&accel_spi, &tx, &rx);
+}
+
+
+/**
+ * @brief Read the current xyz sample
+ *
+ * @param xyz where the sample [mg] is stored
+ * @return int 0 on success, negative on fail
+ */
+static int accelerometer_sample_read(int16_t xyz[ACCELEROMETER_CHANNELS])
+{
+    int retval = 0;
+    uint8_t data[ACCELEROMETER_CHANNELS * sizeof(int16_t)];
+
+    retval = accelerometer_reg_read(ADXL362_REG_XDATA_L, data, sizeof(data));
+    if (0 != retval) {
+        return retval;
+    }
+
+    /* The data registers are sign extended to 16 bits */
+    for (int i = 0; i < ACCELEROMETER_CHANNELS; i++) {
+        xyz[i] = (int16_t)sys_get_le16(&data[i * sizeof(int16_t)]) * (1 << range_shift);
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Check a sample against the movement threshold, per axis
+ *
+ * @param xyz the sample [mg]
+ * @return true if any axis is above the threshold
+ */
+static bool accelerometer_threshold_check(const int16_t xyz[ACCELEROMETER_CHANNELS])
+{
+    return (abs(xyz[0]) > threshold_mg) || (abs(xyz[1]) > threshold_mg) || (abs(xyz[2]) > threshold_mg);
+}
+
+
+#if defined(CONFIG_ACCELEROMETER_FIFO)
+
+/**
+ * @brief Read the number of entries in the FIFO
+ *
+ * @param entries where the number of entries is stored
+ * @return int 0 on success, negative on fail
+ */
+static int accelerometer_fifo_entries_get(uint16_t *entries)
+{
+    int retval = 0;
+    uint8_t value[2];
+
+    retval = accelerometer_reg_read(ADXL362_REG_FIFO_ENTRIES_L, value, sizeof(value));
+    if (0 != retval) {
+        return retval;
+    }
+
+    *entries = sys_get_le16(value) & 0x3FF;
+
+    return 0;
+}
+
+
+/**
+ * @brief Read FIFO entries in one SPI burst
+ *
+ * @param entries number of entries to read
+ * @return int 0 on success, negative on fail
+ */
+static int accelerometer_fifo_burst_read(uint16_t entries)
+{
+    uint8_t cmd = ADXL362_CMD_READ_FIFO;
+    const struct spi_buf tx_buf = { .buf = &cmd, .len = sizeof(cmd) };
+    const struct spi_buf_set tx = { .buffers = &tx_buf, .count = 1 };
+    const struct spi_buf rx_bufs[] = {
+        { .buf = NULL, .len = sizeof(cmd) },
+        { .buf = fifo_raw, .len = entries * sizeof(fifo_raw[0]) },
+    };
+    const struct spi_buf_set rx = { .buffers = rx_bufs, .count = ARRAY_SIZE(rx_bufs) };
+
+    return spi_transceive_dt(&accel_spi, &tx, &rx);
+}
+
+
+/**
+ * @brief Put the FIFO in stream mode and interrupt on the watermark instead of on every sample. Called after
+ *   sensor_trigger_set(), which maps data ready to INT1.
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int accelerometer_fifo_setup(void)
+{
+    int retval = 0;
+    uint16_t watermark = ACCELEROMETER_FIFO_ENTRIES;
+
+    retval = accelerometer_reg_write(ADXL362_REG_FIFO_SAMPLES, (uint8_t)watermark);
+    retval |= accelerometer_reg_write(ADXL362_REG_FIFO_CONTROL,
+        ((watermark > UINT8_MAX) ? ADXL362_FIFO_CONTROL_AH : 0) | ADXL362_FIFO_CONTROL_STREAM);
+    retval |= accelerometer_reg_write(ADXL362_REG_INTMAP1, ADXL362_INTMAP1_FIFO_WATERMARK);
+
+    return retval;
+}
+
+
+/**
+ * @brief Read the whole xyz samples of up to a batch from the FIFO, the rest stays for the next batch
+ *
+ * @param entries number of entries in the FIFO
+ * @param cnt where the number of samples in fifo_xyz is stored
+ * @return int 0 on success, negative on fail
+ */
+static int accelerometer_fifo_read(uint16_t entries, uint16_t *cnt)
+{
+    int retval = 0;
+    uint16_t entry;
+    uint8_t axis;
+    uint8_t axis_mask = 0;
+
+    *cnt = 0;
+
+    entries = MIN(entries, ACCELEROMETER_FIFO_ENTRIES);
+    entries -= entries % ACCELEROMETER_CHANNELS;
+    if (0 == entries) {
+        return 0;
+    }
+
+    retval = accelerometer_fifo_burst_read(entries);
+    if (0 != retval) {
+        return retval;
+    }
+
+    for (int i = 0; i < entries; i++) {
+        entry = sys_le16_to_cpu(fifo_raw[i]);
+        axis = ADXL362_FIFO_ENTRY_AXIS(entry);
+        if (axis >= ACCELEROMETER_CHANNELS) {
+            continue;
+        }
+
+        fifo_xyz[*cnt][axis] = ADXL362_FIFO_ENTRY_DATA(entry) * (1 << range_shift);
+        axis_mask |= BIT(axis);
+
+        /* A sample is complete at its z entry, a sample cut off by an overrun is dropped */
+        if (ADXL362_FIFO_AXIS_Z == axis) {
+            if (BIT_MASK(ACCELEROMETER_CHANNELS) == axis_mask) {
+                (*cnt)++;
+            }
+            axis_mask = 0;
+        }
+    }
+
+    return 0;
+} /* accelerometer_fifo_read */
+
+
+/**
+ * @brief Report a batch read into fifo_xyz, and its first sample above the threshold like a threshold trigger
+ *
+ * @param cnt number of samples in fifo_xyz
+ */
+static void accelerometer_fifo_batch_report(uint16_t cnt)
+{
+    int trigger_idx = -1;
+    struct accelerometer_sensor_event evt = { 0 };
+
+    for (int i = 0; (i < cnt) && (trigger_idx < 0); i++) {
+        if (accelerometer_threshold_check(fifo_xyz[i])) {
+            trigger_idx = i;
+        }
+    }
+
+    if (0 != cnt) {
+        evt.type = ACCELEROMETER_EVENT_FIFO;
+        evt.fifo.xyz = fifo_xyz;
+        evt.fifo.cnt = cnt;
+        evt_handler(&evt);
+    }
+
+    if (trigger_idx >= 0) {
+        evt.type = ACCELEROMETER_EVENT_TRIGGER;
+        memcpy(evt.value_array, fifo_xyz[trigger_idx], sizeof(evt.value_array));
+        evt_handler(&evt);
+    }
+}
+
+
+/* The Zephyr driver calls the data ready handler when the data ready status bit is set, and not on the FIFO watermark
+ *   bit. Data ready is only cleared by reading the data registers, which are not read in FIFO mode, so it stays set
+ *   from the first sample on and the handler runs on every watermark interrupt.
+ *
+ * INT1 is edge triggered. A watermark reached again while a batch is read gives no new edge, so the batches are read
+ *   until the FIFO holds less than a batch, which clears the watermark status and lets the next batch interrupt.
+ */
+static void accelerometer_fifo_handler(const struct device *dev, const struct sensor_trigger *trig)
+{
+    uint16_t entries = 0;
+    uint16_t cnt = 0;
+    bool first = true;
+
+    INSTR_BEGIN(INSTR_ACCEL_TRIGGER);
+
+    while (true) {
+        if (0 != accelerometer_fifo_entries_get(&entries)) {
+            LOG_ERR("FIFO entries read error");
+            break;
+        }
+
+        if (!first && (entries < ACCELEROMETER_FIFO_ENTRIES)) {
+            break;
+        }
+        first = false;
+
+        if (0 != accelerometer_fifo_read(entries, &cnt)) {
+            LOG_ERR("FIFO read error");
+            break;
+        }
+
+        if (!initial_trigger) {
+            /* Ignore the first batch after initialization of the accelerometer which always carries jibberish xyz
+             *   values.
+             */
+            initial_trigger = true;
+            continue;
+        }
+
+        accelerometer_fifo_batch_report(cnt);
+    }
+
+    INSTR_END(INSTR_ACCEL_TRIGGER);
+} /* accelerometer_fifo_handler */
+
+
+#endif /* if defined(CONFIG_ACCELEROMETER_FIFO) */
+
 static void accelerometer_trigger_handler(const struct device *dev,
   const struct sensor_trigger *trig)
 {
-    int err = 0;
-    struct sensor_value data[ACCELEROMETER_CHANNELS];
     struct accelerometer_sensor_event evt = { 0 };
 
+    INSTR_BEGIN(INSTR_ACCEL_TRIGGER);
+
     switch (trig->type) {
         case SENSOR_TRIG_THRESHOLD:
 
@@ -54,30 +397,14 @@ static void accelerometer_trigger_handler(const struct device *dev,
                 break;
             }
 
-            if (sensor_sample_fetch(dev) < 0) {
-                LOG_ERR("Sample fetch error");
-                return;
-            }
-
-            err = sensor_channel_get(dev, SENSOR_CHAN_ACCEL_X, &data[0]);
-            err += sensor_channel_get(dev, SENSOR_CHAN_ACCEL_Y, &data[1]);
-            err += sensor_channel_get(dev, SENSOR_CHAN_ACCEL_Z, &data[2]);
-
-            if (err) {
-                LOG_ERR("sensor_channel_get, error: %d", err);
-                return;
+            if (0 != accelerometer_sample_read(evt.value_array)) {
+                LOG_ERR("Sample read error");
+                break;
             }
 
-            evt.value_array[0] = sensor_value_to_double(&data[0]);
-            evt.value_array[1] = sensor_value_to_double(&data[1]);
-            evt.value_array[2] = sensor_value_to_double(&data[2]);
-
             /* Do a soft filter here to avoid sending data triggered by the inactivity threshold.
              */
-            if ((abs(evt.value_array[0]) > threshold ||
-              (abs(evt.value_array[1]) > threshold) ||
-              (abs(evt.value_array[2]) > threshold)))
-            {
+            if (accelerometer_threshold_check(evt.value_array)) {
                 evt.type = ACCELEROMETER_EVENT_TRIGGER;
                 evt_handler(&evt);
             }
@@ -86,9 +413,110 @@ static void accelerometer_trigger_handler(const struct device *dev,
         default:
             LOG_ERR("Unknown trigger");
     }
+
+    INSTR_END(INSTR_ACCEL_TRIGGER);
 } /* accelerometer_trigger_handler */
 
 
+#if defined(CONFIG_ACCELEROMETER_ACT_INACT)
+
+/**
+ * @brief Set up linked mode, activity and inactivity alternate so the host is only interrupted on state changes.
+ *   With autosleep the ADXL362 drops to wake-up mode while inactive.
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int accelerometer_act_inact_setup(void)
+{
+    int retval = 0;
+    uint8_t power_ctl = 0;
+    uint16_t thresh_inact = MIN(CONFIG_ACCELEROMETER_INACTIVITY_THRESHOLD >> range_shift,
+        ADXL362_THRESHOLD_RESOLUTION_DECIMAL_MAX - 1);
+    uint16_t time_inact = MIN(ADXL362_TIME_SAMPLES(CONFIG_ACCELEROMETER_INACTIVITY_TIME * MSEC_PER_SEC),
+        UINT16_MAX);
+
+    retval = accelerometer_reg_write(ADXL362_REG_TIME_ACT,
+        MIN(ADXL362_TIME_SAMPLES(debounce_ms), UINT8_MAX));
+    retval |= accelerometer_reg_write(ADXL362_REG_THRESH_INACT_L, thresh_inact & 0xFF);
+    retval |= accelerometer_reg_write(ADXL362_REG_THRESH_INACT_H, thresh_inact >> 8);
+    retval |= accelerometer_reg_write(ADXL362_REG_TIME_INACT_L, time_inact & 0xFF);
+    retval |= accelerometer_reg_write(ADXL362_REG_TIME_INACT_H, time_inact >> 8);
+    retval |= accelerometer_reg_write(ADXL362_REG_ACT_INACT_CTL, ADXL362_ACT_INACT_CTL_LINKED |
+        ADXL362_ACT_INACT_CTL_ACT_EN | ADXL362_ACT_INACT_CTL_ACT_REF |
+        ADXL362_ACT_INACT_CTL_INACT_EN | ADXL362_ACT_INACT_CTL_INACT_REF);
+    if (0 != retval) {
+        return retval;
+    }
+
+    if (IS_ENABLED(CONFIG_ACCELEROMETER_AUTOSLEEP)) {
+        retval = accelerometer_reg_read(ADXL362_REG_POWER_CTL, &power_ctl, sizeof(power_ctl));
+        if (0 != retval) {
+            return retval;
+        }
+
+        retval = accelerometer_reg_write(ADXL362_REG_POWER_CTL, power_ctl | ADXL362_POWER_CTL_AUTOSLEEP);
+    }
+
+    return retval;
+} /* accelerometer_act_inact_setup */
+
+
+/* The Zephyr driver acknowledges the interrupt by reading the status, which clears the activity and inactivity bits,
+ *   the awake bit is the state after the transition.
+ */
+static void accelerometer_act_inact_handler(const struct device *dev, const struct sensor_trigger *trig)
+{
+    uint8_t status = 0;
+    struct accelerometer_sensor_event evt = { 0 };
+
+    INSTR_BEGIN(INSTR_ACCEL_TRIGGER);
+
+    if (0 != accelerometer_reg_read(ADXL362_REG_STATUS, &status, sizeof(status))) {
+        LOG_ERR("Status read error");
+    } else if (!initial_trigger) {
+        /* Ignore the initial trigger after initialization of the accelerometer */
+        initial_trigger = true;
+    } else {
+        evt.type = (status & ADXL362_STATUS_AWAKE) ? ACCELEROMETER_EVENT_ACTIVITY : ACCELEROMETER_EVENT_INACTIVITY;
+        evt_handler(&evt);
+    }
+
+    INSTR_END(INSTR_ACCEL_TRIGGER);
+}
+
+
+#endif /* if defined(CONFIG_ACCELEROMETER_ACT_INACT) */
+
+/**
+ * @brief Set up the ADXL362 features the Zephyr driver does not know of. Called after sensor_trigger_set(), which
+ *   rewrites the interrupt map.
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int accelerometer_mode_setup(void)
+{
+#if defined(CONFIG_ACCELEROMETER_FIFO)
+    return accelerometer_fifo_setup();
+#elif defined(CONFIG_ACCELEROMETER_ACT_INACT)
+    return accelerometer_act_inact_setup();
+#else
+    return 0;
+#endif
+}
+
+
+#if defined(CONFIG_ACCELEROMETER_FIFO)
+# define ACCELEROMETER_TRIGGER_TYPE     SENSOR_TRIG_DATA_READY
+# define ACCELEROMETER_TRIGGER_HANDLER  accelerometer_fifo_handler
+#elif defined(CONFIG_ACCELEROMETER_ACT_INACT)
+# define ACCELEROMETER_TRIGGER_TYPE     SENSOR_TRIG_THRESHOLD
+# define ACCELEROMETER_TRIGGER_HANDLER  accelerometer_act_inact_handler
+#else
+# define ACCELEROMETER_TRIGGER_TYPE     SENSOR_TRIG_THRESHOLD
+# define ACCELEROMETER_TRIGGER_HANDLER  accelerometer_trigger_handler
+#endif
+
+
 int accelerometer_init(accelerometer_handler_t handler)
 {
     struct accelerometer_sensor_event evt = { 0 };
@@ -109,49 +537,44 @@ int accelerometer_init(accelerometer_handler_t handler)
 
     struct sensor_trigger trig = {
         .chan = SENSOR_CHAN_ACCEL_XYZ,
-        .type = SENSOR_TRIG_THRESHOLD
+        .type = ACCELEROMETER_TRIGGER_TYPE
     };
 
     int err = sensor_trigger_set(accel_sensor.dev,
-        &trig, accelerometer_trigger_handler);
+        &trig, ACCELEROMETER_TRIGGER_HANDLER);
 
     if (err) {
         LOG_ERR("Could not set trigger for device %s, error: %d", accel_sensor.dev->name, err);
         return err;
     }
 
+    err = accelerometer_mode_setup();
+    if (err) {
+        LOG_ERR("Could not set up device %s, error: %d", accel_sensor.dev->name, err);
+        return err;
+    }
+
     return 0;
 }
 
 
-int accelerometer_movement_thres_set(double threshold_new)
+int accelerometer_movement_thres_set(uint16_t threshold_new)
 {
     int err, input_value;
-    double range_max_m_s2 = ADXL362_RANGE_MAX_M_S2;
-    double threshold_new_copy;
     struct accelerometer_sensor_event evt = { 0 };
 
-    if (threshold_new > range_max_m_s2) {
+    if (threshold_new > ADXL362_RANGE_MAX_MG(range_shift)) {
         LOG_ERR("Invalid threshold value");
         return -ENOTSUP;
     }
 
-    threshold_new_copy = threshold_new;
-
-    /* Convert threshold value into 11-bit decimal value relative to the configured measuring range of the
-     *   accelerometer.
+    /* Convert threshold value into 11-bit decimal value in LSB of the configured measuring range of the
+     *   accelerometer, rounded to nearest.
      */
-    threshold_new = (threshold_new
-      * (ADXL362_THRESHOLD_RESOLUTION_DECIMAL_MAX / range_max_m_s2));
-
-    /* Add 0.5 to ensure proper conversion from double to int. */
-    threshold_new = threshold_new + 0.5;
-    input_value = (int) threshold_new;
+    input_value = (threshold_new + ((1 << range_shift) >> 1)) >> range_shift;
 
     if (input_value >= ADXL362_THRESHOLD_RESOLUTION_DECIMAL_MAX) {
         input_value = ADXL362_THRESHOLD_RESOLUTION_DECIMAL_MAX - 1;
-    } else if (input_value < 0) {
-        input_value = 0;
     }
 
     const struct sensor_value data = {
@@ -191,22 +614,134 @@ int accelerometer_movement_thres_set(double threshold_new)
         return err;
     }
 
-    threshold = threshold_new_copy;
+    threshold_mg = threshold_new;
 
     return 0;
 } /* accelerometer_movement_thres_set */
 
 
+/**
+ * @brief Get the register codes of a configuration
+ *
+ * @param config the configuration
+ * @param odr_code where the ODR code of FILTER_CTL is stored
+ * @param shift where the range shift is stored
+ * @return int 0 on success, -EINVAL if the configuration is invalid
+ */
+static int accelerometer_config_codes_get(const struct accelerometer_config *config, int *odr_code, uint8_t *shift)
+{
+    *odr_code = -1;
+    for (int i = 0; i < ARRAY_SIZE(odr_codes); i++) {
+        if (odr_codes[i] == config->odr) {
+            *odr_code = i;
+        }
+    }
+
+    switch (config->range) {
+        case 2:
+            *shift = 0;
+            break;
+        case 4:
+            *shift = 1;
+            break;
+        case 8:
+            *shift = 2;
+            break;
+        default:
+            *shift = UINT8_MAX;
+            break;
+    }
+
+    if ((*odr_code < 0) || (UINT8_MAX == *shift) || (0 == config->threshold) ||
+      (config->threshold > ADXL362_RANGE_MAX_MG(*shift)))
+    {
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+
+int accelerometer_config_check(const struct accelerometer_config *config)
+{
+    int odr_code;
+    uint8_t shift;
+
+    return accelerometer_config_codes_get(config, &odr_code, &shift);
+}
+
+
+int accelerometer_config_set(const struct accelerometer_config *config)
+{
+    int err = 0;
+    int odr_code;
+    uint8_t shift;
+    uint8_t filter_ctl = 0;
+    uint8_t power_ctl = 0;
+
+    if (0 != accelerometer_config_codes_get(config, &odr_code, &shift)) {
+        LOG_ERR("Invalid configuration");
+        return -EINVAL;
+    }
+
+    /* The range and the ODR are changed in standby, the measurement mode and the interrupt setup are kept. The Zephyr
+     *   ADXL362 driver is bypassed, its cached range stays at the build time CONFIG_ADXL362_ACCEL_RANGE_* and is
+     *   only used by sensor_channel_get(), which this driver never calls, the samples are scaled with range_shift.
+     *   Its runtime range and ODR attributes are not used as they need CONFIG_ADXL362_ACCEL_*_RUNTIME.
+     */
+    err = accelerometer_reg_read(ADXL362_REG_POWER_CTL, &power_ctl, sizeof(power_ctl));
+    err |= accelerometer_reg_read(ADXL362_REG_FILTER_CTL, &filter_ctl, sizeof(filter_ctl));
+    err |= accelerometer_reg_write(ADXL362_REG_POWER_CTL, power_ctl & ~ADXL362_POWER_CTL_MEASURE_MASK);
+    err |= accelerometer_reg_write(ADXL362_REG_FILTER_CTL, (filter_ctl & ~ADXL362_FILTER_CTL_MASK) |
+        (shift << ADXL362_FILTER_CTL_RANGE_POS) | odr_code);
+    err |= accelerometer_reg_write(ADXL362_REG_POWER_CTL, power_ctl);
+    if (err) {
+        LOG_ERR("Failed to set the range and ODR of device %s", accel_sensor.dev->name);
+        return -EIO;
+    }
+
+    range_shift = shift;
+    odr_mhz = config->odr;
+    debounce_ms = config->debounce;
+
+    err = accelerometer_movement_thres_set(config->threshold);
+    if (err) {
+        return err;
+    }
+
+#if defined(CONFIG_ACCELEROMETER_ACT_INACT)
+    /* The inactivity threshold and timers depend on the range and the ODR */
+    err = accelerometer_act_inact_setup();
+#else
+    err = accelerometer_reg_write(ADXL362_REG_TIME_ACT, MIN(ADXL362_TIME_SAMPLES(debounce_ms), UINT8_MAX));
+#endif
+    if (err) {
+        LOG_ERR("Failed to set the debounce time of device %s", accel_sensor.dev->name);
+    }
+
+    return err;
+} /* accelerometer_config_set */
+
+
+void accelerometer_config_get(struct accelerometer_config *config)
+{
+    config->threshold = threshold_mg;
+    config->debounce = debounce_ms;
+    config->odr = odr_mhz;
+    config->range = 2 << range_shift;
+}
+
+
 int accelerometer_trigger_callback_set(bool enable)
 {
     int err;
     struct sensor_trigger trig = {
         .chan = SENSOR_CHAN_ACCEL_XYZ,
-        .type = SENSOR_TRIG_THRESHOLD
+        .type = ACCELEROMETER_TRIGGER_TYPE
     };
     struct accelerometer_sensor_event evt = { 0 };
 
-    sensor_trigger_handler_t handler = enable ? accelerometer_trigger_handler : NULL;
+    sensor_trigger_handler_t handler = enable ? ACCELEROMETER_TRIGGER_HANDLER : NULL;
 
     err = sensor_trigger_set(accel_sensor.dev, &trig, handler);
     if (err) {
@@ -217,6 +752,16 @@ int accelerometer_trigger_callback_set(bool enable)
         return err;
     }
 
+    if (enable) {
+        err = accelerometer_mode_setup();
+        if (err) {
+            LOG_ERR("Could not set up device %s, error: %d", accel_sensor.dev->name, err);
+            evt.type = ACCELEROMETER_EVENT_ERROR;
+            evt_handler(&evt);
+            return err;
+        }
+    }
+
     initial_trigger = false;
 
     return 0;
@@ -1,12 +1,37 @@
 #ifndef ACCELEROMETER_H
 #define ACCELEROMETER_H
 
+#include <zephyr/types.h>
+
 /** Number of accelerometer channels. */
 #define ACCELEROMETER_CHANNELS 3
 
+/** Output data rate used for adxl362 at build [mHz], the initial output data rate. */
+#if defined(CONFIG_ADXL362_ACCEL_ODR_12_5)
+# define ACCELEROMETER_ODR_MHZ  12500
+#elif defined(CONFIG_ADXL362_ACCEL_ODR_25)
+# define ACCELEROMETER_ODR_MHZ  25000
+#elif defined(CONFIG_ADXL362_ACCEL_ODR_50)
+# define ACCELEROMETER_ODR_MHZ  50000
+#elif defined(CONFIG_ADXL362_ACCEL_ODR_100)
+# define ACCELEROMETER_ODR_MHZ  100000
+#elif defined(CONFIG_ADXL362_ACCEL_ODR_200)
+# define ACCELEROMETER_ODR_MHZ  200000
+#elif defined(CONFIG_ADXL362_ACCEL_ODR_400)
+# define ACCELEROMETER_ODR_MHZ  400000
+#endif
+
 /** @brief Enum containing callback events from library. */
 enum accelerometer_event_type {
     ACCELEROMETER_EVENT_TRIGGER,
+    /** A batch of samples read from the FIFO, only with CONFIG_ACCELEROMETER_FIFO. */
+    ACCELEROMETER_EVENT_FIFO,
+    /** Movement above the threshold after inactivity, only with CONFIG_ACCELEROMETER_ACT_INACT. */
+    ACCELEROMETER_EVENT_ACTIVITY,
+    /** No movement above the inactivity threshold for the inactivity time, only with
+     *   CONFIG_ACCELEROMETER_ACT_INACT.
+     */
+    ACCELEROMETER_EVENT_INACTIVITY,
     /** Events propagated when an error associated with a sensor device occurs. */
     ACCELEROMETER_EVENT_ERROR,
 };
@@ -17,13 +42,32 @@ struct accelerometer_sensor_event {
     enum accelerometer_event_type type;
     /** Event data. */
     union {
-        /** Array of external sensor values. */
-        double value_array[ACCELEROMETER_CHANNELS];
+        /** Array of external sensor values [mg]. */
+        int16_t value_array[ACCELEROMETER_CHANNELS];
         /** Single external sensor value. */
-        double value;
+        int16_t value;
+        /** Samples of an ACCELEROMETER_EVENT_FIFO, only valid during the callback. */
+        struct {
+            /** xyz samples [mg], oldest first. */
+            const int16_t (*xyz)[ACCELEROMETER_CHANNELS];
+            /** Number of xyz samples. */
+            uint16_t cnt;
+        } fifo;
     };
 };
 
+/** @brief Sensitivity configuration. */
+struct accelerometer_config {
+    /** Movement threshold [mg]. */
+    uint16_t threshold;
+    /** Time above the threshold before movement is reported [ms]. */
+    uint16_t debounce;
+    /** Output data rate [mHz], 12500, 25000, 50000, 100000, 200000 or 400000. */
+    uint32_t odr;
+    /** Measuring range [g], 2, 4 or 8. */
+    uint8_t range;
+};
+
 /** @brief External sensors library asynchronous event handler.
  *
  *  @param[in] evt The event and any associated parameters.
@@ -42,11 +86,37 @@ int accelerometer_init(accelerometer_handler_t handler);
 /**
  * @brief Set the threshold that triggeres callback on accelerometer data.
  *
- * @param[in] threshold_new Variable that sets the accelerometer threshold value in m/s2.
+ * @param[in] threshold_new Variable that sets the accelerometer threshold value in mg.
  *
  * @return 0 on success or negative error value on failure.
  */
-int accelerometer_movement_thres_set(double threshold_new);
+int accelerometer_movement_thres_set(uint16_t threshold_new);
+
+/**
+ * @brief Check a configuration without applying it.
+ *
+ * @param[in] config The configuration.
+ *
+ * @return 0 if accelerometer_config_set() accepts it, -EINVAL otherwise.
+ */
+int accelerometer_config_check(const struct accelerometer_config *config);
+
+/**
+ * @brief Change the sensitivity at runtime. The sensor keeps running, the trigger handler and the suppression of the
+ *   initial trigger are not touched.
+ *
+ * @param[in] config The new configuration.
+ *
+ * @return 0 on success or negative error value on failure.
+ */
+int accelerometer_config_set(const struct accelerometer_config *config);
+
+/**
+ * @brief Get the current sensitivity.
+ *
+ * @param[out] config Where the configuration is stored.
+ */
+void accelerometer_config_get(struct accelerometer_config *config);
 
 /**
  * @brief Enable or disable accelerometer trigger handler.
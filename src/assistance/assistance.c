@@ -0,0 +1,297 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <date_time.h>
+#include <nrf_modem_gnss.h>
+#if defined(CONFIG_SETTINGS)
+#include <zephyr/settings/settings.h>
+#endif
+
+#include "src/assistance/assistance.h"
+
+#define MODULE  assistance
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_ASSISTANCE_LOG_LEVEL);
+
+#define ASSISTANCE_SV_CNT   32
+
+union assistance_data {
+    struct nrf_modem_gnss_agps_data_ephemeris ephemeris;
+    struct nrf_modem_gnss_agps_data_almanac almanac;
+    struct nrf_modem_gnss_agps_data_utc utc;
+    struct nrf_modem_gnss_agps_data_klobuchar klobuchar;
+    struct nrf_modem_gnss_agps_data_location location;
+};
+
+struct assistance_entry {
+    /* UTC time when the data expires [ms], 0 if the slot is empty */
+    int64_t expires;
+    union assistance_data data;
+};
+
+/* Store slots, ephemerides and almanacs are stored per satellite. Everything from the almanacs on is valid for days
+ *   or weeks and is kept in settings over a reset, ephemerides are only valid for hours and are kept in RAM.
+ */
+enum {
+    ASSISTANCE_SLOT_EPHEMERIS = 0,
+    ASSISTANCE_SLOT_ALMANAC   = ASSISTANCE_SLOT_EPHEMERIS + ASSISTANCE_SV_CNT,
+    ASSISTANCE_SLOT_UTC       = ASSISTANCE_SLOT_ALMANAC + ASSISTANCE_SV_CNT,
+    ASSISTANCE_SLOT_KLOBUCHAR,
+    ASSISTANCE_SLOT_LOCATION,
+    ASSISTANCE_SLOT_CNT,
+};
+
+#define ASSISTANCE_SLOT_PERSISTENT  ASSISTANCE_SLOT_ALMANAC
+
+static const struct {
+    uint16_t type;
+    uint8_t first;
+    uint8_t cnt;
+    size_t size;
+    /* NRF_MODEM_GNSS_AGPS_*_REQUEST flag, 0 for the types requested per satellite */
+    uint32_t flag;
+} store_types[] = {
+    { NRF_MODEM_GNSS_AGPS_EPHEMERIDES, ASSISTANCE_SLOT_EPHEMERIS, ASSISTANCE_SV_CNT,
+      sizeof(struct nrf_modem_gnss_agps_data_ephemeris), 0 },
+    { NRF_MODEM_GNSS_AGPS_ALMANAC, ASSISTANCE_SLOT_ALMANAC, ASSISTANCE_SV_CNT,
+      sizeof(struct nrf_modem_gnss_agps_data_almanac), 0 },
+    { NRF_MODEM_GNSS_AGPS_UTC_PARAMETERS, ASSISTANCE_SLOT_UTC, 1,
+      sizeof(struct nrf_modem_gnss_agps_data_utc), NRF_MODEM_GNSS_AGPS_GPS_UTC_REQUEST },
+    { NRF_MODEM_GNSS_AGPS_KLOBUCHAR_IONOSPHERIC_CORRECTION, ASSISTANCE_SLOT_KLOBUCHAR, 1,
+      sizeof(struct nrf_modem_gnss_agps_data_klobuchar), NRF_MODEM_GNSS_AGPS_KLOBUCHAR_REQUEST },
+    { NRF_MODEM_GNSS_AGPS_LOCATION, ASSISTANCE_SLOT_LOCATION, 1,
+      sizeof(struct nrf_modem_gnss_agps_data_location), NRF_MODEM_GNSS_AGPS_POSITION_REQUEST },
+};
+
+K_MSGQ_DEFINE(assistance_msgq, sizeof(struct nrf_modem_gnss_agps_data_frame), 1, 4);
+static K_MUTEX_DEFINE(store_mutex);
+
+static struct assistance_entry store[ASSISTANCE_SLOT_CNT];
+static atomic_ptr_t backend = ATOMIC_PTR_INIT((void *)&assistance_minimal_backend);
+
+static atomic_t requests;
+static atomic_t store_hits;
+static atomic_t fetches;
+static atomic_t fetch_errors;
+
+#if defined(CONFIG_SETTINGS)
+
+static int assistance_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    unsigned long slot = strtoul(name, NULL, 10);
+
+    if ((slot < ASSISTANCE_SLOT_PERSISTENT) || (slot >= ASSISTANCE_SLOT_CNT) || (len != sizeof(store[0]))) {
+        return -EINVAL;
+    }
+
+    return (read_cb(cb_arg, &store[slot], len) == len) ? 0 : -EIO;
+}
+
+
+SETTINGS_STATIC_HANDLER_DEFINE(assistance, "assist", NULL, assistance_settings_set, NULL, NULL);
+
+#endif /* if defined(CONFIG_SETTINGS) */
+
+/**
+ * @brief Find the store slot of assistance data
+ *
+ * @param type NRF_MODEM_GNSS_AGPS_* data type
+ * @param data the data, ephemerides and almanacs start with the satellite ID
+ * @param len length of the data
+ * @return int the slot, -EINVAL if the data cannot be stored
+ */
+static int assistance_store_slot_get(uint16_t type, const void *data, size_t len)
+{
+    uint8_t sv_id = *(const uint8_t *)data;
+
+    for (int i = 0; i < ARRAY_SIZE(store_types); i++) {
+        if ((store_types[i].type != type) || (store_types[i].size != len)) {
+            continue;
+        }
+
+        if (1 == store_types[i].cnt) {
+            return store_types[i].first;
+        }
+
+        if ((sv_id >= 1) && (sv_id <= store_types[i].cnt)) {
+            return store_types[i].first + sv_id - 1;
+        }
+    }
+
+    return -EINVAL;
+}
+
+
+/**
+ * @brief Inject the valid data in the store that the GNSS requested, and remove it from the request
+ *
+ * @param req the request, updated to what is still missing
+ */
+static void assistance_store_inject(struct nrf_modem_gnss_agps_data_frame *req)
+{
+    int64_t now;
+    uint32_t *sv_mask;
+    const struct assistance_entry *entry;
+
+    /* The age of the data cannot be checked without the time */
+    if (0 != date_time_now(&now)) {
+        return;
+    }
+
+    k_mutex_lock(&store_mutex, K_FOREVER);
+
+    for (int i = 0; i < ARRAY_SIZE(store_types); i++) {
+        sv_mask = NULL;
+        if (NRF_MODEM_GNSS_AGPS_EPHEMERIDES == store_types[i].type) {
+            sv_mask = &req->sv_mask_ephe;
+        } else if (NRF_MODEM_GNSS_AGPS_ALMANAC == store_types[i].type) {
+            sv_mask = &req->sv_mask_alm;
+        } else if (0 == (req->data_flags & store_types[i].flag)) {
+            continue;
+        }
+
+        for (int j = 0; j < store_types[i].cnt; j++) {
+            if ((NULL != sv_mask) && (0 == (*sv_mask & BIT(j)))) {
+                continue;
+            }
+
+            entry = &store[store_types[i].first + j];
+            if ((entry->expires <= now) ||
+              (0 != assistance_data_write(store_types[i].type, &entry->data, store_types[i].size)))
+            {
+                continue;
+            }
+
+            if (NULL != sv_mask) {
+                *sv_mask &= ~BIT(j);
+            } else {
+                req->data_flags &= ~store_types[i].flag;
+            }
+            atomic_inc(&store_hits);
+        }
+    }
+
+    k_mutex_unlock(&store_mutex);
+} /* assistance_store_inject */
+
+
+int assistance_request(const struct nrf_modem_gnss_agps_data_frame *req)
+{
+    return (0 == k_msgq_put(&assistance_msgq, req, K_NO_WAIT)) ? 0 : -ENOMEM;
+}
+
+
+void assistance_backend_set(const struct assistance_backend *new_backend)
+{
+    atomic_ptr_set(&backend, (void *)new_backend);
+}
+
+
+int assistance_store_put(uint16_t type, const void *data, size_t len, int64_t expires)
+{
+    int slot = assistance_store_slot_get(type, data, len);
+
+    if (slot < 0) {
+        return slot;
+    }
+
+    k_mutex_lock(&store_mutex, K_FOREVER);
+
+    memcpy(&store[slot].data, data, len);
+    store[slot].expires = expires;
+
+#if defined(CONFIG_SETTINGS)
+    if (slot >= ASSISTANCE_SLOT_PERSISTENT) {
+        char name[sizeof("assist/") + 3];
+
+        snprintf(name, sizeof(name), "assist/%d", slot);
+        if (0 != settings_save_one(name, &store[slot], sizeof(store[slot]))) {
+            LOG_WRN("%s: Failed to save %s", __func__, name);
+        }
+    }
+#endif
+
+    k_mutex_unlock(&store_mutex);
+
+    return 0;
+} /* assistance_store_put */
+
+
+int assistance_data_write(uint16_t type, const void *data, size_t len)
+{
+    int retval = nrf_modem_gnss_agps_write((void *)data, len, type);
+
+    if (0 != retval) {
+        LOG_WRN("%s: Failed to inject data type %u, retval: %d", __func__, type, retval);
+    }
+
+    return retval;
+}
+
+
+void assistance_stats_get(struct assistance_stats *stats)
+{
+    stats->requests = atomic_get(&requests);
+    stats->store_hits = atomic_get(&store_hits);
+    stats->fetches = atomic_get(&fetches);
+    stats->fetch_errors = atomic_get(&fetch_errors);
+}
+
+
+/*************************************************************/
+/* Threads */
+/*************************************************************/
+
+/* Inject assistance data, keeps the store and the backend out of the GNSS event thread */
+static void assistance_thread(void)
+{
+    int retval = 0;
+    struct nrf_modem_gnss_agps_data_frame req;
+    const struct assistance_backend *fetch_backend;
+
+#if defined(CONFIG_SETTINGS)
+    retval = settings_subsys_init();
+    retval |= settings_load_subtree("assist");
+    if (0 != retval) {
+        LOG_WRN("%s: Failed to load the store, retval: %d", __func__, retval);
+    }
+#endif
+
+    while (1) {
+        k_msgq_get(&assistance_msgq, &req, K_FOREVER);
+        atomic_inc(&requests);
+
+        LOG_INF("Assistance request, ephe: 0x%08x, alm: 0x%08x, flags: 0x%08x", req.sv_mask_ephe, req.sv_mask_alm,
+          req.data_flags);
+
+        assistance_store_inject(&req);
+        if ((0 == req.sv_mask_ephe) && (0 == req.sv_mask_alm) && (0 == req.data_flags)) {
+            continue;
+        }
+
+        fetch_backend = atomic_ptr_get(&backend);
+        if (NULL == fetch_backend) {
+            continue;
+        }
+
+        atomic_inc(&fetches);
+        retval = fetch_backend->fetch(&req);
+        if (0 != retval) {
+            atomic_inc(&fetch_errors);
+            LOG_WRN("%s: Backend %s failed to fetch, retval: %d", __func__, fetch_backend->name, retval);
+        }
+
+        assistance_store_inject(&req);
+    }
+} /* assistance_thread */
+
+
+#define ASSISTANCE_THREAD_STACK_SIZE    2048
+#define ASSISTANCE_THREAD_PRIORITY      8
+
+K_THREAD_DEFINE(assistance_thread_id, ASSISTANCE_THREAD_STACK_SIZE,
+  assistance_thread, NULL, NULL, NULL,
+  K_PRIO_PREEMPT(ASSISTANCE_THREAD_PRIORITY), 0, 0);
@@ -0,0 +1,79 @@
+#ifndef ASSISTANCE_H
+#define ASSISTANCE_H
+
+#include <zephyr.h>
+#include <nrf_modem_gnss.h>
+
+/** @brief Source of assistance data that is not in the local store. */
+struct assistance_backend {
+    /** Name used in logs. */
+    const char *name;
+    /**
+     * @brief Fetch the requested data. Data that stays valid is put in the store with assistance_store_put() and
+     *   injected from there, data that is only valid now, like the time, is injected with assistance_data_write().
+     *
+     * @param req the data the GNSS still needs
+     * @return int 0 on success, negative on fail
+     */
+    int (*fetch)(const struct nrf_modem_gnss_agps_data_frame *req);
+};
+
+/* Injects the time from date_time and a coarse location from the last fix or the reference position */
+extern const struct assistance_backend assistance_minimal_backend;
+
+/** @brief Assistance statistics. */
+struct assistance_stats {
+    /** Number of assistance requests from the GNSS. */
+    uint32_t requests;
+    /** Number of data items injected from the local store. */
+    uint32_t store_hits;
+    /** Number of backend fetches. */
+    uint32_t fetches;
+    /** Number of failed backend fetches. */
+    uint32_t fetch_errors;
+};
+
+/**
+ * @brief Queue an assistance request from the GNSS. Never blocks, the data is injected from the assistance thread.
+ *
+ * @param req the request read from the GNSS
+ * @return int 0 on success, -ENOMEM if a request is already waiting
+ */
+int assistance_request(const struct nrf_modem_gnss_agps_data_frame *req);
+
+/**
+ * @brief Replace the fetch backend, e.g. with a stub. The backend selected by Kconfig is used by default.
+ *
+ * @param backend the new backend, NULL to only inject from the local store
+ */
+void assistance_backend_set(const struct assistance_backend *backend);
+
+/**
+ * @brief Put assistance data in the local store. Ephemerides and almanacs are stored per satellite.
+ *
+ * @param type NRF_MODEM_GNSS_AGPS_* data type
+ * @param data the data, in the layout nrf_modem_gnss_agps_write() takes for the type
+ * @param len length of the data
+ * @param expires UTC time when the data is no longer valid [ms since 1970-01-01]
+ * @return int 0 on success, -EINVAL if the type cannot be stored
+ */
+int assistance_store_put(uint16_t type, const void *data, size_t len, int64_t expires);
+
+/**
+ * @brief Inject assistance data to the GNSS
+ *
+ * @param type NRF_MODEM_GNSS_AGPS_* data type
+ * @param data the data
+ * @param len length of the data
+ * @return int 0 on success, negative on fail
+ */
+int assistance_data_write(uint16_t type, const void *data, size_t len);
+
+/**
+ * @brief Get the assistance statistics
+ *
+ * @param stats where the statistics are stored
+ */
+void assistance_stats_get(struct assistance_stats *stats);
+
+#endif /* ASSISTANCE_H */
@@ -0,0 +1,136 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <date_time.h>
+#include <nrf_modem_gnss.h>
+
+#include "src/assistance/assistance.h"
+#include "src/positioning/positioning.h"
+
+#define MODULE  assistance_minimal
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_ASSISTANCE_LOG_LEVEL);
+
+#define GPS_TO_UNIX_UTC_OFFSET_SECONDS  315964800
+#define GPS_TO_UTC_LEAP_SECONDS         18
+#define GPS_SEC_PER_DAY                 86400
+
+/* Location uncertainty code for an unknown altitude */
+#define LOCATION_UNC_ALTITUDE_UNKNOWN   255
+
+/**
+ * @brief Inject the GPS system time from date_time
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int assistance_minimal_time_write(void)
+{
+    int64_t utc_ms;
+    int64_t gps_sec;
+    struct nrf_modem_gnss_agps_data_system_time_and_sv_tow gps_time = { 0 };
+
+    if (0 != date_time_now(&utc_ms)) {
+        return -ENODATA;
+    }
+
+    gps_sec = utc_ms / MSEC_PER_SEC - GPS_TO_UNIX_UTC_OFFSET_SECONDS + GPS_TO_UTC_LEAP_SECONDS;
+    gps_time.date_day = (uint16_t)(gps_sec / GPS_SEC_PER_DAY);
+    gps_time.time_full_s = (uint32_t)(gps_sec % GPS_SEC_PER_DAY);
+    gps_time.time_frac_ms = (uint16_t)(utc_ms % MSEC_PER_SEC);
+
+    return assistance_data_write(NRF_MODEM_GNSS_AGPS_GPS_SYSTEM_CLOCK_AND_TOWS, &gps_time, sizeof(gps_time));
+}
+
+
+/**
+ * @brief Get the coarse location, the last fix if there is one, else the reference position
+ *
+ * @param latitude where the latitude [deg] is stored
+ * @param longitude where the longitude [deg] is stored
+ * @return int 0 on success, -ENODATA if there is no location
+ */
+static int assistance_minimal_location_get(double *latitude, double *longitude)
+{
+    struct pos_snapshot snapshot;
+
+    if (0 == positioning_snapshot_get(&snapshot)) {
+        *latitude = snapshot.latitude;
+        *longitude = snapshot.longitude;
+        return 0;
+    }
+
+    if ((0 == strlen(CONFIG_GNSS_SAMPLE_REFERENCE_LATITUDE)) || (0 == strlen(CONFIG_GNSS_SAMPLE_REFERENCE_LONGITUDE))) {
+        return -ENODATA;
+    }
+
+    *latitude = strtod(CONFIG_GNSS_SAMPLE_REFERENCE_LATITUDE, NULL);
+    *longitude = strtod(CONFIG_GNSS_SAMPLE_REFERENCE_LONGITUDE, NULL);
+
+    return 0;
+}
+
+
+/**
+ * @brief Put the coarse location in the store, or inject it right away if the time is not known
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int assistance_minimal_location_write(void)
+{
+    int64_t now;
+    double latitude;
+    double longitude;
+    /* Uncertainty r [m] is coded as K, r = 10 * (1.1^K - 1) */
+    uint8_t unc = (uint8_t)MIN(ceil(log(CONFIG_ASSISTANCE_LOCATION_UNCERTAINTY / 10.0 + 1.0) / log(1.1)), 127);
+    struct nrf_modem_gnss_agps_data_location location = {
+        .unc_semimajor = unc,
+        .unc_semiminor = unc,
+        .unc_altitude = LOCATION_UNC_ALTITUDE_UNKNOWN,
+        .confidence = 68,
+    };
+
+    if (0 != assistance_minimal_location_get(&latitude, &longitude)) {
+        return -ENODATA;
+    }
+
+    location.latitude = (int32_t)floor(latitude / 90.0 * (1 << 23));
+    location.longitude = (int32_t)floor(longitude / 360.0 * (1 << 24));
+
+    if (0 != date_time_now(&now)) {
+        return assistance_data_write(NRF_MODEM_GNSS_AGPS_LOCATION, &location, sizeof(location));
+    }
+
+    return assistance_store_put(NRF_MODEM_GNSS_AGPS_LOCATION, &location, sizeof(location),
+             now + (int64_t)CONFIG_ASSISTANCE_LOCATION_VALIDITY * MSEC_PER_SEC);
+}
+
+
+/**
+ * @brief Fetch the time and location, the factory almanac in the modem covers the satellites
+ *
+ * @param req the data the GNSS still needs
+ * @return int 0 on success, negative on fail
+ */
+static int assistance_minimal_fetch(const struct nrf_modem_gnss_agps_data_frame *req)
+{
+    int retval = 0;
+
+    if (req->data_flags & NRF_MODEM_GNSS_AGPS_SYS_TIME_AND_SV_TOW_REQUEST) {
+        retval |= assistance_minimal_time_write();
+    }
+
+    if (req->data_flags & NRF_MODEM_GNSS_AGPS_POSITION_REQUEST) {
+        retval |= assistance_minimal_location_write();
+    }
+
+    return retval;
+}
+
+
+const struct assistance_backend assistance_minimal_backend = {
+    .name = "minimal",
+    .fetch = assistance_minimal_fetch,
+};
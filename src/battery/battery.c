@@ -0,0 +1,170 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#if defined(CONFIG_ADP536X)
+#include <adp536x.h>
+#else
+#include <modem/modem_info.h>
+#endif
+
+#include "src/battery/battery.h"
+
+#define MODULE  battery
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_BATTERY_LOG_LEVEL);
+
+struct battery_sample {
+    uint32_t time;
+    uint16_t voltage;
+};
+
+static atomic_t voltage;
+static atomic_t soc = ATOMIC_INIT(0xFF);
+
+static struct k_spinlock window_lock;
+static struct battery_sample window[CONFIG_BATTERY_WINDOW];
+static uint32_t window_cnt;
+static uint32_t window_head;
+
+#if defined(CONFIG_ADP536X)
+static bool fuel_gauge_ready = false;
+#endif
+
+/**
+ * @brief Read the battery voltage, from the ADP5360 fuel gauge if it is enabled, else from the modem
+ *
+ * @param sample_voltage where the voltage [mV] is stored
+ * @param sample_soc where the state of charge [%] is stored, 0xFF if it is not known
+ * @return int 0 on success, negative on fail
+ */
+static int battery_read(uint16_t *sample_voltage, uint8_t *sample_soc)
+{
+    *sample_soc = 0xFF;
+
+#if defined(CONFIG_ADP536X)
+    if (!fuel_gauge_ready) {
+        return -ENODEV;
+    }
+
+    if (0 != adp536x_fg_soc(sample_soc)) {
+        *sample_soc = 0xFF;
+    }
+
+    return adp536x_fg_volts(sample_voltage);
+#else
+    int retval = modem_info_short_get(MODEM_INFO_BATTERY, sample_voltage);
+
+    return (retval < 0) ? retval : 0;
+#endif
+}
+
+
+static void battery_work_fn(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(battery_work, battery_work_fn);
+
+/* Sample the battery and schedule the next sample */
+static void battery_work_fn(struct k_work *work)
+{
+    uint16_t sample_voltage;
+    uint8_t sample_soc;
+    k_spinlock_key_t key;
+
+    k_work_schedule(&battery_work, K_SECONDS(CONFIG_BATTERY_SAMPLE_INTERVAL));
+
+    if (0 != battery_read(&sample_voltage, &sample_soc)) {
+        LOG_WRN("%s: Failed to read the battery", __func__);
+        return;
+    }
+
+    atomic_set(&voltage, sample_voltage);
+    atomic_set(&soc, sample_soc);
+
+    key = k_spin_lock(&window_lock);
+    window[window_head].time = k_uptime_get_32();
+    window[window_head].voltage = sample_voltage;
+    window_head = (window_head + 1) % CONFIG_BATTERY_WINDOW;
+    window_cnt = MIN(window_cnt + 1, CONFIG_BATTERY_WINDOW);
+    k_spin_unlock(&window_lock, key);
+}
+
+
+uint16_t battery_voltage_get(void)
+{
+    return (uint16_t)atomic_get(&voltage);
+}
+
+
+uint8_t battery_soc_get(void)
+{
+    return (uint8_t)atomic_get(&soc);
+}
+
+
+void battery_sample_request(void)
+{
+    k_work_reschedule(&battery_work, K_NO_WAIT);
+}
+
+
+void battery_stats_get(struct battery_stats *stats)
+{
+    k_spinlock_key_t key = k_spin_lock(&window_lock);
+    uint32_t oldest = (window_head + CONFIG_BATTERY_WINDOW - window_cnt) % CONFIG_BATTERY_WINDOW;
+    uint32_t newest = (window_head + CONFIG_BATTERY_WINDOW - 1) % CONFIG_BATTERY_WINDOW;
+    uint32_t sum = 0;
+    uint32_t span;
+
+    stats->cnt = window_cnt;
+    stats->voltage = 0;
+    stats->min = 0;
+    stats->avg = 0;
+    stats->trend = 0;
+
+    if (0 == window_cnt) {
+        k_spin_unlock(&window_lock, key);
+        return;
+    }
+
+    stats->min = UINT16_MAX;
+    for (uint32_t i = 0, idx = oldest; i < window_cnt; i++, idx = (idx + 1) % CONFIG_BATTERY_WINDOW) {
+        stats->min = MIN(stats->min, window[idx].voltage);
+        sum += window[idx].voltage;
+    }
+    stats->voltage = window[newest].voltage;
+    stats->avg = (uint16_t)(sum / window_cnt);
+
+    span = window[newest].time - window[oldest].time;
+    if (span > 0) {
+        stats->trend = (int32_t)(((int64_t)window[newest].voltage - window[oldest].voltage) * 3600000 / span);
+    }
+
+    k_spin_unlock(&window_lock, key);
+} /* battery_stats_get */
+
+
+static int battery_init(const struct device *dev)
+{
+    ARG_UNUSED(dev);
+
+#if defined(CONFIG_ADP536X)
+    int retval = 0;
+
+    /* The ADP5360 is set up by the board, only the fuel gauge has to be enabled */
+    retval = adp536x_init(DT_LABEL(DT_NODELABEL(i2c2)));
+    retval |= adp536x_fg_set_mode(ADP566X_FG_ENABLED, ADP566X_FG_MODE_SLEEP);
+    if (0 != retval) {
+        LOG_WRN("%s: Failed to enable the fuel gauge, retval: %d", __func__, retval);
+    } else {
+        fuel_gauge_ready = true;
+    }
+#endif
+
+    k_work_schedule(&battery_work, K_NO_WAIT);
+
+    return 0;
+}
+
+
+SYS_INIT(battery_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
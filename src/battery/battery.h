@@ -0,0 +1,48 @@
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#include <zephyr.h>
+
+/** @brief Battery voltage over the sample window. */
+struct battery_stats {
+    /** Number of samples in the window. */
+    uint32_t cnt;
+    /** Latest voltage [mV]. */
+    uint16_t voltage;
+    /** Lowest voltage [mV]. */
+    uint16_t min;
+    /** Average voltage [mV]. */
+    uint16_t avg;
+    /** Change of the voltage from the oldest to the latest sample [mV/h]. */
+    int32_t trend;
+};
+
+/**
+ * @brief Get the latest battery voltage. Never blocks, the voltage is sampled every CONFIG_BATTERY_SAMPLE_INTERVAL
+ *   seconds in the background.
+ *
+ * @return uint16_t the voltage [mV], 0 if there has not been any sample yet
+ */
+uint16_t battery_voltage_get(void);
+
+/**
+ * @brief Get the latest battery state of charge from the fuel gauge
+ *
+ * @return uint8_t the state of charge [%], 0xFF without a fuel gauge
+ */
+uint8_t battery_soc_get(void);
+
+/**
+ * @brief Take a sample right away, e.g. to catch the sag under GNSS load
+ *
+ */
+void battery_sample_request(void);
+
+/**
+ * @brief Get the battery voltage over the sample window
+ *
+ * @param stats where the statistics are stored
+ */
+void battery_stats_get(struct battery_stats *stats);
+
+#endif /* BATTERY_H */
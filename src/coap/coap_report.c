@@ -0,0 +1,243 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/random/rand32.h>
+
+#include "src/coap/coap_report.h"
+#include "src/energy/energy.h"
+#include "src/lib/instr.h"
+
+#define MODULE  coap_report
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_COAP_REPORT_LOG_LEVEL);
+
+/* The socket is only used from the thread that sends the reports */
+static int sock = -1;
+static uint8_t msg_buf[COAP_REPORT_MSG_SIZE_MAX];
+static uint8_t rsp_buf[64];
+
+/**
+ * @brief Resolve the server and open a connected UDP socket to it
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int coap_report_connect(void)
+{
+    int retval = 0;
+    struct addrinfo *res;
+    struct addrinfo hints = {
+        .ai_family = AF_INET,
+        .ai_socktype = SOCK_DGRAM,
+    };
+    char port[6];
+
+    snprintf(port, sizeof(port), "%u", CONFIG_COAP_REPORT_SERVER_PORT);
+
+    retval = getaddrinfo(CONFIG_COAP_REPORT_SERVER_HOSTNAME, port, &hints, &res);
+    if (0 != retval) {
+        LOG_ERR("Failed to resolve %s, retval: %d", CONFIG_COAP_REPORT_SERVER_HOSTNAME, retval);
+        return -EHOSTUNREACH;
+    }
+
+    sock = socket(res->ai_family, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        retval = -errno;
+        LOG_ERR("Failed to create socket, errno: %d", errno);
+    } else if (0 != connect(sock, res->ai_addr, res->ai_addrlen)) {
+        retval = -errno;
+        LOG_ERR("Failed to connect socket, errno: %d", errno);
+        close(sock);
+        sock = -1;
+    }
+
+    freeaddrinfo(res);
+
+    return retval;
+} /* coap_report_connect */
+
+
+/**
+ * @brief Acknowledge a confirmable separate response with an empty ACK
+ *
+ * @param rsp the response
+ */
+static void coap_report_empty_ack_send(const struct coap_packet *rsp)
+{
+    struct coap_packet ack;
+    uint8_t ack_buf[4];
+
+    /* An empty message has no token, coap_ack_init() would copy the one of the response */
+    if ((0 != coap_packet_init(&ack, ack_buf, sizeof(ack_buf), COAP_VERSION_1, COAP_TYPE_ACK, 0, NULL,
+      COAP_CODE_EMPTY, coap_header_get_id(rsp))) || (send(sock, ack.data, ack.offset, 0) < 0))
+    {
+        LOG_WRN("%s: Failed to acknowledge message %u", __func__, coap_header_get_id(rsp));
+    }
+}
+
+
+/**
+ * @brief Get the result of a response code
+ *
+ * @param code the response code
+ * @return int 0 on success, -EBADMSG if the server did not accept the report
+ */
+static int coap_report_code_check(uint8_t code)
+{
+    if (2 == (code >> 5)) {
+        return 0;
+    }
+
+    LOG_WRN("Server responded %u.%02u", code >> 5, code & 0x1F);
+
+    return -EBADMSG;
+}
+
+
+/**
+ * @brief Wait for the response to a confirmable request, piggybacked on the ACK or sent separately after an empty
+ *   ACK. Confirmable separate responses are acknowledged, also late ones to earlier requests, so the server does not
+ *   retransmit them.
+ *
+ * @param id message ID of the request
+ * @param token token of the request, COAP_TOKEN_MAX_LEN bytes
+ * @param timeout time to wait for the ACK [ms]
+ * @return int 0 if the server responded 2.xx, or acknowledged the request but its separate response did not come
+ *   within CONFIG_COAP_REPORT_RESPONSE_TIMEOUT, -EAGAIN if the request was not acknowledged, negative on other fails
+ */
+static int coap_report_ack_wait(uint16_t id, const uint8_t *token, int timeout)
+{
+    int len;
+    uint8_t type;
+    uint8_t code;
+    uint8_t rsp_token[COAP_TOKEN_MAX_LEN];
+    bool acked = false;
+    struct coap_packet rsp;
+    struct pollfd fds = {
+        .fd = sock,
+        .events = POLLIN,
+    };
+    int64_t end = k_uptime_get() + timeout;
+
+    while (timeout > 0) {
+        if (poll(&fds, 1, timeout) <= 0) {
+            break;
+        }
+
+        len = recv(sock, rsp_buf, sizeof(rsp_buf), 0);
+        if (len < 0) {
+            return -errno;
+        }
+
+        /* Malformed datagrams are skipped */
+        if (0 != coap_packet_parse(&rsp, rsp_buf, len, NULL, 0)) {
+            timeout = (int)(end - k_uptime_get());
+            continue;
+        }
+
+        type = coap_header_get_type(&rsp);
+        code = coap_header_get_code(&rsp);
+
+        if (((COAP_TYPE_CON == type) || (COAP_TYPE_NON_CON == type)) && (COAP_CODE_EMPTY != code)) {
+            /* A separate response */
+            if (COAP_TYPE_CON == type) {
+                coap_report_empty_ack_send(&rsp);
+            }
+            if ((COAP_TOKEN_MAX_LEN == coap_header_get_token(&rsp, rsp_token)) &&
+              (0 == memcmp(rsp_token, token, COAP_TOKEN_MAX_LEN)))
+            {
+                return coap_report_code_check(code);
+            }
+        } else if (coap_header_get_id(&rsp) == id) {
+            if (COAP_TYPE_RESET == type) {
+                return -ECONNREFUSED;
+            }
+            if ((COAP_TYPE_ACK == type) && (COAP_CODE_EMPTY != code)) {
+                return coap_report_code_check(code);
+            }
+            if ((COAP_TYPE_ACK == type) && !acked) {
+                /* The server has the report, the response follows in a message of its own */
+                acked = true;
+                end = k_uptime_get() + CONFIG_COAP_REPORT_RESPONSE_TIMEOUT;
+            }
+        }
+
+        timeout = (int)(end - k_uptime_get());
+    }
+
+    if (acked) {
+        LOG_WRN("%s: No separate response to message %u", __func__, id);
+        return 0;
+    }
+
+    return -EAGAIN;
+} /* coap_report_ack_wait */
+
+
+int coap_report_send(const uint8_t *data, size_t len)
+{
+    int retval = 0;
+    bool sent = false;
+    int64_t start;
+    struct coap_packet req;
+    uint16_t id = coap_next_id();
+    uint8_t token[COAP_TOKEN_MAX_LEN];
+    int timeout = CONFIG_COAP_REPORT_ACK_TIMEOUT + (sys_rand32_get() % (CONFIG_COAP_REPORT_ACK_TIMEOUT / 2 + 1));
+
+    /* coap_next_token() returns a buffer of its own that the next call overwrites */
+    memcpy(token, coap_next_token(), sizeof(token));
+
+    retval = coap_packet_init(&req, msg_buf, sizeof(msg_buf), COAP_VERSION_1, COAP_TYPE_CON, COAP_TOKEN_MAX_LEN,
+        token, COAP_METHOD_POST, id);
+    retval |= coap_packet_append_option(&req, COAP_OPTION_URI_PATH, CONFIG_COAP_REPORT_RESOURCE,
+        strlen(CONFIG_COAP_REPORT_RESOURCE));
+    retval |= coap_append_option_int(&req, COAP_OPTION_CONTENT_FORMAT, COAP_CONTENT_FORMAT_APP_OCTET_STREAM);
+    retval |= coap_packet_append_payload_marker(&req);
+    retval |= coap_packet_append_payload(&req, data, len);
+    if (0 != retval) {
+        return -ENOMEM;
+    }
+
+    if ((sock < 0) && (0 != coap_report_connect())) {
+        return -ENOTCONN;
+    }
+
+    INSTR_BEGIN(INSTR_COAP_SEND);
+
+    start = k_uptime_get();
+    retval = -ETIMEDOUT;
+    for (int i = 0; i <= CONFIG_COAP_REPORT_MAX_RETRANSMIT; i++, timeout *= 2) {
+        if (send(sock, req.data, req.offset, 0) < 0) {
+            retval = -errno;
+            LOG_ERR("Failed to send, errno: %d", errno);
+            break;
+        }
+        sent = true;
+
+        retval = coap_report_ack_wait(id, token, timeout);
+        if (-EAGAIN != retval) {
+            break;
+        }
+        retval = -ETIMEDOUT;
+        LOG_INF("No ACK for message %u, attempt %d", id, i + 1);
+    }
+
+#if defined(CONFIG_ENERGY)
+    /* The radio is on from the first datagram until the exchange ends, and for the inactivity tail after it */
+    if (sent) {
+        energy_time_add(ENERGY_LTE, (uint32_t)(k_uptime_get() - start) + CONFIG_ENERGY_LTE_COAP_TIME);
+    }
+#endif
+
+    /* A new socket resolves the server again, in case its address has changed */
+    if ((0 != retval) && (-EBADMSG != retval)) {
+        close(sock);
+        sock = -1;
+    }
+
+    INSTR_END(INSTR_COAP_SEND);
+
+    return retval;
+} /* coap_report_send */
@@ -0,0 +1,25 @@
+#ifndef COAP_REPORT_H
+#define COAP_REPORT_H
+
+#include <zephyr.h>
+
+/* Largest CoAP message sent, header, token, options and payload [bytes] */
+#define COAP_REPORT_MSG_SIZE_MAX    320
+
+/* Largest payload that fits in a message with the resource path and options [bytes] */
+#define COAP_REPORT_PAYLOAD_LEN_MAX (COAP_REPORT_MSG_SIZE_MAX - 64)
+
+/**
+ * @brief Send a report to CONFIG_COAP_REPORT_SERVER_HOSTNAME as a confirmable CoAP POST to
+ *   CONFIG_COAP_REPORT_RESOURCE. Blocks until the server responds, piggybacked on the ACK or in a separate response
+ *   after an empty ACK, or until all retransmissions have timed out. The socket is opened on the first send and
+ *   reopened after a fail.
+ *
+ * @param data the payload, sent as application/octet-stream
+ * @param len length of the payload
+ * @return int 0 on success, -ETIMEDOUT if the request was not acknowledged, -EBADMSG if the server responded with
+ *   an error, negative on other fails
+ */
+int coap_report_send(const uint8_t *data, size_t len);
+
+#endif /* COAP_REPORT_H */
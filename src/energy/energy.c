@@ -0,0 +1,157 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <stdio.h>
+#include "src/battery/battery.h"
+#include "src/energy/energy.h"
+
+#define MODULE  energy
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_ENERGY_LOG_LEVEL);
+
+#define ENERGY_MS_PER_HOUR  3600000ULL
+
+/* Output data rates [mHz] the accelerometer currents are given at, the current is flat below the first one */
+#define ENERGY_ACCEL_ODR_LOW    100000
+#define ENERGY_ACCEL_ODR_HIGH   400000
+
+/* Current of each subsystem when it is on [nA], the accelerometer current follows the active ODR */
+static uint32_t currents[ENERGY_SUBSYS_CNT] = {
+    [ENERGY_BASE] = CONFIG_ENERGY_CURRENT_BASE,
+    [ENERGY_GNSS_SEARCH] = CONFIG_ENERGY_CURRENT_GNSS_SEARCH,
+    [ENERGY_GNSS_TRACK] = CONFIG_ENERGY_CURRENT_GNSS_TRACK,
+    [ENERGY_LTE] = CONFIG_ENERGY_CURRENT_LTE,
+    [ENERGY_ACCEL] = CONFIG_ENERGY_CURRENT_ACCEL,
+    [ENERGY_LED] = CONFIG_ENERGY_CURRENT_LED,
+};
+
+static const char *const subsys_names[ENERGY_SUBSYS_CNT] = {
+    [ENERGY_BASE] = "base",
+    [ENERGY_GNSS_SEARCH] = "gnss_s",
+    [ENERGY_GNSS_TRACK] = "gnss_t",
+    [ENERGY_LTE] = "lte",
+    [ENERGY_ACCEL] = "accel",
+    [ENERGY_LED] = "led",
+};
+
+static struct k_spinlock energy_lock;
+/* The board and the accelerometer are on from boot */
+static bool state_on[ENERGY_SUBSYS_CNT] = {
+    [ENERGY_BASE] = true,
+    [ENERGY_ACCEL] = true,
+};
+static int64_t on_since[ENERGY_SUBSYS_CNT];
+/* Charge per subsystem up to on_since [nA * ms], kept in full since the current can change */
+static uint64_t charge_used[ENERGY_SUBSYS_CNT];
+
+void energy_state_set(enum energy_subsys subsys, bool on)
+{
+    k_spinlock_key_t key = k_spin_lock(&energy_lock);
+    int64_t now = k_uptime_get();
+
+    if (state_on[subsys] && !on) {
+        charge_used[subsys] += (uint64_t)(now - on_since[subsys]) * currents[subsys];
+    } else if (!state_on[subsys] && on) {
+        on_since[subsys] = now;
+    }
+    state_on[subsys] = on;
+
+    k_spin_unlock(&energy_lock, key);
+}
+
+
+void energy_time_add(enum energy_subsys subsys, uint32_t time)
+{
+    k_spinlock_key_t key = k_spin_lock(&energy_lock);
+
+    charge_used[subsys] += (uint64_t)time * currents[subsys];
+
+    k_spin_unlock(&energy_lock, key);
+}
+
+
+void energy_accel_odr_set(uint32_t odr)
+{
+    uint32_t current = CONFIG_ENERGY_CURRENT_ACCEL;
+    k_spinlock_key_t key;
+    int64_t now;
+
+    /* Interpolated between the currents given at 100 Hz and at 400 Hz */
+    if (odr > ENERGY_ACCEL_ODR_LOW) {
+        current += (uint32_t)((int64_t)(CONFIG_ENERGY_CURRENT_ACCEL_400HZ - CONFIG_ENERGY_CURRENT_ACCEL) *
+          (MIN(odr, ENERGY_ACCEL_ODR_HIGH) - ENERGY_ACCEL_ODR_LOW) / (ENERGY_ACCEL_ODR_HIGH - ENERGY_ACCEL_ODR_LOW));
+    }
+
+    key = k_spin_lock(&energy_lock);
+    now = k_uptime_get();
+
+    /* The time so far is charged with the previous current */
+    if (state_on[ENERGY_ACCEL]) {
+        charge_used[ENERGY_ACCEL] += (uint64_t)(now - on_since[ENERGY_ACCEL]) * currents[ENERGY_ACCEL];
+        on_since[ENERGY_ACCEL] = now;
+    }
+    currents[ENERGY_ACCEL] = current;
+
+    k_spin_unlock(&energy_lock, key);
+} /* energy_accel_odr_set */
+
+
+void energy_report_get(struct energy_report *report)
+{
+    k_spinlock_key_t key = k_spin_lock(&energy_lock);
+    int64_t now = k_uptime_get();
+    uint64_t charge[ENERGY_SUBSYS_CNT];
+    uint64_t charge_total = 0;
+    uint64_t uptime = MAX(now, 1);
+    uint64_t remaining;
+
+    /* Charge per subsystem [nA * ms] */
+    for (int i = 0; i < ENERGY_SUBSYS_CNT; i++) {
+        charge[i] = charge_used[i] + (state_on[i] ? (uint64_t)(now - on_since[i]) * currents[i] : 0);
+    }
+
+    k_spin_unlock(&energy_lock, key);
+
+    report->current_total = 0;
+    for (int i = 0; i < ENERGY_SUBSYS_CNT; i++) {
+        report->current[i] = (uint32_t)(charge[i] / uptime / 1000);
+        report->current_total += report->current[i];
+        charge_total += charge[i];
+    }
+    report->charge = (uint32_t)(charge_total / 1000 / ENERGY_MS_PER_HOUR);
+
+    report->soc = battery_soc_get();
+    report->voltage = battery_voltage_get();
+
+    /* Without the fuel gauge the charge used is counted from a full battery */
+    if (report->soc <= 100) {
+        remaining = (uint64_t)CONFIG_ENERGY_BATTERY_CAPACITY * 1000 * report->soc / 100;
+    } else {
+        remaining = (uint64_t)CONFIG_ENERGY_BATTERY_CAPACITY * 1000;
+        remaining -= MIN(remaining, report->charge);
+    }
+    report->runtime = (uint32_t)(remaining / MAX(report->current_total, 1));
+} /* energy_report_get */
+
+
+int energy_text_get(char *str, size_t str_size)
+{
+    struct energy_report report;
+    int len = 0;
+
+    energy_report_get(&report);
+
+    len += snprintf(str, str_size, "Energy [mAh/h]");
+    for (int i = 0; (i < ENERGY_SUBSYS_CNT) && ((size_t)len < str_size); i++) {
+        len += snprintf(&str[len], str_size - len, "\n%s: %u.%03u", subsys_names[i], report.current[i] / 1000,
+          report.current[i] % 1000);
+    }
+    if ((size_t)len < str_size) {
+        len += snprintf(&str[len], str_size - len, "\nTotal: %u.%03u\nSoC: %u%%\nRuntime: %u h",
+          report.current_total / 1000, report.current_total % 1000, report.soc, report.runtime);
+    }
+
+    return MIN((size_t)len, str_size - 1);
+}
+
@@ -0,0 +1,99 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <zephyr.h>
+
+/** @brief Subsystems with their own entry in the current table. */
+enum energy_subsys {
+    /** Everything that is always on, the sleep floor of the board. */
+    ENERGY_BASE,
+    /** GNSS searching for the first fix. */
+    ENERGY_GNSS_SEARCH,
+    /** GNSS running after the first fix. */
+    ENERGY_GNSS_TRACK,
+    /** LTE radio sending a SMS or CoAP report, including the connection tail. */
+    ENERGY_LTE,
+    /** Accelerometer sampling at the ODR of the active movement profile. */
+    ENERGY_ACCEL,
+    /** Any LED on. */
+    ENERGY_LED,
+    ENERGY_SUBSYS_CNT,
+};
+
+/** @brief Energy report since boot. */
+struct energy_report {
+    /** Average current per subsystem, which is the same as the charge per hour [uAh/h]. */
+    uint32_t current[ENERGY_SUBSYS_CNT];
+    /** Average current of all subsystems [uA]. */
+    uint32_t current_total;
+    /** Charge used since boot [uAh]. */
+    uint32_t charge;
+    /** Battery state of charge from the fuel gauge [%], 0xFF without a fuel gauge. */
+    uint8_t soc;
+    /** Battery voltage [mV], 0 before the first sample. */
+    uint16_t voltage;
+    /** Projected remaining runtime at the average current [h]. */
+    uint32_t runtime;
+};
+
+#if defined(CONFIG_ENERGY)
+
+/**
+ * @brief Turn a subsystem on or off. The time it is on is charged with its current from the table.
+ *
+ * @param subsys the subsystem
+ * @param on true if the subsystem is on
+ */
+void energy_state_set(enum energy_subsys subsys, bool on);
+
+/**
+ * @brief Charge a subsystem for a time it was on, for activity that is not tracked with energy_state_set()
+ *
+ * @param subsys the subsystem
+ * @param time the time it was on [ms]
+ */
+void energy_time_add(enum energy_subsys subsys, uint32_t time);
+
+/**
+ * @brief Set the output data rate the accelerometer samples at, its current follows the rate from now on
+ *
+ * @param odr the output data rate [mHz]
+ */
+void energy_accel_odr_set(uint32_t odr);
+
+/**
+ * @brief Get the energy report
+ *
+ * @param report where the report is stored
+ */
+void energy_report_get(struct energy_report *report);
+
+/**
+ * @brief Encode the energy report as text, mAh per hour per subsystem and the projected runtime
+ *
+ * @param str where the NUL terminated text is stored
+ * @param str_size size of str
+ * @return int length of the text
+ */
+int energy_text_get(char *str, size_t str_size);
+
+#else
+
+static inline void energy_state_set(enum energy_subsys subsys, bool on)
+{
+}
+
+
+static inline void energy_time_add(enum energy_subsys subsys, uint32_t time)
+{
+}
+
+
+static inline void energy_accel_odr_set(uint32_t odr)
+{
+}
+
+
+#endif /* if defined(CONFIG_ENERGY) */
+
+#endif /* ENERGY_H */
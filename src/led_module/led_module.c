@@ -1,5 +1,6 @@
 #include <zephyr.h>
 #include "src/lib/common_events.h"
+#include "src/lib/event_bus.h"
 #include "drivers/led/led.h"
 
 static bool led_searching = false;
@@ -36,38 +37,43 @@ static void led_module_init_led_set(void)
 }
 
 
+EVENT_BUS_SUBSCRIBER_DEFINE(led_subscriber, APP_EVENT_GNSS_SEARCHING | APP_EVENT_GNSS_POSITION_FIXED);
+
 /* Thread for handling LED based on application events */
 static void led_module_thread(void)
 {
-    uint32_t events = 0;
+    struct app_event evt;
 
     if (0 != led_init()) {
         return;
     }
 
+    event_bus_subscribe(&led_subscriber);
+
     k_event_wait(&app_events, APP_EVENT_APPLICATION_INITIALIZED, 0, K_FOREVER);
 
     led_module_init_led_set();
 
     while (true) {
-        events = k_event_wait(&app_events, -1, 0, K_FOREVER);
-
-        if (APP_EVENT_GNSS_SEARCHING & events) {
-            if (0 == led_searching) {
-                led_green_state_set(0);
-                k_timer_start(&led_search_timer, K_MSEC(1000), K_MSEC(1000));
-                led_searching = true;
-            }
+        event_bus_wait(&led_subscriber, &evt, K_FOREVER);
+
+        switch (evt.type) {
+            case APP_EVENT_GNSS_SEARCHING:
+                if (0 == led_searching) {
+                    led_green_state_set(0);
+                    k_timer_start(&led_search_timer, K_MSEC(1000), K_MSEC(1000));
+                    led_searching = true;
+                }
+                break;
+            case APP_EVENT_GNSS_POSITION_FIXED:
+                k_timer_stop(&led_search_timer);
+                led_searching = false;
+                led_blue_state_set(0);
+                led_green_state_set(1);
+                break;
+            default:
+                break;
         }
-
-        if (APP_EVENT_GNSS_POSITION_FIXED & events) {
-            k_timer_stop(&led_search_timer);
-            led_searching = false;
-            led_blue_state_set(0);
-            led_green_state_set(1);
-        }
-
-        k_msleep(CONFIG_LED_MODULE_THREAD_SLEEP_MS);
     }
 } /* led_module_thread */
 
@@ -0,0 +1,47 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+
+#include "src/lib/app_latency.h"
+
+static struct k_spinlock latency_lock;
+/* Uptime of each stage of the open trace [ms] */
+static uint32_t trace[APP_LATENCY_STAGE_CNT];
+/* Next stage of the open trace, APP_LATENCY_MOVEMENT if no trace is open */
+static enum app_latency_stage trace_next = APP_LATENCY_MOVEMENT;
+static struct app_latency_stats stats;
+
+void app_latency_mark(enum app_latency_stage stage)
+{
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+    uint32_t now = k_uptime_get_32();
+
+    if (stage != trace_next) {
+        k_spin_unlock(&latency_lock, key);
+        return;
+    }
+
+    trace[stage] = now;
+    trace_next = stage + 1;
+
+    if (APP_LATENCY_STAGE_CNT == trace_next) {
+        stats.cnt++;
+        for (int i = 0; i < APP_LATENCY_STAGE_CNT; i++) {
+            stats.last[i] = trace[i] - trace[APP_LATENCY_MOVEMENT];
+            stats.max[i] = MAX(stats.max[i], stats.last[i]);
+            stats.sum[i] += stats.last[i];
+        }
+        trace_next = APP_LATENCY_MOVEMENT;
+    }
+
+    k_spin_unlock(&latency_lock, key);
+}
+
+
+void app_latency_stats_get(struct app_latency_stats *stats_out)
+{
+    k_spinlock_key_t key = k_spin_lock(&latency_lock);
+
+    *stats_out = stats;
+
+    k_spin_unlock(&latency_lock, key);
+}
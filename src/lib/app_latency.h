@@ -0,0 +1,42 @@
+#ifndef APP_LATENCY_H
+#define APP_LATENCY_H
+
+#include <zephyr.h>
+
+/** @brief Stages of a report, from the movement that caused it to the report being sent. */
+enum app_latency_stage {
+    APP_LATENCY_MOVEMENT,
+    APP_LATENCY_GNSS_START,
+    APP_LATENCY_FIX,
+    APP_LATENCY_SENT,
+    APP_LATENCY_STAGE_CNT,
+};
+
+/** @brief Latency statistics, per stage counted from the movement [ms]. */
+struct app_latency_stats {
+    /** Number of reports sent after a movement. */
+    uint32_t cnt;
+    /** Latency of the last report. */
+    uint32_t last[APP_LATENCY_STAGE_CNT];
+    /** Largest latency. */
+    uint32_t max[APP_LATENCY_STAGE_CNT];
+    /** Sum of the latencies, for the mean. */
+    uint64_t sum[APP_LATENCY_STAGE_CNT];
+};
+
+/**
+ * @brief Mark that a stage was reached. A movement starts a new trace if none is open, the other stages are only
+ *   recorded once per trace and in order. The trace is closed when APP_LATENCY_SENT is marked.
+ *
+ * @param stage the stage that was reached
+ */
+void app_latency_mark(enum app_latency_stage stage);
+
+/**
+ * @brief Get the latency statistics
+ *
+ * @param stats where the statistics are stored
+ */
+void app_latency_stats_get(struct app_latency_stats *stats);
+
+#endif /* APP_LATENCY_H */
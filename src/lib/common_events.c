@@ -1,15 +1,72 @@
 #include <zephyr.h>
+#include <zephyr/sys/atomic.h>
+
+#include "src/lib/common_events.h"
 
 K_EVENT_DEFINE(app_events);
 
-void k_event_set_masked(
-    struct k_event *event,
-    uint32_t events,
-    uint32_t events_mask)
+/* Authoritative copy of the status bits. app_events is only a mirror used to wake up waiting threads. */
+static atomic_t app_events_state;
+
+/**
+ * @brief Copy the status bits to the event object. A poster preempted between reading and writing the mirror can
+ *   write a stale value, so the mirror is rewritten until it matches the state after the write.
+ *
+ */
+static void app_events_sync(void)
+{
+    uint32_t state;
+
+    do {
+        state = (uint32_t)atomic_get(&app_events_state);
+        k_event_set(&app_events, state);
+    } while (state != (uint32_t)atomic_get(&app_events_state));
+}
+
+
+uint32_t app_events_get(void)
 {
-    uint32_t curr_events = k_event_wait(event, -1, 0, K_NO_WAIT);
+    return (uint32_t)atomic_get(&app_events_state);
+}
+
+
+uint32_t app_events_post(uint32_t events)
+{
+    uint32_t prev = (uint32_t)atomic_or(&app_events_state, events);
+
+    if ((prev & events) != events) {
+        app_events_sync();
+    }
+
+    return prev;
+}
+
+
+uint32_t app_events_clear(uint32_t events)
+{
+    uint32_t prev = (uint32_t)atomic_and(&app_events_state, ~events);
+
+    if (prev & events) {
+        app_events_sync();
+    }
+
+    return prev;
+}
+
+
+uint32_t app_events_set_masked(uint32_t events, uint32_t events_mask)
+{
+    atomic_val_t prev;
+    atomic_val_t next;
+
+    do {
+        prev = atomic_get(&app_events_state);
+        next = (prev & events_mask) | events;
+    } while (!atomic_cas(&app_events_state, prev, next));
+
+    if (prev != next) {
+        app_events_sync();
+    }
 
-    curr_events &= events_mask;
-    events |= curr_events;
-    k_event_set(event, events);
+    return (uint32_t)prev;
 }
@@ -3,6 +3,9 @@
 
 #include <zephyr.h>
 
+/* Events are published on the event bus (see event_bus.h). APP_EVENT_GNSS_INITIALIZED, APP_EVENT_GNSS_SEARCHING,
+ *   APP_EVENT_SMS_INITIALIZED and APP_EVENT_APPLICATION_INITIALIZED are also kept as status bits in app_events.
+ */
 typedef enum {
     APP_EVENT_GNSS_INITIALIZED        = 1 << 0,
     APP_EVENT_GNSS_SEARCH_REQ         = 1 << 1,
@@ -13,20 +16,47 @@ typedef enum {
     APP_EVENT_SMS_LOG_SEND            = 1 << 6,
     APP_EVENT_MOVEMENT_TRIGGERED      = 1 << 7,
     APP_EVENT_APPLICATION_INITIALIZED = 1 << 8,
+    APP_EVENT_REPORT_FLUSH            = 1 << 9,
+    APP_EVENT_SMS_STATS_SEND          = 1 << 10,
+    APP_EVENT_SMS_ENERGY_SEND         = 1 << 11,
+    APP_EVENT_SMS_PROFILE_SEND        = 1 << 12,
+    APP_EVENT_SMS_UPLINK_SEND         = 1 << 13,
+    APP_EVENT_REPORT_RETRY            = 1 << 14,
 } app_events_t;
 
+/* Status bits, only to be waited on. Use the app_events_* functions below to change them. */
 extern struct k_event app_events;
 
 /**
- * @brief Set or clear the events in an event object.
+ * @brief Get the current status bits
+ *
+ * @return uint32_t the status bits
+ */
+uint32_t app_events_get(void);
+
+/**
+ * @brief Set status bits atomically and wake up threads waiting for them
+ *
+ * @param events bits to set
+ * @return uint32_t the status bits before the call
+ */
+uint32_t app_events_post(uint32_t events);
+
+/**
+ * @brief Clear status bits atomically
+ *
+ * @param events bits to clear
+ * @return uint32_t the status bits before the call, can be used to test-and-clear a bit
+ */
+uint32_t app_events_clear(uint32_t events);
+
+/**
+ * @brief Set and clear status bits in one atomic compare-and-swap. The new state is (state & events_mask) | events.
  *
- * This routine sets the events stored in event object to the specified value. All tasks waiting on the event object
- *   event whose waiting conditions become met by this immediately unpend. Unlike k_event_set, this routine allows
- *   specific event bits to be set and cleared as determined by the mask.
- * @param event address of the event object
- * @param events events to set
- * @param events_mask events to keep
+ * @param events bits to set
+ * @param events_mask bits to keep
+ * @return uint32_t the status bits before the call
  */
-void k_event_set_masked(struct k_event *event, uint32_t events, uint32_t events_mask);
+uint32_t app_events_set_masked(uint32_t events, uint32_t events_mask);
 
 #endif /* COMMON_EVENTS_H */
@@ -0,0 +1,88 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "src/lib/event_bus.h"
+
+static struct event_bus_subscriber *subscribers[CONFIG_EVENT_BUS_SUBSCRIBERS_MAX];
+static atomic_t subscriber_cnt;
+static struct k_spinlock subscribe_lock;
+
+int event_bus_subscribe(struct event_bus_subscriber *subscriber)
+{
+    int retval = 0;
+    k_spinlock_key_t key = k_spin_lock(&subscribe_lock);
+    atomic_val_t cnt = atomic_get(&subscriber_cnt);
+
+    if (cnt >= CONFIG_EVENT_BUS_SUBSCRIBERS_MAX) {
+        retval = -ENOMEM;
+    } else {
+        subscribers[cnt] = subscriber;
+        atomic_set(&subscriber_cnt, cnt + 1);
+    }
+
+    k_spin_unlock(&subscribe_lock, key);
+
+    return retval;
+}
+
+
+void event_bus_publish(const struct app_event *evt)
+{
+    atomic_val_t cnt = atomic_get(&subscriber_cnt);
+
+    for (int i = 0; i < cnt; i++) {
+        struct event_bus_subscriber *subscriber = subscribers[i];
+
+        if (0 == (subscriber->mask & evt->type)) {
+            continue;
+        }
+
+        if (0 != k_msgq_put(subscriber->msgq, evt, K_NO_WAIT)) {
+            atomic_inc(&subscriber->dropped);
+        }
+    }
+}
+
+
+void event_bus_post(app_events_t type)
+{
+    struct app_event evt = {
+        .type = type
+    };
+
+    event_bus_publish(&evt);
+}
+
+
+int event_bus_wait(struct event_bus_subscriber *subscriber, struct app_event *evt, k_timeout_t timeout)
+{
+    int retval = 0;
+
+    retval = k_msgq_get(subscriber->msgq, evt, timeout);
+    atomic_inc(&subscriber->wakeups);
+
+    return retval;
+}
+
+
+void event_bus_stats_get(struct event_bus_subscriber *subscriber, struct event_bus_stats *stats)
+{
+    stats->wakeups = atomic_get(&subscriber->wakeups);
+    stats->dropped = atomic_get(&subscriber->dropped);
+}
+
+
+void event_bus_total_stats_get(struct event_bus_stats *stats)
+{
+    atomic_val_t cnt = atomic_get(&subscriber_cnt);
+    struct event_bus_stats subscriber_stats;
+
+    memset(stats, 0, sizeof(*stats));
+
+    for (int i = 0; i < cnt; i++) {
+        event_bus_stats_get(subscribers[i], &subscriber_stats);
+        stats->wakeups += subscriber_stats.wakeups;
+        stats->dropped += subscriber_stats.dropped;
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <zephyr.h>
+
+#include "src/lib/common_events.h"
+
+/** @brief Event published on the application event bus. */
+struct app_event {
+    /** Event type, exactly one of the app_events_t bits. */
+    app_events_t type;
+    /** Event payload, valid member depends on the type. */
+    union {
+        /** APP_EVENT_GNSS_POSITION_FIXED */
+        struct {
+            uint32_t seq;
+        } fix;
+    };
+};
+
+/** @brief Wakeup statistics for a subscriber. */
+struct event_bus_stats {
+    /** Number of times the subscriber returned from event_bus_wait(). The CPU wakeups of all threads, timers and
+     *  work items are counted by CONFIG_WAKEUP_STATS (see wakeup.h). */
+    uint32_t wakeups;
+    /** Number of events dropped because the subscriber queue was full. */
+    uint32_t dropped;
+};
+
+/** @brief A subscriber with its own event queue. */
+struct event_bus_subscriber {
+    /** Mask of app_events_t the subscriber receives. */
+    uint32_t mask;
+    /** Queue the events are delivered to. */
+    struct k_msgq *msgq;
+    atomic_t wakeups;
+    atomic_t dropped;
+};
+
+/**
+ * @brief Statically define an event bus subscriber
+ *
+ * @param _name name of the subscriber
+ * @param _mask mask of app_events_t to receive
+ */
+#define EVENT_BUS_SUBSCRIBER_DEFINE(_name, _mask)                                    \
+    K_MSGQ_DEFINE(_name##_msgq, sizeof(struct app_event), CONFIG_EVENT_BUS_QUEUE_SIZE, 4); \
+    static struct event_bus_subscriber _name = {                                     \
+        .mask = (_mask),                                                             \
+        .msgq = &_name##_msgq,                                                       \
+    }
+
+/**
+ * @brief Register a subscriber on the event bus. Events published before the subscriber is registered are not
+ *   delivered to it.
+ *
+ * @param subscriber the subscriber to register
+ * @return int 0 on success, negative on fail
+ */
+int event_bus_subscribe(struct event_bus_subscriber *subscriber);
+
+/**
+ * @brief Publish an event to every subscriber whose mask contains the event type. Never blocks and can be called
+ *   from ISR and callback context.
+ *
+ * @param evt the event to publish
+ */
+void event_bus_publish(const struct app_event *evt);
+
+/**
+ * @brief Publish an event without payload
+ *
+ * @param type the event type to publish
+ */
+void event_bus_post(app_events_t type);
+
+/**
+ * @brief Wait for the next event delivered to a subscriber
+ *
+ * @param subscriber the subscriber to wait on
+ * @param evt where the received event is stored
+ * @param timeout time to wait for an event
+ * @return int 0 on success, -EAGAIN if the wait timed out
+ */
+int event_bus_wait(struct event_bus_subscriber *subscriber, struct app_event *evt, k_timeout_t timeout);
+
+/**
+ * @brief Get the wakeup statistics of a subscriber
+ *
+ * @param subscriber the subscriber to get the statistics from
+ * @param stats where the statistics are stored
+ */
+void event_bus_stats_get(struct event_bus_subscriber *subscriber, struct event_bus_stats *stats);
+
+/**
+ * @brief Get the wakeup statistics summed over all registered subscribers
+ *
+ * @param stats where the statistics are stored
+ */
+void event_bus_total_stats_get(struct event_bus_stats *stats);
+
+#endif /* EVENT_BUS_H */
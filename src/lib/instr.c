@@ -0,0 +1,98 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <stdio.h>
+
+#include "src/lib/instr.h"
+
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_INSTR_RING_SIZE), "The instrumentation ring size must be a power of two");
+
+static const char *const probe_names[INSTR_PROBE_CNT] = {
+    [INSTR_GNSS_EVENT] = "gnss_evt",
+    [INSTR_GNSS_READ] = "gnss_read",
+    [INSTR_GNSS_START] = "gnss_start",
+    [INSTR_SMS_EVENT] = "sms_evt",
+    [INSTR_SMS_SEND] = "sms_send",
+    [INSTR_SMS_CALLBACK] = "sms_cb",
+    [INSTR_SMS_RX] = "sms_rx",
+    [INSTR_COAP_SEND] = "coap_send",
+    [INSTR_ACCEL_TRIGGER] = "accel_trig",
+};
+
+static atomic_t counter_cnt[INSTR_PROBE_CNT];
+static atomic_t counter_time[INSTR_PROBE_CNT];
+static atomic_t counter_time_max[INSTR_PROBE_CNT];
+
+/* Writers claim a slot with one atomic increment of the head. An entry being overwritten while it is dumped can be
+ *   torn, which is accepted for a diagnostic ring.
+ */
+static struct instr_entry ring[CONFIG_INSTR_RING_SIZE];
+static atomic_t ring_head;
+
+void instr_record(enum instr_probe probe, uint32_t start)
+{
+    uint32_t cycles = k_cycle_get_32() - start;
+    uint32_t time = k_cyc_to_us_floor32(cycles);
+    uint32_t idx = (uint32_t)atomic_inc(&ring_head) & (CONFIG_INSTR_RING_SIZE - 1);
+    atomic_val_t max;
+
+    atomic_inc(&counter_cnt[probe]);
+    atomic_add(&counter_time[probe], time);
+    do {
+        max = atomic_get(&counter_time_max[probe]);
+    } while ((time > (uint32_t)max) && !atomic_cas(&counter_time_max[probe], max, time));
+
+    ring[idx].start = start;
+    ring[idx].cycles = cycles;
+    ring[idx].probe = probe;
+}
+
+
+void instr_counter_get(enum instr_probe probe, struct instr_counter *counter)
+{
+    counter->cnt = atomic_get(&counter_cnt[probe]);
+    counter->time = atomic_get(&counter_time[probe]);
+    counter->time_max = atomic_get(&counter_time_max[probe]);
+}
+
+
+int instr_text_get(char *str, size_t str_size)
+{
+    struct instr_counter counter;
+    int len = 0;
+
+    str[0] = '\0';
+    for (int i = 0; (i < INSTR_PROBE_CNT) && ((size_t)len < str_size); i++) {
+        instr_counter_get(i, &counter);
+        /* Skipped to keep the text short */
+        if (0 == counter.cnt) {
+            continue;
+        }
+        len += snprintf(&str[len], str_size - len, "\n%s: %u/%u/%u", probe_names[i], counter.cnt,
+          counter.time / MAX(counter.cnt, 1), counter.time_max);
+    }
+
+    return MIN((size_t)len, str_size - 1);
+}
+
+
+void instr_dump(void)
+{
+    struct instr_counter counter;
+    uint32_t head = (uint32_t)atomic_get(&ring_head);
+    uint32_t cnt = MIN(head, CONFIG_INSTR_RING_SIZE);
+    const struct instr_entry *entry;
+
+    printk("instr: probe,cnt,mean_us,max_us\n");
+    for (int i = 0; i < INSTR_PROBE_CNT; i++) {
+        instr_counter_get(i, &counter);
+        printk("instr: %s,%u,%u,%u\n", probe_names[i], counter.cnt,
+          counter.time / MAX(counter.cnt, 1), counter.time_max);
+    }
+
+    printk("instr: start_cyc,probe,us\n");
+    for (uint32_t i = head - cnt; i != head; i++) {
+        entry = &ring[i & (CONFIG_INSTR_RING_SIZE - 1)];
+        printk("instr: %u,%s,%u\n", entry->start, probe_names[entry->probe % INSTR_PROBE_CNT],
+          k_cyc_to_us_floor32(entry->cycles));
+    }
+}
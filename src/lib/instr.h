@@ -0,0 +1,96 @@
+#ifndef INSTR_H
+#define INSTR_H
+
+#include <zephyr.h>
+
+/** @brief Instrumented hot paths. */
+enum instr_probe {
+    /** One event handled by gnss_event_thread. */
+    INSTR_GNSS_EVENT,
+    /** nrf_modem_gnss_read() of a PVT or NMEA frame. */
+    INSTR_GNSS_READ,
+    /** The modem calls starting a GNSS search. */
+    INSTR_GNSS_START,
+    /** One event handled by sms_thread. */
+    INSTR_SMS_EVENT,
+    /** sms_send_text(). */
+    INSTR_SMS_SEND,
+    /** sms_callback() from the modem library, copying a received SMS to the queue. */
+    INSTR_SMS_CALLBACK,
+    /** A received SMS from sms_callback() until its commands have been dispatched. */
+    INSTR_SMS_RX,
+    /** coap_report_send(), including the wait for the acknowledgement. */
+    INSTR_COAP_SEND,
+    /** accelerometer_trigger_handler(). */
+    INSTR_ACCEL_TRIGGER,
+    INSTR_PROBE_CNT,
+};
+
+/** @brief Counters of one probe. */
+struct instr_counter {
+    /** Number of times the probe was hit. */
+    uint32_t cnt;
+    /** Total time spent in the probe [us]. */
+    uint32_t time;
+    /** Longest time spent in the probe [us]. */
+    uint32_t time_max;
+};
+
+/** @brief One probe hit in the RAM ring. */
+struct instr_entry {
+    /** Cycle counter when the probe was entered. */
+    uint32_t start;
+    /** Time spent in the probe [cycles]. */
+    uint32_t cycles;
+    /** The instr_probe. */
+    uint32_t probe;
+};
+
+#if defined(CONFIG_INSTR)
+
+/* Wrap a hot path in INSTR_BEGIN(probe) and INSTR_END(probe) in the same scope. Both expand to nothing without
+ *   CONFIG_INSTR.
+ */
+# define INSTR_BEGIN(_probe)    uint32_t _instr_start_##_probe = k_cycle_get_32()
+# define INSTR_END(_probe)      instr_record(_probe, _instr_start_##_probe)
+
+/**
+ * @brief Record a probe hit in its counters and the RAM ring. Lock-free, can be called from any context.
+ *
+ * @param probe the probe
+ * @param start cycle counter when the probe was entered
+ */
+void instr_record(enum instr_probe probe, uint32_t start);
+
+/**
+ * @brief Get the counters of a probe
+ *
+ * @param probe the probe
+ * @param counter where the counters are stored
+ */
+void instr_counter_get(enum instr_probe probe, struct instr_counter *counter);
+
+/**
+ * @brief Encode the counters of the probes that have been hit as text, one line per probe with count, mean and max
+ *   time [us]. Every line starts with a newline, so the text can be appended to a heading.
+ *
+ * @param str where the NUL terminated text is stored
+ * @param str_size size of str
+ * @return int length of the text
+ */
+int instr_text_get(char *str, size_t str_size);
+
+/**
+ * @brief Print the counters and the RAM ring, oldest entry first, on the console
+ *
+ */
+void instr_dump(void);
+
+#else
+
+# define INSTR_BEGIN(_probe)
+# define INSTR_END(_probe)
+
+#endif /* if defined(CONFIG_INSTR) */
+
+#endif /* INSTR_H */
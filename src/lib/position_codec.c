@@ -0,0 +1,106 @@
+#include <zephyr.h>
+#include <string.h>
+
+#include "src/lib/position_codec.h"
+
+#define POSITION_CODEC_VARINT_MAX   5
+
+/**
+ * @brief Write a zigzag encoded varint
+ *
+ * @param dst where the varint is written, at least POSITION_CODEC_VARINT_MAX bytes
+ * @param value the value to write
+ * @return size_t number of bytes written
+ */
+static size_t position_codec_varint_put(uint8_t *dst, int32_t value)
+{
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    size_t len = 0;
+
+    do {
+        dst[len] = zigzag & 0x7f;
+        zigzag >>= 7;
+        if (zigzag) {
+            dst[len] |= 0x80;
+        }
+        len++;
+    } while (zigzag);
+
+    return len;
+}
+
+
+/**
+ * @brief Round a fixed-point value to a coarser resolution
+ *
+ * @param value the value to round
+ * @param divisor ratio between the resolutions
+ * @return int32_t the rounded value
+ */
+static int32_t position_codec_round(int32_t value, int32_t divisor)
+{
+    return (value >= 0) ? (value + divisor / 2) / divisor : (value - divisor / 2) / divisor;
+}
+
+
+int position_codec_init(struct position_codec *codec, uint8_t *buf, size_t size, uint16_t voltage)
+{
+    uint8_t tmp[2 + POSITION_CODEC_VARINT_MAX];
+    size_t len = 0;
+
+    tmp[len++] = POSITION_CODEC_VERSION << 4;
+    tmp[len++] = 0;
+    len += position_codec_varint_put(&tmp[len], voltage);
+
+    if (len > size) {
+        return -ENOMEM;
+    }
+
+    memcpy(buf, tmp, len);
+    memset(codec, 0, sizeof(*codec));
+    codec->buf = buf;
+    codec->size = size;
+    codec->len = len;
+
+    return 0;
+}
+
+
+int position_codec_add(struct position_codec *codec, const struct position_record *record)
+{
+    uint8_t tmp[POSITION_CODEC_FIX_SIZE_MAX];
+    size_t len = 0;
+    int32_t values[ARRAY_SIZE(codec->prev)] = {
+        (int32_t)record->timestamp,
+        position_codec_round(record->latitude, 100),
+        position_codec_round(record->longitude, 100),
+        record->altitude,
+    };
+
+    if (codec->cnt >= POSITION_CODEC_FIXES_MAX) {
+        return -ENOMEM;
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(values); i++) {
+        len += position_codec_varint_put(&tmp[len], values[i] - codec->prev[i]);
+    }
+    len += position_codec_varint_put(&tmp[len], (record->accuracy + 9) / 10);
+
+    if (codec->len + len > codec->size) {
+        return -ENOMEM;
+    }
+
+    memcpy(&codec->buf[codec->len], tmp, len);
+    memcpy(codec->prev, values, sizeof(values));
+    codec->len += len;
+    codec->buf[0] = (POSITION_CODEC_VERSION << 4) | codec->cnt;
+    codec->cnt++;
+
+    return 0;
+} /* position_codec_add */
+
+
+void position_codec_flags_set(struct position_codec *codec, uint8_t flags)
+{
+    codec->buf[1] = flags;
+}
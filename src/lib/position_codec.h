@@ -0,0 +1,80 @@
+#ifndef POSITION_CODEC_H
+#define POSITION_CODEC_H
+
+#include <zephyr.h>
+
+/* Encoded format, all multi-byte fields are zigzag encoded LEB128 varints:
+ *
+ *   header   1 byte: version in the upper nibble, number of fixes - 1 in the lower nibble
+ *   flags    1 byte: POSITION_CODEC_FLAG_*
+ *   voltage  battery voltage [mV]
+ *   fixes    per fix: timestamp [s], latitude [1e-5 deg], longitude [1e-5 deg], altitude [m] as deltas to the
+ *            previous fix (to zero for the first fix), then the absolute accuracy [m]
+ *
+ * tools/position_decode.py decodes messages on the host.
+ */
+#define POSITION_CODEC_VERSION      1
+#define POSITION_CODEC_FIXES_MAX    16
+
+/* Movement was detected since the previous message */
+#define POSITION_CODEC_FLAG_MOVEMENT    BIT(0)
+
+/* Largest encoded size of one fix [bytes] */
+#define POSITION_CODEC_FIX_SIZE_MAX 25
+
+/* Largest binary message whose base64 text fits in _len characters [bytes] */
+#define POSITION_CODEC_SIZE_FOR_TEXT(_len)  (((_len) / 4) * 3)
+
+/** @brief Fixed-point fix as stored and sent by the application. */
+struct position_record {
+    /** UTC time of the fix [s since 1970-01-01]. */
+    uint32_t timestamp;
+    /** Latitude [1e-7 deg]. */
+    int32_t latitude;
+    /** Longitude [1e-7 deg]. */
+    int32_t longitude;
+    /** Altitude [m]. */
+    int16_t altitude;
+    /** Horizontal accuracy [dm], saturated at UINT16_MAX. */
+    uint16_t accuracy;
+};
+
+/** @brief Encoder state for one message. */
+struct position_codec {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+    uint8_t cnt;
+    int32_t prev[4];
+};
+
+/**
+ * @brief Start encoding a message
+ *
+ * @param codec the encoder state
+ * @param buf buffer the message is encoded into
+ * @param size size of the buffer
+ * @param voltage battery voltage [mV]
+ * @return int 0 on success, -ENOMEM if the buffer cannot hold the header
+ */
+int position_codec_init(struct position_codec *codec, uint8_t *buf, size_t size, uint16_t voltage);
+
+/**
+ * @brief Add a fix to the message. Fixes should be added oldest first to keep the deltas small.
+ *
+ * @param codec the encoder state
+ * @param record the fix to add
+ * @return int 0 on success, -ENOMEM if the fix does not fit in the buffer or the message already holds
+ *   POSITION_CODEC_FIXES_MAX fixes. The message is left unchanged on fail.
+ */
+int position_codec_add(struct position_codec *codec, const struct position_record *record);
+
+/**
+ * @brief Set the flags of a message, can be done at any time before the message is sent
+ *
+ * @param codec the encoder state
+ * @param flags POSITION_CODEC_FLAG_* to set
+ */
+void position_codec_flags_set(struct position_codec *codec, uint8_t flags);
+
+#endif /* POSITION_CODEC_H */
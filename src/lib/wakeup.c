@@ -0,0 +1,29 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <tracing_user.h>
+
+#include "src/lib/wakeup.h"
+
+/* Single core, only changed from the idle thread and from interrupts */
+static bool cpu_idle;
+static atomic_t cpu_wakeups;
+
+void sys_trace_idle_user(void)
+{
+    cpu_idle = true;
+}
+
+
+void sys_trace_isr_enter_user(int nested_interrupts)
+{
+    if (cpu_idle) {
+        cpu_idle = false;
+        atomic_inc(&cpu_wakeups);
+    }
+}
+
+
+uint32_t wakeup_cpu_count_get(void)
+{
+    return (uint32_t)atomic_get(&cpu_wakeups);
+}
@@ -0,0 +1,19 @@
+#ifndef WAKEUP_H
+#define WAKEUP_H
+
+#include <zephyr.h>
+
+#if defined(CONFIG_WAKEUP_STATS)
+
+/**
+ * @brief Get the number of times the CPU has woken up from idle since boot. Every interrupt taken while idle counts,
+ *   so the kernel timer behind k_timer, k_work_delayable and k_sleep is included along with the GNSS, SMS and
+ *   accelerometer interrupts.
+ *
+ * @return uint32_t the number of wakeups
+ */
+uint32_t wakeup_cpu_count_get(void);
+
+#endif /* if defined(CONFIG_WAKEUP_STATS) */
+
+#endif /* WAKEUP_H */
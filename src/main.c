@@ -26,5 +26,5 @@ void main(void)
     }
 
     k_event_wait_all(&app_events, APP_EVENT_GNSS_INITIALIZED | APP_EVENT_SMS_INITIALIZED, 0, K_FOREVER);
-    k_event_post(&app_events, APP_EVENT_APPLICATION_INITIALIZED);
+    app_events_post(APP_EVENT_APPLICATION_INITIALIZED);
 } /* main */
@@ -0,0 +1,261 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <math.h>
+
+#include "src/movement/motion_class.h"
+
+#define MODULE  motion_class
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_MOVEMENT_LOG_LEVEL);
+
+/* Fractional bits of the Goertzel coefficients */
+#define MOTION_CLASS_Q          14
+
+/* Step frequencies probed with the Goertzel algorithm [mHz], walking is about 1.5 - 2.5 steps per second */
+static const uint16_t step_freqs[] = { 1500, 2000, 2500 };
+/* 2 * cos(2 * pi * f / fs) per step frequency, in Q14 */
+static int32_t step_coeffs[ARRAY_SIZE(step_freqs)];
+
+static struct k_spinlock class_lock;
+/* A run is the motion since the last still period longer than CONFIG_MOVEMENT_CLASS_GAP_TIME */
+static bool run_active = false;
+static int64_t run_start;
+static int64_t run_last;
+static uint32_t run_motion;
+static uint32_t run_relocation;
+static bool run_requested;
+static int64_t request_time;
+static struct motion_class_stats stats;
+
+/**
+ * @brief Integer square root
+ *
+ * @param value the value
+ * @return uint32_t the square root, rounded down
+ */
+static uint32_t motion_class_isqrt(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (0 != bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)root;
+}
+
+
+/**
+ * @brief Get the magnitude statistics and the share of the variance in the step band of a window
+ *
+ * @param xyz the samples [mg]
+ * @param cnt number of samples, not 0
+ * @param features where the features are stored
+ */
+static void motion_class_features_get(const int16_t (*xyz)[ACCELEROMETER_CHANNELS], uint16_t cnt,
+  struct motion_class_features *features)
+{
+    uint16_t mag[CONFIG_ACCELEROMETER_FIFO_WATERMARK];
+    uint32_t mag_sum = 0;
+    int32_t ac;
+    int64_t ac_sum2 = 0;
+    int64_t s0, s1, s2;
+    int64_t power;
+    int64_t power_max = 0;
+    int32_t coeffs[ARRAY_SIZE(step_coeffs)];
+    k_spinlock_key_t key = k_spin_lock(&class_lock);
+
+    memcpy(coeffs, step_coeffs, sizeof(coeffs));
+
+    k_spin_unlock(&class_lock, key);
+
+    cnt = MIN(cnt, ARRAY_SIZE(mag));
+
+    for (int i = 0; i < cnt; i++) {
+        mag[i] = (uint16_t)motion_class_isqrt((int64_t)xyz[i][0] * xyz[i][0] + (int64_t)xyz[i][1] * xyz[i][1] +
+            (int64_t)xyz[i][2] * xyz[i][2]);
+        mag_sum += mag[i];
+    }
+
+    features->mag_mean = (uint16_t)(mag_sum / cnt);
+
+    for (int i = 0; i < cnt; i++) {
+        ac = (int32_t)mag[i] - features->mag_mean;
+        ac_sum2 += (int64_t)ac * ac;
+    }
+
+    features->mag_std = (uint16_t)motion_class_isqrt(ac_sum2 / cnt);
+
+    /* Goertzel power of the magnitude at each step frequency, the strongest one is the step band energy */
+    for (int j = 0; j < ARRAY_SIZE(coeffs); j++) {
+        s1 = 0;
+        s2 = 0;
+        for (int i = 0; i < cnt; i++) {
+            s0 = ((int32_t)mag[i] - features->mag_mean) + ((coeffs[j] * s1) >> MOTION_CLASS_Q) - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+        power = s1 * s1 + s2 * s2 - ((coeffs[j] * s1) >> MOTION_CLASS_Q) * s2;
+        power_max = MAX(power_max, power);
+    }
+
+    /* A sine wave at a probed frequency has a Goertzel power of N / 2 times its sum of squares */
+    features->step_ratio = 0;
+    if (0 != ac_sum2) {
+        features->step_ratio = (uint8_t)MIN(200 * power_max / (cnt * ac_sum2), 100);
+    }
+} /* motion_class_features_get */
+
+
+/**
+ * @brief Classify a window from its features
+ *
+ * @param features the window features
+ * @return enum motion_class the class
+ */
+static enum motion_class motion_class_classify(const struct motion_class_features *features)
+{
+    if (features->mag_std < CONFIG_MOVEMENT_CLASS_STILL_STD) {
+        return MOTION_CLASS_STILL;
+    }
+
+    if ((features->step_ratio >= CONFIG_MOVEMENT_CLASS_STEP_RATIO) &&
+      (features->mag_std >= CONFIG_MOVEMENT_CLASS_STEP_STD))
+    {
+        return MOTION_CLASS_WALKING;
+    }
+
+    if (features->mag_std < CONFIG_MOVEMENT_CLASS_HANDLED_STD) {
+        return MOTION_CLASS_VEHICLE;
+    }
+
+    return MOTION_CLASS_HANDLED;
+}
+
+
+void motion_class_init(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&class_lock);
+
+    run_active = false;
+    memset(&stats, 0, sizeof(stats));
+
+    k_spin_unlock(&class_lock, key);
+
+    motion_class_odr_set(ACCELEROMETER_ODR_MHZ);
+}
+
+
+void motion_class_odr_set(uint32_t odr)
+{
+    int32_t coeffs[ARRAY_SIZE(step_freqs)];
+    k_spinlock_key_t key;
+
+    for (int i = 0; i < ARRAY_SIZE(step_freqs); i++) {
+        coeffs[i] = (int32_t)lroundf(2.0f * cosf(2.0f * 3.14159265f * step_freqs[i] / odr) * (1 << MOTION_CLASS_Q));
+    }
+
+    key = k_spin_lock(&class_lock);
+
+    memcpy(step_coeffs, coeffs, sizeof(step_coeffs));
+
+    k_spin_unlock(&class_lock, key);
+}
+
+
+bool motion_class_window_add(int64_t now, const int16_t (*xyz)[ACCELEROMETER_CHANNELS], uint16_t cnt,
+  struct motion_class_features *features)
+{
+    struct motion_class_features window;
+    enum motion_class class;
+    bool request = false;
+    k_spinlock_key_t key;
+
+    if (0 == cnt) {
+        return false;
+    }
+
+    motion_class_features_get(xyz, cnt, &window);
+    class = motion_class_classify(&window);
+
+    key = k_spin_lock(&class_lock);
+
+    stats.windows[class]++;
+
+    if (run_active && (now - run_last > CONFIG_MOVEMENT_CLASS_GAP_TIME * MSEC_PER_SEC)) {
+        run_active = false;
+    }
+
+    if (MOTION_CLASS_STILL != class) {
+        if (!run_active) {
+            run_active = true;
+            run_start = now;
+            run_motion = 0;
+            run_relocation = 0;
+            run_requested = false;
+        }
+
+        run_last = now;
+        run_motion++;
+        if ((MOTION_CLASS_WALKING == class) || (MOTION_CLASS_VEHICLE == class)) {
+            run_relocation++;
+        }
+    }
+
+    /* Relocating when most of a long enough run is walking or vehicle, requested again every sustained time so
+     *   the GNSS scheduler keeps the device tracked as moving
+     */
+    if (run_active && (now - run_start >= CONFIG_MOVEMENT_CLASS_SUSTAINED_TIME * MSEC_PER_SEC) &&
+      (2 * run_relocation >= run_motion) &&
+      (!run_requested || (now - request_time >= CONFIG_MOVEMENT_CLASS_SUSTAINED_TIME * MSEC_PER_SEC)))
+    {
+        run_requested = true;
+        request_time = now;
+        stats.requests++;
+        request = true;
+    }
+
+    k_spin_unlock(&class_lock, key);
+
+    LOG_DBG("Window class: %d, mean: %u mg, std: %u mg, step: %u %%", class, window.mag_mean, window.mag_std,
+      window.step_ratio);
+
+    if (NULL != features) {
+        *features = window;
+    }
+
+    return request;
+} /* motion_class_window_add */
+
+
+void motion_class_trigger_count(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&class_lock);
+
+    stats.triggers++;
+
+    k_spin_unlock(&class_lock, key);
+}
+
+
+void motion_class_stats_get(struct motion_class_stats *stats_out)
+{
+    k_spinlock_key_t key = k_spin_lock(&class_lock);
+
+    *stats_out = stats;
+
+    k_spin_unlock(&class_lock, key);
+}
@@ -0,0 +1,86 @@
+#ifndef MOTION_CLASS_H
+#define MOTION_CLASS_H
+
+#include <zephyr.h>
+
+#include "drivers/sensor/accelerometer.h"
+
+/** @brief Motion class of one accelerometer window. */
+enum motion_class {
+    /** Lying still, only noise. */
+    MOTION_CLASS_STILL,
+    /** Short, irregular motion such as bumps or being picked up. */
+    MOTION_CLASS_HANDLED,
+    /** Periodic motion in the step frequency band. */
+    MOTION_CLASS_WALKING,
+    /** Low, continuous vibration without steps. */
+    MOTION_CLASS_VEHICLE,
+    MOTION_CLASS_CNT,
+};
+
+/** @brief Features of one accelerometer window. */
+struct motion_class_features {
+    /** Mean of the acceleration magnitude [mg]. */
+    uint16_t mag_mean;
+    /** Standard deviation of the acceleration magnitude [mg]. */
+    uint16_t mag_std;
+    /** Share of the magnitude variance in the step frequency band [%]. */
+    uint8_t step_ratio;
+};
+
+/** @brief Classifier statistics. */
+struct motion_class_stats {
+    /** Number of windows per motion_class. */
+    uint32_t windows[MOTION_CLASS_CNT];
+    /** Number of threshold triggers from the accelerometer. */
+    uint32_t triggers;
+    /** Number of GNSS requests for sustained relocation. */
+    uint32_t requests;
+};
+
+/*
+ * All times are passed in as uptime [ms], so the classifier can be driven by recorded traces as well as by the
+ *   accelerometer.
+ */
+
+/**
+ * @brief Init the classifier
+ *
+ */
+void motion_class_init(void);
+
+/**
+ * @brief Set the output data rate of the windows
+ *
+ * @param odr output data rate [mHz]
+ */
+void motion_class_odr_set(uint32_t odr);
+
+/**
+ * @brief Classify a window of samples and track how long the device has been relocating
+ *
+ * @param now current uptime [ms]
+ * @param xyz the samples [mg], oldest first
+ * @param cnt number of samples
+ * @param features where the window features are stored, can be NULL
+ * @return true if GNSS should be requested, the device has been walking or in a vehicle for
+ *   CONFIG_MOVEMENT_CLASS_SUSTAINED_TIME seconds
+ */
+bool motion_class_window_add(int64_t now, const int16_t (*xyz)[ACCELEROMETER_CHANNELS], uint16_t cnt,
+  struct motion_class_features *features);
+
+/**
+ * @brief Count a threshold trigger from the accelerometer, the triggers that do not lead to a GNSS request are the
+ *   false triggers the classifier saves
+ *
+ */
+void motion_class_trigger_count(void);
+
+/**
+ * @brief Get the classifier statistics
+ *
+ * @param stats where the statistics are stored
+ */
+void motion_class_stats_get(struct motion_class_stats *stats);
+
+#endif /* MOTION_CLASS_H */
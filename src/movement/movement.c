@@ -3,22 +3,67 @@
 #include <zephyr/drivers/sensor.h>
 
 #include "drivers/sensor/accelerometer.h"
+#include "src/lib/app_latency.h"
 #include "src/lib/common_events.h"
+#include "src/lib/event_bus.h"
+#include "src/movement/motion_class.h"
+#include "src/movement/movement_profile.h"
 
 #define MODULE  movement
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(MODULE, CONFIG_MOVEMENT_LOG_LEVEL);
 
-#define MOVEMENT_THRESHOLD  5.0f
+#if defined(CONFIG_ACCELEROMETER_ACT_INACT)
+
+/* Linked mode only interrupts on state changes, keep the GNSS scheduler's motion hold running while active */
+static void movement_active_timer_fn(struct k_timer *timer_id)
+{
+    event_bus_post(APP_EVENT_MOVEMENT_TRIGGERED);
+}
+
+
+static K_TIMER_DEFINE(movement_active_timer, movement_active_timer_fn, NULL);
+
+#endif /* if defined(CONFIG_ACCELEROMETER_ACT_INACT) */
 
 static void accelerometer_event_handler(const struct accelerometer_sensor_event *const evt)
 {
     switch (evt->type) {
         case ACCELEROMETER_EVENT_TRIGGER:
-            LOG_INF("New movement trigger! (x: %f ~ y: %f ~ z: %f)", evt->value_array[0], evt->value_array[1],
+            LOG_INF("New movement trigger! (x: %d ~ y: %d ~ z: %d mg)", evt->value_array[0], evt->value_array[1],
               evt->value_array[2]);
-            k_event_post(&app_events, APP_EVENT_MOVEMENT_TRIGGERED);
-            k_event_post(&app_events, APP_EVENT_GNSS_SEARCH_REQ);
+#if defined(CONFIG_MOVEMENT_CLASSIFIER)
+            /* The classifier decides from the FIFO batches if the device is relocating */
+            motion_class_trigger_count();
+#else
+            app_latency_mark(APP_LATENCY_MOVEMENT);
+            /* The GNSS scheduler decides when to search */
+            event_bus_post(APP_EVENT_MOVEMENT_TRIGGERED);
+#endif
+            break;
+#if defined(CONFIG_ACCELEROMETER_ACT_INACT)
+        case ACCELEROMETER_EVENT_ACTIVITY:
+            LOG_INF("Activity!");
+            app_latency_mark(APP_LATENCY_MOVEMENT);
+            event_bus_post(APP_EVENT_MOVEMENT_TRIGGERED);
+            k_timer_start(&movement_active_timer, K_SECONDS(CONFIG_GNSS_SCHEDULE_MOTION_HOLD / 2),
+              K_SECONDS(CONFIG_GNSS_SCHEDULE_MOTION_HOLD / 2));
+            break;
+        case ACCELEROMETER_EVENT_INACTIVITY:
+            /* The GNSS scheduler falls back to the stationary interval when the motion hold runs out */
+            LOG_INF("Inactivity!");
+            k_timer_stop(&movement_active_timer);
+            break;
+#endif
+        case ACCELEROMETER_EVENT_FIFO:
+            LOG_DBG("FIFO batch of %u samples", evt->fifo.cnt);
+#if defined(CONFIG_MOVEMENT_CLASSIFIER)
+            if (motion_class_window_add(k_uptime_get(), evt->fifo.xyz, evt->fifo.cnt, NULL)) {
+                LOG_INF("Sustained relocation!");
+                app_latency_mark(APP_LATENCY_MOVEMENT);
+                event_bus_post(APP_EVENT_MOVEMENT_TRIGGERED);
+            }
+#endif
             break;
         case ACCELEROMETER_EVENT_ERROR:
             LOG_ERR("Accelerometer error!");
@@ -33,8 +78,12 @@ int movement_init()
 {
     int retval = 0;
 
+#if defined(CONFIG_MOVEMENT_CLASSIFIER)
+    motion_class_init();
+#endif
+
     retval = accelerometer_init(accelerometer_event_handler);
-    retval |= accelerometer_movement_thres_set(MOVEMENT_THRESHOLD);
+    retval |= movement_profile_init();
     retval |= accelerometer_trigger_callback_set(1);
 
     return retval;
@@ -0,0 +1,266 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(CONFIG_SETTINGS)
+#include <zephyr/settings/settings.h>
+#endif
+
+#include "src/energy/energy.h"
+#include "src/lib/event_bus.h"
+#include "src/movement/motion_class.h"
+#include "src/movement/movement_profile.h"
+
+#define MODULE  movement_profile
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_MOVEMENT_LOG_LEVEL);
+
+struct movement_profile {
+    const char *name;
+    struct accelerometer_config config;
+};
+
+/* Built-in profiles, changed profiles are kept in settings */
+static struct movement_profile profiles[] = {
+    /* About 5 m/s2 on every sample, as before profiles */
+    { "default", { .threshold = 510, .debounce = 0, .odr = 12500, .range = 2 } },
+    /* Carried, picks up walking */
+    { "person", { .threshold = 300, .debounce = 0, .odr = 12500, .range = 2 } },
+    /* Ignores single bumps from the road */
+    { "vehicle", { .threshold = 400, .debounce = 500, .odr = 25000, .range = 4 } },
+    /* Only forklift handling and transport */
+    { "pallet", { .threshold = 800, .debounce = 1000, .odr = 12500, .range = 8 } },
+};
+
+static struct k_spinlock profile_lock;
+static uint8_t active;
+static uint8_t pending;
+static bool pending_config_set;
+static struct accelerometer_config pending_config;
+
+#if defined(CONFIG_SETTINGS)
+
+/* Loaded profiles are checked as strictly as the ones from a "Profile" SMS, an invalid one keeps the built-in */
+static int movement_profile_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    unsigned long idx;
+    char *end;
+    uint8_t value;
+    struct accelerometer_config config;
+
+    if (0 == strcmp(name, "active")) {
+        if ((len != sizeof(value)) || (read_cb(cb_arg, &value, len) != len)) {
+            return -EIO;
+        }
+        if (value >= ARRAY_SIZE(profiles)) {
+            return -EINVAL;
+        }
+        active = value;
+        return 0;
+    }
+
+    idx = strtoul(name, &end, 10);
+    if ((end == name) || ('\0' != *end) || (idx >= ARRAY_SIZE(profiles)) || (len != sizeof(config))) {
+        return -EINVAL;
+    }
+
+    if (read_cb(cb_arg, &config, len) != len) {
+        return -EIO;
+    }
+
+    if (0 != accelerometer_config_check(&config)) {
+        LOG_WRN("%s: Invalid saved profile %lu", __func__, idx);
+        return -EINVAL;
+    }
+
+    profiles[idx].config = config;
+
+    return 0;
+} /* movement_profile_settings_set */
+
+
+SETTINGS_STATIC_HANDLER_DEFINE(movement_profile, "movement", NULL, movement_profile_settings_set, NULL, NULL);
+
+#endif /* if defined(CONFIG_SETTINGS) */
+
+/**
+ * @brief Parse an output data rate
+ *
+ * @param str the rate [Hz], with one optional decimal like "12.5"
+ * @param end where the end of the rate is stored
+ * @return uint32_t the rate [mHz]
+ */
+static uint32_t movement_profile_odr_parse(const char *str, char **end)
+{
+    uint32_t odr = strtoul(str, end, 10) * MSEC_PER_SEC;
+
+    if ('.' == **end) {
+        odr += strtoul(*end + 1, end, 10) * 100;
+    }
+
+    return odr;
+}
+
+
+/**
+ * @brief Apply a profile to the accelerometer and make it the active one
+ *
+ * @param idx index of the profile
+ * @param config the configuration of the profile
+ * @return int 0 on success, negative on fail, the active profile is kept
+ */
+static int movement_profile_apply(uint8_t idx, const struct accelerometer_config *config)
+{
+    int retval = 0;
+    k_spinlock_key_t key;
+
+    retval = accelerometer_config_set(config);
+    if (0 != retval) {
+        LOG_ERR("Failed to apply profile %s, retval: %d", profiles[idx].name, retval);
+        return retval;
+    }
+
+    key = k_spin_lock(&profile_lock);
+
+    profiles[idx].config = *config;
+    active = idx;
+
+    k_spin_unlock(&profile_lock, key);
+
+    energy_accel_odr_set(config->odr);
+
+#if defined(CONFIG_MOVEMENT_CLASSIFIER)
+    motion_class_odr_set(config->odr);
+#endif
+
+    LOG_INF("Profile %s applied", profiles[idx].name);
+
+    return 0;
+}
+
+
+static void movement_profile_work_fn(struct k_work *work)
+{
+    uint8_t idx;
+    struct accelerometer_config config;
+    k_spinlock_key_t key = k_spin_lock(&profile_lock);
+
+    idx = pending;
+    config = pending_config_set ? pending_config : profiles[idx].config;
+    pending_config_set = false;
+
+    k_spin_unlock(&profile_lock, key);
+
+    if (0 == movement_profile_apply(idx, &config)) {
+#if defined(CONFIG_SETTINGS)
+        char name[sizeof("movement/") + 3];
+
+        snprintf(name, sizeof(name), "movement/%u", idx);
+        if ((0 != settings_save_one(name, &config, sizeof(config))) ||
+          (0 != settings_save_one("movement/active", &idx, sizeof(idx))))
+        {
+            LOG_WRN("%s: Failed to save profile %u", __func__, idx);
+        }
+#endif
+    }
+
+    event_bus_post(APP_EVENT_SMS_PROFILE_SEND);
+} /* movement_profile_work_fn */
+
+
+static K_WORK_DEFINE(movement_profile_work, movement_profile_work_fn);
+
+int movement_profile_init(void)
+{
+    int retval = 0;
+
+#if defined(CONFIG_SETTINGS)
+    retval = settings_subsys_init();
+    retval |= settings_load_subtree("movement");
+    if (0 != retval) {
+        LOG_WRN("%s: Failed to load the profiles, retval: %d", __func__, retval);
+    }
+#endif
+
+    return movement_profile_apply(active, &profiles[active].config);
+}
+
+
+int movement_profile_request(const char *cmd)
+{
+    int idx = -1;
+    size_t len;
+    char *end;
+    struct accelerometer_config config;
+    k_spinlock_key_t key;
+
+    while (' ' == *cmd) {
+        cmd++;
+    }
+
+    if ('\0' == *cmd) {
+        event_bus_post(APP_EVENT_SMS_PROFILE_SEND);
+        return 0;
+    }
+
+    len = strcspn(cmd, " ");
+    for (int i = 0; i < ARRAY_SIZE(profiles); i++) {
+        if ((strlen(profiles[i].name) == len) && (0 == strncmp(profiles[i].name, cmd, len))) {
+            idx = i;
+        }
+    }
+
+    if (idx < 0) {
+        event_bus_post(APP_EVENT_SMS_PROFILE_SEND);
+        return -EINVAL;
+    }
+
+    cmd += len;
+    if ('\0' != *cmd) {
+        config.threshold = (uint16_t)strtoul(cmd, &end, 10);
+        config.odr = movement_profile_odr_parse(end, &end);
+        config.range = (uint8_t)strtoul(end, &end, 10);
+        config.debounce = (uint16_t)strtoul(end, &end, 10);
+        if (('\0' != *end) || (0 != accelerometer_config_check(&config))) {
+            event_bus_post(APP_EVENT_SMS_PROFILE_SEND);
+            return -EINVAL;
+        }
+    }
+
+    key = k_spin_lock(&profile_lock);
+
+    pending = idx;
+    pending_config_set = ('\0' != *cmd);
+    if (pending_config_set) {
+        pending_config = config;
+    }
+
+    k_spin_unlock(&profile_lock, key);
+
+    k_work_submit(&movement_profile_work);
+
+    return 0;
+} /* movement_profile_request */
+
+
+int movement_profile_text_get(char *str, size_t str_size)
+{
+    struct accelerometer_config config;
+    const char *name;
+    int len;
+    k_spinlock_key_t key = k_spin_lock(&profile_lock);
+
+    name = profiles[active].name;
+
+    k_spin_unlock(&profile_lock, key);
+
+    /* The accelerometer has the configuration in use, also if applying the profile failed */
+    accelerometer_config_get(&config);
+
+    len = snprintf(str, str_size, "Profile: %s, %u mg, %u.%u Hz, %u g, %u ms", name, config.threshold,
+        config.odr / MSEC_PER_SEC, (config.odr % MSEC_PER_SEC) / 100, config.range, config.debounce);
+
+    return MIN(len, (int)str_size - 1);
+}
@@ -0,0 +1,36 @@
+#ifndef MOVEMENT_PROFILE_H
+#define MOVEMENT_PROFILE_H
+
+#include <zephyr.h>
+
+#include "drivers/sensor/accelerometer.h"
+
+/**
+ * @brief Load the profiles from settings and apply the active one. The accelerometer must be initialized.
+ *
+ * @return int 0 on success, negative on fail
+ */
+int movement_profile_init(void);
+
+/**
+ * @brief Request a profile change from a "Profile" SMS. Never blocks, the profile is applied and saved from the
+ *   system work queue, which then posts APP_EVENT_SMS_PROFILE_SEND.
+ *
+ * The command is "<name>" to switch to a profile, or "<name> <threshold mg> <odr Hz> <range g> <debounce ms>" to
+ *   change a profile and switch to it. An empty command only posts APP_EVENT_SMS_PROFILE_SEND.
+ *
+ * @param cmd the SMS text after "Profile"
+ * @return int 0 on success, -EINVAL if the command is invalid
+ */
+int movement_profile_request(const char *cmd);
+
+/**
+ * @brief Get the active profile as text
+ *
+ * @param str where the text is stored
+ * @param str_size size of str
+ * @return int length of the text
+ */
+int movement_profile_text_get(char *str, size_t str_size);
+
+#endif /* MOVEMENT_PROFILE_H */
@@ -0,0 +1,292 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <nrf_modem_gnss.h>
+
+#include "src/lib/event_bus.h"
+#include "src/positioning/gnss_schedule.h"
+
+#define MODULE  gnss_schedule
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_POSITIONING_LOG_LEVEL);
+
+/* Shortest fix interval the GNSS supports in periodic mode [s], shorter intervals use continuous tracking */
+#define GNSS_SCHEDULE_PERIODIC_INTERVAL_MIN 10
+
+static struct k_spinlock schedule_lock;
+static bool motion_seen = false;
+static int64_t motion_time;
+static float last_speed;
+/* True from the start of a search until the GNSS is stopped, also while tracking */
+static bool searching = false;
+/* Start of the search, or time of the last fix while tracking */
+static int64_t search_time;
+static bool tracking = false;
+/* Interval between the reported fixes and fix interval of the GNSS while tracking [s] */
+static uint32_t track_interval;
+static uint16_t track_fix_interval;
+static int64_t report_time;
+static struct gnss_schedule_stats stats;
+
+static void gnss_schedule_timer_fn(struct k_timer *timer_id)
+{
+    event_bus_post(APP_EVENT_GNSS_SEARCH_REQ);
+}
+
+
+static K_TIMER_DEFINE(gnss_schedule_timer, gnss_schedule_timer_fn, NULL);
+
+/**
+ * @brief Check if the device is moving, either from the accelerometer or from the speed of the last fix
+ *
+ * @param now current uptime [ms]
+ * @return true if the device is moving
+ */
+static bool gnss_schedule_is_moving(int64_t now)
+{
+    if (motion_seen && (now - motion_time < CONFIG_GNSS_SCHEDULE_MOTION_HOLD * MSEC_PER_SEC)) {
+        return true;
+    }
+
+    return (last_speed * 3.6f) >= CONFIG_GNSS_SCHEDULE_MOVING_SPEED;
+}
+
+
+/**
+ * @brief Get the interval that gives a fix about every CONFIG_GNSS_SCHEDULE_MOVING_DISTANCE meters
+ *
+ * @param speed horizontal speed [m/s]
+ * @return uint32_t the interval [s]
+ */
+static uint32_t gnss_schedule_moving_interval_get(float speed)
+{
+    uint32_t interval = CONFIG_GNSS_SCHEDULE_MOVING_INTERVAL_MAX;
+
+    if (speed > 0.0f) {
+        interval = (uint32_t)MIN(CONFIG_GNSS_SCHEDULE_MOVING_DISTANCE / speed, (float)interval);
+    }
+
+    return CLAMP(interval, CONFIG_GNSS_SCHEDULE_MOVING_INTERVAL_MIN, CONFIG_GNSS_SCHEDULE_MOVING_INTERVAL_MAX);
+}
+
+
+/**
+ * @brief Get the stationary interval, CONFIG_GNSS_SAMPLE_PERIODIC_INTERVAL doubled for every backoff step
+ *
+ * @return uint32_t the interval [s]
+ */
+static uint32_t gnss_schedule_stationary_interval_get(void)
+{
+    uint32_t interval = CONFIG_GNSS_SAMPLE_PERIODIC_INTERVAL;
+
+    for (uint32_t i = 0; (i < stats.backoff) && (interval < CONFIG_GNSS_SCHEDULE_STATIONARY_INTERVAL_MAX); i++) {
+        interval *= 2;
+    }
+
+    return MIN(interval, CONFIG_GNSS_SCHEDULE_STATIONARY_INTERVAL_MAX);
+}
+
+
+void gnss_schedule_init(int64_t now)
+{
+    k_spinlock_key_t key = k_spin_lock(&schedule_lock);
+
+    stats.interval = CONFIG_GNSS_SAMPLE_PERIODIC_INTERVAL;
+    k_timer_start(&gnss_schedule_timer, K_SECONDS(stats.interval), K_NO_WAIT);
+
+    k_spin_unlock(&schedule_lock, key);
+}
+
+
+void gnss_schedule_motion_set(int64_t now)
+{
+    k_spinlock_key_t key = k_spin_lock(&schedule_lock);
+    bool moving = gnss_schedule_is_moving(now);
+
+    motion_seen = true;
+    motion_time = now;
+    stats.backoff = 0;
+
+    /* Search right away when the device starts moving, while moving the schedule decides */
+    if (!moving) {
+        k_timer_start(&gnss_schedule_timer, K_NO_WAIT, K_NO_WAIT);
+    }
+
+    k_spin_unlock(&schedule_lock, key);
+}
+
+
+/**
+ * @brief Get the GNSS fix interval and power mode for a search interval
+ *
+ * @param interval the search interval [s]
+ * @param params where the fix interval and power mode are stored
+ */
+static void gnss_schedule_mode_get(uint32_t interval, struct gnss_schedule_params *params)
+{
+    if (interval < GNSS_SCHEDULE_PERIODIC_INTERVAL_MIN) {
+        params->fix_interval = 1;
+        params->power_mode = NRF_MODEM_GNSS_PSM_DUTY_CYCLING_PERFORMANCE;
+    } else {
+        params->fix_interval = (uint16_t)MIN(interval, UINT16_MAX);
+        params->power_mode = NRF_MODEM_GNSS_PSM_DISABLED;
+    }
+}
+
+
+/**
+ * @brief End the search or the tracking and schedule the next search, with the lock held
+ *
+ * @param moving true if the device is moving
+ * @return uint32_t interval to the next search [s]
+ */
+static uint32_t gnss_schedule_next_start(bool moving)
+{
+    uint32_t interval;
+
+    searching = false;
+    tracking = false;
+
+    if (moving) {
+        stats.backoff = 0;
+        interval = gnss_schedule_moving_interval_get(last_speed);
+    } else {
+        interval = gnss_schedule_stationary_interval_get();
+        if (interval < CONFIG_GNSS_SCHEDULE_STATIONARY_INTERVAL_MAX) {
+            stats.backoff++;
+        }
+    }
+
+    stats.interval = interval;
+    k_timer_start(&gnss_schedule_timer, K_SECONDS(interval), K_NO_WAIT);
+
+    return interval;
+}
+
+
+void gnss_schedule_search_start(int64_t now, struct gnss_schedule_params *params)
+{
+    k_spinlock_key_t key = k_spin_lock(&schedule_lock);
+    uint32_t interval;
+
+    /* A search restarted while tracking is part of the same search */
+    if (!searching) {
+        searching = true;
+        stats.searches++;
+    }
+    search_time = now;
+
+    params->tracking = gnss_schedule_is_moving(now);
+    if (params->tracking) {
+        interval = gnss_schedule_moving_interval_get(last_speed);
+        params->fix_retry = CONFIG_GNSS_SCHEDULE_MOVING_TIMEOUT;
+        gnss_schedule_mode_get(interval, params);
+    } else {
+        /* One fix, the timer starts the next search */
+        interval = gnss_schedule_stationary_interval_get();
+        params->fix_retry = CONFIG_GNSS_SAMPLE_PERIODIC_TIMEOUT;
+        params->fix_interval = 0;
+        params->power_mode = NRF_MODEM_GNSS_PSM_DISABLED;
+    }
+
+    track_interval = interval;
+    track_fix_interval = params->fix_interval;
+
+    k_spin_unlock(&schedule_lock, key);
+} /* gnss_schedule_search_start */
+
+
+uint32_t gnss_schedule_search_done(int64_t now, bool fixed, float speed)
+{
+    k_spinlock_key_t key = k_spin_lock(&schedule_lock);
+    uint32_t interval = 0;
+    bool moving;
+
+    if (searching) {
+        stats.on_time += now - search_time;
+        search_time = now;
+    }
+
+    if (fixed) {
+        last_speed = speed;
+        stats.fixes++;
+    } else {
+        stats.timeouts++;
+    }
+
+    /* A failed search backs off like a stationary device, there is no point in searching densely without fixes */
+    moving = fixed && gnss_schedule_is_moving(now);
+    if (moving && (0 != track_fix_interval)) {
+        /* The GNSS keeps running, gnss_schedule_track_fix() decides about the next fixes */
+        tracking = true;
+        report_time = now;
+        stats.interval = track_interval;
+    } else {
+        interval = gnss_schedule_next_start(moving);
+    }
+
+    k_spin_unlock(&schedule_lock, key);
+
+    if (0 == interval) {
+        LOG_INF("Tracking, a fix every %u s", track_interval);
+    } else {
+        LOG_INF("Next search in %u s (%s)", interval, moving ? "moving" : "stationary");
+    }
+
+    return interval;
+} /* gnss_schedule_search_done */
+
+
+enum gnss_schedule_track gnss_schedule_track_fix(int64_t now, float speed)
+{
+    k_spinlock_key_t key = k_spin_lock(&schedule_lock);
+    enum gnss_schedule_track retval = GNSS_SCHEDULE_TRACK_REPORT;
+    struct gnss_schedule_params params;
+    int64_t elapsed = now - search_time;
+
+    if (!tracking) {
+        k_spin_unlock(&schedule_lock, key);
+        return GNSS_SCHEDULE_TRACK_SKIP;
+    }
+
+    /* Continuous tracking keeps the GNSS on, in periodic mode it only runs from the end of the interval to the fix */
+    if (1 == track_fix_interval) {
+        stats.on_time += elapsed;
+    } else if (elapsed > track_fix_interval * MSEC_PER_SEC) {
+        stats.on_time += elapsed - track_fix_interval * MSEC_PER_SEC;
+    }
+    search_time = now;
+    last_speed = speed;
+
+    gnss_schedule_mode_get(gnss_schedule_moving_interval_get(speed), &params);
+
+    if (!gnss_schedule_is_moving(now)) {
+        gnss_schedule_next_start(false);
+        retval = GNSS_SCHEDULE_TRACK_STOP;
+    } else if ((params.fix_interval < track_fix_interval / 2) || (params.fix_interval / 2 > track_fix_interval)) {
+        /* The speed has changed too much for the running fix interval */
+        retval = GNSS_SCHEDULE_TRACK_RESTART;
+    } else if ((1 == track_fix_interval) && (now - report_time < track_interval * MSEC_PER_SEC)) {
+        /* Continuous tracking gives a fix every second */
+        retval = GNSS_SCHEDULE_TRACK_SKIP;
+    }
+
+    if (GNSS_SCHEDULE_TRACK_SKIP != retval) {
+        report_time = now;
+        stats.fixes++;
+    }
+
+    k_spin_unlock(&schedule_lock, key);
+
+    return retval;
+} /* gnss_schedule_track_fix */
+
+
+void gnss_schedule_stats_get(struct gnss_schedule_stats *stats_out)
+{
+    k_spinlock_key_t key = k_spin_lock(&schedule_lock);
+
+    *stats_out = stats;
+
+    k_spin_unlock(&schedule_lock, key);
+}
@@ -0,0 +1,103 @@
+#ifndef GNSS_SCHEDULE_H
+#define GNSS_SCHEDULE_H
+
+#include <zephyr.h>
+
+/** @brief GNSS parameters for the next search. */
+struct gnss_schedule_params {
+    /** Fix interval [s], 0 for a single fix, 1 for continuous tracking. */
+    uint16_t fix_interval;
+    /** Fix retry timeout [s], 0 to search until a fix is found. */
+    uint16_t fix_retry;
+    /** NRF_MODEM_GNSS_PSM_* power saving mode. */
+    uint8_t power_mode;
+    /** True if the GNSS keeps running after the first fix, the device is moving. */
+    bool tracking;
+};
+
+/** @brief What to do with a fix while tracking. */
+enum gnss_schedule_track {
+    /** Keep tracking, the fix is not reported. */
+    GNSS_SCHEDULE_TRACK_SKIP,
+    /** Keep tracking and report the fix. */
+    GNSS_SCHEDULE_TRACK_REPORT,
+    /** Report the fix and start the search again, the fix interval no longer suits the speed. */
+    GNSS_SCHEDULE_TRACK_RESTART,
+    /** Report the fix and stop the GNSS, the device stopped moving and the next search is scheduled. */
+    GNSS_SCHEDULE_TRACK_STOP,
+};
+
+/** @brief GNSS scheduler statistics. */
+struct gnss_schedule_stats {
+    /** Number of searches started. */
+    uint32_t searches;
+    /** Number of searches that timed out without a fix. */
+    uint32_t timeouts;
+    /** Number of fixes reported, from searches and while tracking. */
+    uint32_t fixes;
+    /** Number of times the stationary interval has been doubled since the device last moved. */
+    uint32_t backoff;
+    /** Interval to the next scheduled search [s]. */
+    uint32_t interval;
+    /** Total time the GNSS has been searching, estimated from the fix interval while tracking [ms]. */
+    uint64_t on_time;
+};
+
+/*
+ * All times are passed in as uptime [ms], so the scheduler can be driven by recorded traces as well as by the
+ *   GNSS module.
+ */
+
+/**
+ * @brief Init the scheduler and schedule the first search
+ *
+ * @param now current uptime [ms]
+ */
+void gnss_schedule_init(int64_t now);
+
+/**
+ * @brief Tell the scheduler the accelerometer detected movement. The device is considered moving until
+ *   CONFIG_GNSS_SCHEDULE_MOTION_HOLD seconds after the last movement.
+ *
+ * @param now current uptime [ms]
+ */
+void gnss_schedule_motion_set(int64_t now);
+
+/**
+ * @brief Get the GNSS parameters for a search that is about to start. A moving device is tracked, the GNSS keeps
+ *   running in continuous or periodic mode after the first fix. A stationary device gets a single fix.
+ *
+ * @param now current uptime [ms]
+ * @param params where the parameters are stored
+ */
+void gnss_schedule_search_start(int64_t now, struct gnss_schedule_params *params);
+
+/**
+ * @brief Tell the scheduler a search got its first fix or timed out. Unless the device is tracked, the search ends
+ *   and the next one is scheduled, which posts APP_EVENT_GNSS_SEARCH_REQ. Also ends the tracking on a timeout.
+ *
+ * @param now current uptime [ms]
+ * @param fixed true if the search ended with a fix, false if it timed out
+ * @param speed horizontal speed of the fix [m/s], ignored if fixed is false
+ * @return uint32_t interval to the next search [s], 0 if the GNSS keeps running to track the device
+ */
+uint32_t gnss_schedule_search_done(int64_t now, bool fixed, float speed);
+
+/**
+ * @brief Tell the scheduler about a fix after the first one while tracking. Continuous tracking is thinned to the
+ *   moving interval, in periodic mode every fix is reported.
+ *
+ * @param now current uptime [ms]
+ * @param speed horizontal speed of the fix [m/s]
+ * @return enum gnss_schedule_track what to do with the fix, GNSS_SCHEDULE_TRACK_SKIP if not tracking
+ */
+enum gnss_schedule_track gnss_schedule_track_fix(int64_t now, float speed);
+
+/**
+ * @brief Get the scheduler statistics
+ *
+ * @param stats where the statistics are stored
+ */
+void gnss_schedule_stats_get(struct gnss_schedule_stats *stats);
+
+#endif /* GNSS_SCHEDULE_H */
@@ -1,13 +1,29 @@
 #include <zephyr.h>
 #include <zephyr/kernel.h>
 #include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <zephyr/sys/timeutil.h>
 #include <date_time.h>
 #include <nrf_modem_at.h>
 #include <nrf_modem_gnss.h>
 #include <modem/lte_lc.h>
 #include <modem/modem_info.h>
 
+#include "src/lib/app_latency.h"
 #include "src/lib/common_events.h"
+#include "src/lib/event_bus.h"
+#include "src/lib/instr.h"
+#include "src/battery/battery.h"
+#include "src/energy/energy.h"
+#include "src/positioning/positioning.h"
+#include "src/positioning/gnss_schedule.h"
+#if defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+#include "src/positioning/ttff_test.h"
+#endif
+#if defined(CONFIG_GNSS_SAMPLE_ASSISTANCE_MINIMAL)
+#include "src/assistance/assistance.h"
+#endif
 
 #define MODULE  gnss_module
 
@@ -20,30 +36,218 @@ static const char update_indicator[] = { '\\', '|', '/', '-' };
 
 static struct nrf_modem_gnss_nmea_data_frame nmea_data;
 static struct nrf_modem_gnss_pvt_data_frame pvt_data;
-static struct modem_param_info modem_param;
+#if defined(CONFIG_GNSS_SAMPLE_ASSISTANCE_MINIMAL)
+static struct nrf_modem_gnss_agps_data_frame agps_data;
+#endif
 
-K_MSGQ_DEFINE(event_msgq, sizeof(int), 10, 4);
+/* Double buffered fix snapshot. The GNSS event thread is the only writer: it announces the sequence number it is
+ *   about to write in snapshot_write_seq, fills snapshot_buf[seq & 1] and then publishes it in snapshot_seq. A
+ *   reader copies the published slot and only has to retry if the writer started on the same slot again meanwhile.
+ *   The plain copies of snapshot_buf are fenced with compiler_barrier() so they are not moved across the sequence
+ *   accesses, the nRF9160 application core is a single Cortex-M33 so no hardware barrier is needed.
+ */
+static struct pos_snapshot snapshot_buf[2];
+static atomic_t snapshot_write_seq;
+static atomic_t snapshot_seq;
+
+K_MSGQ_DEFINE(event_msgq, sizeof(int), CONFIG_POSITIONING_EVENT_QUEUE_SIZE, 4);
+
+/* Set while a PVT event is queued, later PVT notifications are coalesced into it */
+static atomic_t pvt_pending;
+static atomic_t event_received;
+static atomic_t event_coalesced;
+static atomic_t event_dropped;
+static atomic_t event_high_watermark;
+
+struct nmea_consumer {
+    uint16_t nmea_mask;
+    positioning_nmea_handler_t handler;
+};
+
+static struct nmea_consumer nmea_consumers[CONFIG_POSITIONING_NMEA_CONSUMERS_MAX];
+static atomic_t nmea_consumer_cnt;
+static atomic_t nmea_mask;
+static struct k_spinlock nmea_consumer_lock;
+
+int positioning_snapshot_get(struct pos_snapshot *snapshot)
+{
+    uint32_t seq;
 
-int positioning_data_get(float *latitude, float *longitude, float *altitude, float *accuracy, int *voltage_level)
+    do {
+        seq = (uint32_t)atomic_get(&snapshot_seq);
+        if (0 == seq) {
+            return -ENODATA;
+        }
+
+        compiler_barrier();
+        *snapshot = snapshot_buf[seq & 1];
+        compiler_barrier();
+    } while ((uint32_t)atomic_get(&snapshot_write_seq) - seq >= 2);
+
+    return 0;
+}
+
+
+uint32_t positioning_snapshot_seq_get(void)
+{
+    return (uint32_t)atomic_get(&snapshot_seq);
+}
+
+
+void positioning_snapshot_to_record(const struct pos_snapshot *snapshot, struct position_record *record)
 {
-    if (0 == k_event_wait(&app_events, APP_EVENT_GNSS_POSITION_FIXED, 0, K_NO_WAIT)) {
-        return -1;
+    struct tm time = {
+        .tm_year = snapshot->datetime.year - 1900,
+        .tm_mon = snapshot->datetime.month - 1,
+        .tm_mday = snapshot->datetime.day,
+        .tm_hour = snapshot->datetime.hour,
+        .tm_min = snapshot->datetime.minute,
+        .tm_sec = snapshot->datetime.seconds,
+    };
+    float accuracy_dm = snapshot->accuracy * 10.0f;
+
+    record->timestamp = (uint32_t)timeutil_timegm(&time);
+    record->latitude = (int32_t)lround(snapshot->latitude * 1e7);
+    record->longitude = (int32_t)lround(snapshot->longitude * 1e7);
+    record->altitude = (int16_t)CLAMP(lroundf(snapshot->altitude), INT16_MIN, INT16_MAX);
+    record->accuracy = (accuracy_dm < UINT16_MAX) ? (uint16_t)accuracy_dm : UINT16_MAX;
+}
+
+
+int positioning_nmea_consumer_register(uint16_t mask, positioning_nmea_handler_t handler)
+{
+    int retval = 0;
+    k_spinlock_key_t key = k_spin_lock(&nmea_consumer_lock);
+    atomic_val_t cnt = atomic_get(&nmea_consumer_cnt);
+
+    if (cnt >= CONFIG_POSITIONING_NMEA_CONSUMERS_MAX) {
+        retval = -ENOMEM;
+    } else {
+        nmea_consumers[cnt].nmea_mask = mask;
+        nmea_consumers[cnt].handler = handler;
+        atomic_set(&nmea_consumer_cnt, cnt + 1);
+        atomic_or(&nmea_mask, mask);
     }
 
-    if (0 != modem_info_params_get(&modem_param)) {
-        return -1;
+    k_spin_unlock(&nmea_consumer_lock, key);
+
+    return retval;
+}
+
+
+/**
+ * @brief Get the NRF_MODEM_GNSS_NMEA_*_MASK bit of a NMEA sentence from its formatter, e.g. "$GPGGA"
+ *
+ * @param sentence the NMEA sentence
+ * @return uint16_t the mask bit, 0 if the sentence type is unknown
+ */
+static uint16_t nmea_sentence_mask_get(const char *sentence)
+{
+    static const struct {
+        char formatter[3];
+        uint16_t mask;
+    } types[] = {
+        { { 'G', 'G', 'A' }, NRF_MODEM_GNSS_NMEA_GGA_MASK },
+        { { 'G', 'L', 'L' }, NRF_MODEM_GNSS_NMEA_GLL_MASK },
+        { { 'G', 'S', 'A' }, NRF_MODEM_GNSS_NMEA_GSA_MASK },
+        { { 'G', 'S', 'V' }, NRF_MODEM_GNSS_NMEA_GSV_MASK },
+        { { 'R', 'M', 'C' }, NRF_MODEM_GNSS_NMEA_RMC_MASK },
+    };
+
+    /* "$" followed by a two character talker ID */
+    if ((sentence[0] != '$') || (strnlen(sentence, 6) < 6)) {
+        return 0;
     }
 
-    *latitude = pvt_data.latitude;
-    *longitude = pvt_data.longitude;
-    *altitude = pvt_data.altitude;
-    *accuracy = pvt_data.accuracy;
-    *voltage_level = modem_param.device.battery.value;
+    for (int i = 0; i < ARRAY_SIZE(types); i++) {
+        if (0 == memcmp(&sentence[3], types[i].formatter, sizeof(types[i].formatter))) {
+            return types[i].mask;
+        }
+    }
 
     return 0;
 }
 
 
+/**
+ * @brief Hand a NMEA sentence to the consumers that registered for its type
+ *
+ * @param sentence the NMEA sentence, only valid during the call
+ */
+static void nmea_sentence_dispatch(const char *sentence)
+{
+    uint16_t mask = nmea_sentence_mask_get(sentence);
+    atomic_val_t cnt = atomic_get(&nmea_consumer_cnt);
+
+    for (int i = 0; i < cnt; i++) {
+        if (nmea_consumers[i].nmea_mask & mask) {
+            nmea_consumers[i].handler(sentence);
+        }
+    }
+}
+
+
+/**
+ * @brief Publish a valid fix as the new snapshot. Must only be called from the GNSS event thread.
+ *
+ * @param pvt the PVT frame holding the fix
+ * @return uint32_t the sequence number of the fix
+ */
+static uint32_t positioning_snapshot_publish(const struct nrf_modem_gnss_pvt_data_frame *pvt)
+{
+    uint32_t seq = (uint32_t)atomic_get(&snapshot_seq) + 1;
+    struct pos_snapshot *snapshot = &snapshot_buf[seq & 1];
+    uint8_t sv_used = 0;
+
+    for (int i = 0; i < NRF_MODEM_GNSS_MAX_SATELLITES; ++i) {
+        if (pvt->sv[i].flags & NRF_MODEM_GNSS_SV_FLAG_USED_IN_FIX) {
+            sv_used++;
+        }
+    }
+
+    atomic_set(&snapshot_write_seq, seq);
+    compiler_barrier();
+
+    snapshot->seq = seq;
+    snapshot->uptime = k_uptime_get();
+    snapshot->latitude = pvt->latitude;
+    snapshot->longitude = pvt->longitude;
+    snapshot->altitude = pvt->altitude;
+    snapshot->accuracy = pvt->accuracy;
+    snapshot->speed = pvt->speed;
+    snapshot->heading = pvt->heading;
+    snapshot->pdop = pvt->pdop;
+    snapshot->hdop = pvt->hdop;
+    snapshot->sv_used = sv_used;
+    snapshot->datetime = pvt->datetime;
+
+    compiler_barrier();
+    atomic_set(&snapshot_seq, seq);
+
+    return seq;
+} /* positioning_snapshot_publish */
+
+
+/**
+ * @brief Read data from the GNSS
+ *
+ * @param buf where the data is stored
+ * @param len size of buf
+ * @param type NRF_MODEM_GNSS_DATA_* type of data to read
+ * @return int 0 on success, negative on fail
+ */
+static int gnss_data_read(void *buf, int32_t len, int type)
+{
+    int retval = 0;
+
+    INSTR_BEGIN(INSTR_GNSS_READ);
+    retval = nrf_modem_gnss_read(buf, len, type);
+    INSTR_END(INSTR_GNSS_READ);
+
+    return retval;
+}
+
+
 /**
  * @brief Start a search sequence to search for GNSS position
  *
@@ -52,30 +256,37 @@ int positioning_data_get(float *latitude, float *longitude, float *altitude, flo
 static int gnss_start_search(void)
 {
     int retval = 0;
+    struct gnss_schedule_params params;
 
-    k_event_post(&app_events, APP_EVENT_GNSS_SEARCHING);
+    app_events_post(APP_EVENT_GNSS_SEARCHING);
+    event_bus_post(APP_EVENT_GNSS_SEARCHING);
+
+    INSTR_BEGIN(INSTR_GNSS_START);
 
     retval |= nrf_modem_gnss_stop();
 
     /* Only use the gps, not qzss */
     uint8_t system_mask = NRF_MODEM_GNSS_SYSTEM_GPS_MASK;
 
-    retval |= nrf_modem_gnss_fix_retry_set(CONFIG_GNSS_SAMPLE_PERIODIC_TIMEOUT);
-    retval |= nrf_modem_gnss_fix_interval_set(CONFIG_GNSS_SAMPLE_PERIODIC_INTERVAL);
+#if defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+    ttff_test_search_start(&params);
+#else
+    /* The scheduler adapts the interval, timeout and power mode to the motion state */
+    gnss_schedule_search_start(k_uptime_get(), &params);
+#endif
+    retval |= nrf_modem_gnss_fix_retry_set(params.fix_retry);
+    retval |= nrf_modem_gnss_fix_interval_set(params.fix_interval);
+    retval |= nrf_modem_gnss_power_mode_set(params.power_mode);
     retval |= nrf_modem_gnss_system_mask_set(system_mask);
 
-    /* Enable all supported NMEA messages. */
-    uint16_t nmea_mask = NRF_MODEM_GNSS_NMEA_RMC_MASK
-      | NRF_MODEM_GNSS_NMEA_GGA_MASK
-      | NRF_MODEM_GNSS_NMEA_GLL_MASK
-      | NRF_MODEM_GNSS_NMEA_GSA_MASK
-      | NRF_MODEM_GNSS_NMEA_GSV_MASK;
-
-    retval = nrf_modem_gnss_nmea_mask_set(nmea_mask);
+    /* Only enable the NMEA messages that have consumers */
+    retval |= nrf_modem_gnss_nmea_mask_set((uint16_t)atomic_get(&nmea_mask));
 
     retval |= nrf_modem_gnss_start();
+    app_latency_mark(APP_LATENCY_GNSS_START);
+    energy_state_set(ENERGY_GNSS_SEARCH, true);
 
-    k_event_set_masked(&app_events, 0, ~APP_EVENT_GNSS_SEARCH_REQ);
+    INSTR_END(INSTR_GNSS_START);
 
     return retval;
 }
@@ -89,11 +300,53 @@ static int gnss_start_search(void)
 static void gnss_event_handler(int event)
 {
     int retval = 0;
+    uint32_t used = 0;
+
+    atomic_inc(&event_received);
+
+    switch (event) {
+        case NRF_MODEM_GNSS_EVT_PVT:
+            /* The queued event reads the latest PVT frame, so a second one is redundant */
+            if (atomic_set(&pvt_pending, 1)) {
+                atomic_inc(&event_coalesced);
+                return;
+            }
+            break;
+        case NRF_MODEM_GNSS_EVT_NMEA:
+            /* Do not queue NMEA frames that nobody consumes */
+            if (0 == atomic_get(&nmea_mask)) {
+                atomic_inc(&event_coalesced);
+                return;
+            }
+            break;
+        default:
+            break;
+    }
 
     retval = k_msgq_put(&event_msgq, &event, K_NO_WAIT);
     if (retval) {
-        LOG_ERR("%s: Failed to but GNSS event to message queue!", __func__);
+        if (NRF_MODEM_GNSS_EVT_PVT == event) {
+            atomic_clear(&pvt_pending);
+        }
+        atomic_inc(&event_dropped);
+        LOG_ERR("%s: Failed to put GNSS event to message queue!", __func__);
+        return;
     }
+
+    /* Only called from the modem library, so there is a single writer */
+    used = k_msgq_num_used_get(&event_msgq);
+    if (used > atomic_get(&event_high_watermark)) {
+        atomic_set(&event_high_watermark, used);
+    }
+} /* gnss_event_handler */
+
+
+void positioning_event_stats_get(struct positioning_event_stats *stats)
+{
+    stats->received = atomic_get(&event_received);
+    stats->coalesced = atomic_get(&event_coalesced);
+    stats->dropped = atomic_get(&event_dropped);
+    stats->high_watermark = atomic_get(&event_high_watermark);
 }
 
 
@@ -138,12 +391,6 @@ static int gnss_module_init(void)
         return retval;
     }
 
-    retval = modem_info_params_init(&modem_param);
-    if (0 != retval) {
-        LOG_WRN("modem_info_params_init, error: %d", retval);
-        return retval;
-    }
-
     return retval;
 } /* gnss_module_init */
 
@@ -152,19 +399,16 @@ static int gnss_module_init(void)
 
 static void print_battery_voltage(void)
 {
-    int retval = 0;
+    struct battery_stats stats;
 
-    retval = modem_info_params_get(&modem_param);
-    if (0 != retval) {
-        LOG_ERR("modem_info_params_get, error: %d", retval);
-        return;
-    }
+    battery_stats_get(&stats);
 
     /* Clear screen */
     LOG_DBG("\033[1;1H");
     LOG_DBG("\033[2J");
 
-    LOG_DBG("Battery voltage: %d mV", modem_param.device.battery.value);
+    LOG_DBG("Battery voltage: %u mV (min: %u mV, avg: %u mV, trend: %d mV/h)", stats.voltage, stats.min, stats.avg,
+      stats.trend);
 }
 
 
@@ -174,24 +418,29 @@ static void print_battery_voltage(void)
  */
 static void print_fix_data(void)
 {
+    struct pos_snapshot snapshot;
+
+    if (0 != positioning_snapshot_get(&snapshot)) {
+        return;
+    }
+
     /* Clear screen */
     LOG_DBG("\033[1;1H");
     LOG_DBG("\033[2J");
 
-    LOG_DBG("Latitude:       %.06f", pvt_data.latitude);
-    LOG_DBG("Longitude:      %.06f", pvt_data.longitude);
-    LOG_DBG("Altitude:       %.01f m", pvt_data.altitude);
-    LOG_DBG("Accuracy:       %.01f m", pvt_data.accuracy);
-    LOG_DBG("Speed:          %.01f m/s", pvt_data.speed);
-    LOG_DBG("Speed accuracy: %.01f m/s", pvt_data.speed_accuracy);
-    LOG_DBG("Heading:        %.01f deg", pvt_data.heading);
-    LOG_DBG("Date:           %04u-%02u-%02u", pvt_data.datetime.year, pvt_data.datetime.month, pvt_data.datetime.day);
-    LOG_DBG("Time (UTC):     %02u:%02u:%02u.%03u", pvt_data.datetime.hour, pvt_data.datetime.minute,
-      pvt_data.datetime.seconds, pvt_data.datetime.ms);
-    LOG_DBG("PDOP:           %.01f", pvt_data.pdop);
-    LOG_DBG("HDOP:           %.01f", pvt_data.hdop);
-    LOG_DBG("VDOP:           %.01f", pvt_data.vdop);
-    LOG_DBG("TDOP:           %.01f", pvt_data.tdop);
+    LOG_DBG("Fix:            %u", snapshot.seq);
+    LOG_DBG("Latitude:       %.06f", snapshot.latitude);
+    LOG_DBG("Longitude:      %.06f", snapshot.longitude);
+    LOG_DBG("Altitude:       %.01f m", snapshot.altitude);
+    LOG_DBG("Accuracy:       %.01f m", snapshot.accuracy);
+    LOG_DBG("Speed:          %.01f m/s", snapshot.speed);
+    LOG_DBG("Heading:        %.01f deg", snapshot.heading);
+    LOG_DBG("Date:           %04u-%02u-%02u", snapshot.datetime.year, snapshot.datetime.month, snapshot.datetime.day);
+    LOG_DBG("Time (UTC):     %02u:%02u:%02u.%03u", snapshot.datetime.hour, snapshot.datetime.minute,
+      snapshot.datetime.seconds, snapshot.datetime.ms);
+    LOG_DBG("PDOP:           %.01f", snapshot.pdop);
+    LOG_DBG("HDOP:           %.01f", snapshot.hdop);
+    LOG_DBG("Satellites:     %u", snapshot.sv_used);
 }
 
 
@@ -242,42 +491,63 @@ static void print_pvt(void)
 /* Threads */
 /*************************************************************/
 
+EVENT_BUS_SUBSCRIBER_DEFINE(gnss_subscriber,
+  APP_EVENT_GNSS_SEARCH_REQ | APP_EVENT_GNSS_STOP | APP_EVENT_GNSS_POSITION_FIXED | APP_EVENT_MOVEMENT_TRIGGERED);
+
 /* Handle events from the application */
 static void gnss_application_event_thread(void)
 {
     int retval = 0;
     uint32_t events = 0;
+    struct app_event evt;
 
     retval = gnss_module_init();
     if (0 != retval) {
         return;
     }
 
-    k_event_post(&app_events, APP_EVENT_GNSS_INITIALIZED);
-    k_event_wait(&app_events, APP_EVENT_APPLICATION_INITIALIZED, 0, K_FOREVER);
+    event_bus_subscribe(&gnss_subscriber);
 
-    while (1) {
-        events = k_event_wait(&app_events, -1, 0, K_FOREVER);
-
-        if (events & APP_EVENT_GNSS_SEARCH_REQ) {
-            /* Only start seaching for position if it is not already searching */
-            if (0 == (events & APP_EVENT_GNSS_SEARCHING)) {
-                gnss_start_search();
-            }
-        }
+    app_events_post(APP_EVENT_GNSS_INITIALIZED);
+    k_event_wait(&app_events, APP_EVENT_APPLICATION_INITIALIZED, 0, K_FOREVER);
 
-        if (events & APP_EVENT_GNSS_STOP) {
-            nrf_modem_gnss_stop();
-            k_event_set_masked(&app_events, 0, ~(APP_EVENT_GNSS_STOP | APP_EVENT_GNSS_SEARCHING));
-        }
+#if defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+    ttff_test_init();
+#else
+    gnss_schedule_init(k_uptime_get());
+#endif
 
-        if (events & APP_EVENT_GNSS_POSITION_FIXED) {
+    while (1) {
+        event_bus_wait(&gnss_subscriber, &evt, K_FOREVER);
+        events = app_events_get();
+
+        switch (evt.type) {
+            case APP_EVENT_GNSS_SEARCH_REQ:
+                /* Only start seaching for position if it is not already searching */
+                if (0 == (events & APP_EVENT_GNSS_SEARCHING)) {
+                    gnss_start_search();
+                }
+                break;
+            case APP_EVENT_GNSS_STOP:
+                nrf_modem_gnss_stop();
+                app_events_clear(APP_EVENT_GNSS_SEARCHING);
+                energy_state_set(ENERGY_GNSS_SEARCH, false);
+                energy_state_set(ENERGY_GNSS_TRACK, false);
+                break;
+            case APP_EVENT_MOVEMENT_TRIGGERED:
+#if !defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+                gnss_schedule_motion_set(k_uptime_get());
+#endif
+                break;
+            case APP_EVENT_GNSS_POSITION_FIXED:
 #ifndef CONFIG_SMS
-            print_fix_data();
-            print_battery_voltage();
+                print_fix_data();
+                print_battery_voltage();
 #endif
+                break;
+            default:
+                break;
         }
-        k_msleep(CONFIG_POSITIONING_THREAD_SLEEP);
     }
 } /* gnss_application_event_thread */
 
@@ -294,7 +564,15 @@ static void gnss_event_thread(void)
 {
     int retval = 0;
     int event = 0;
-    static bool gnss_fixed = false;
+    struct app_event fix_evt = {
+        .type = APP_EVENT_GNSS_POSITION_FIXED
+    };
+#if defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+    struct pos_snapshot snapshot;
+#else
+    /* The GNSS keeps running after the first fix of the search */
+    bool tracking = false;
+#endif
 
     k_event_wait(&app_events, APP_EVENT_GNSS_INITIALIZED, 0, K_FOREVER);
 
@@ -302,18 +580,60 @@ static void gnss_event_thread(void)
 
     while (1) {
         k_msgq_get(&event_msgq, &event, K_FOREVER);
+        INSTR_BEGIN(INSTR_GNSS_EVENT);
 
         switch (event) {
             case NRF_MODEM_GNSS_EVT_PVT:
-                retval = nrf_modem_gnss_read(&pvt_data, sizeof(struct nrf_modem_gnss_pvt_data_frame),
+                /* Clear before reading so a PVT notification arriving during the read is queued */
+                atomic_clear(&pvt_pending);
+                retval = gnss_data_read(&pvt_data, sizeof(struct nrf_modem_gnss_pvt_data_frame),
                     NRF_MODEM_GNSS_DATA_PVT);
                 if (0 != retval) {
                     LOG_WRN("%s: Failed to read from the gnss modem!", __func__);
                     break;
                 }
                 if (pvt_data.flags & NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID) {
-                    gnss_fixed = true;
-                    k_event_set_masked(&app_events, APP_EVENT_GNSS_POSITION_FIXED, ~(APP_EVENT_GNSS_SEARCHING));
+                    fix_evt.fix.seq = positioning_snapshot_publish(&pvt_data);
+                    /* Publish the first fix of each search, while tracking the scheduler picks the later ones */
+                    if (app_events_clear(APP_EVENT_GNSS_SEARCHING) & APP_EVENT_GNSS_SEARCHING) {
+                        app_latency_mark(APP_LATENCY_FIX);
+                        energy_state_set(ENERGY_GNSS_SEARCH, false);
+                        energy_state_set(ENERGY_GNSS_TRACK, true);
+                        /* Sample the battery while the GNSS loads it */
+                        battery_sample_request();
+#if defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+                        if (0 == positioning_snapshot_get(&snapshot)) {
+                            ttff_test_fix(&snapshot);
+                        }
+#else
+                        tracking = (0 == gnss_schedule_search_done(k_uptime_get(), true, pvt_data.speed));
+                        if (!tracking) {
+                            event_bus_post(APP_EVENT_GNSS_STOP);
+                        }
+#endif
+                        event_bus_publish(&fix_evt);
+                    }
+#if !defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+                    else if (tracking) {
+                        switch (gnss_schedule_track_fix(k_uptime_get(), pvt_data.speed)) {
+                            case GNSS_SCHEDULE_TRACK_REPORT:
+                                event_bus_publish(&fix_evt);
+                                break;
+                            case GNSS_SCHEDULE_TRACK_RESTART:
+                                /* Started again with the fix interval for the new speed */
+                                event_bus_post(APP_EVENT_GNSS_SEARCH_REQ);
+                                event_bus_publish(&fix_evt);
+                                break;
+                            case GNSS_SCHEDULE_TRACK_STOP:
+                                tracking = false;
+                                event_bus_post(APP_EVENT_GNSS_STOP);
+                                event_bus_publish(&fix_evt);
+                                break;
+                            default:
+                                break;
+                        }
+                    }
+#endif
                 } else {
 #ifndef CONFIG_SMS
                     print_pvt();
@@ -321,26 +641,50 @@ static void gnss_event_thread(void)
                 }
                 break;
             case NRF_MODEM_GNSS_EVT_NMEA:
-                if (IS_ENABLED(CONFIG_GNSS_MODULE_PVT) && gnss_fixed) {
-                    retval = nrf_modem_gnss_read(&nmea_data, sizeof(struct nrf_modem_gnss_nmea_data_frame),
-                        NRF_MODEM_GNSS_DATA_NMEA);
-                    if (0 != retval) {
-                        break;
-                    }
+                retval = gnss_data_read(&nmea_data, sizeof(struct nrf_modem_gnss_nmea_data_frame),
+                    NRF_MODEM_GNSS_DATA_NMEA);
+                if (0 != retval) {
+                    break;
+                }
+                nmea_sentence_dispatch(nmea_data.nmea_str);
+                break;
+#if defined(CONFIG_GNSS_SAMPLE_ASSISTANCE_MINIMAL)
+            case NRF_MODEM_GNSS_EVT_AGPS_REQ:
+                retval = gnss_data_read(&agps_data, sizeof(struct nrf_modem_gnss_agps_data_frame),
+                    NRF_MODEM_GNSS_DATA_AGPS_REQ);
+                if (0 != retval) {
+                    LOG_WRN("%s: Failed to read the assistance request!", __func__);
+                    break;
+                }
+                if (0 != assistance_request(&agps_data)) {
+                    LOG_WRN("%s: Assistance request dropped, one is already waiting", __func__);
                 }
                 break;
+#endif
             case NRF_MODEM_GNSS_EVT_BLOCKED:
                 break;
             case NRF_MODEM_GNSS_EVT_UNBLOCKED:
                 break;
             case NRF_MODEM_GNSS_EVT_SLEEP_AFTER_TIMEOUT:
                 LOG_INF("%s: GNSS timeout!", __func__);
-                k_event_set_masked(&app_events, 0, ~APP_EVENT_GNSS_SEARCHING);
+                energy_state_set(ENERGY_GNSS_SEARCH, false);
+                energy_state_set(ENERGY_GNSS_TRACK, false);
+#if defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+                app_events_clear(APP_EVENT_GNSS_SEARCHING);
+#else
+                if ((app_events_clear(APP_EVENT_GNSS_SEARCHING) & APP_EVENT_GNSS_SEARCHING) || tracking) {
+                    tracking = false;
+                    gnss_schedule_search_done(k_uptime_get(), false, 0.0f);
+                    /* In periodic mode the GNSS would wake for the next fix on its own */
+                    event_bus_post(APP_EVENT_GNSS_STOP);
+                }
+#endif
                 break;
             default:
                 break;
         }
-        k_msleep(CONFIG_POSITIONING_THREAD_SLEEP);
+
+        INSTR_END(INSTR_GNSS_EVENT);
     }
 } /* gnss_event_thread */
 
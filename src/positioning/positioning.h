@@ -1,16 +1,97 @@
 #ifndef POSITIONING_H
 #define POSITIONING_H
 
+#include <zephyr.h>
+#include <nrf_modem_gnss.h>
+
+#include "src/lib/position_codec.h"
+
+/** @brief Consistent copy of a GNSS fix. */
+struct pos_snapshot {
+    /** Fix sequence number, increases by one for every valid fix. */
+    uint32_t seq;
+    /** Uptime when the fix was received [ms]. */
+    int64_t uptime;
+    /** Latitude [deg]. */
+    double latitude;
+    /** Longitude [deg]. */
+    double longitude;
+    /** Altitude above WGS-84 ellipsoid [m]. */
+    float altitude;
+    /** Horizontal accuracy [m]. */
+    float accuracy;
+    /** Horizontal speed [m/s]. */
+    float speed;
+    /** Heading of user movement [deg]. */
+    float heading;
+    /** Position dilution of precision. */
+    float pdop;
+    /** Horizontal dilution of precision. */
+    float hdop;
+    /** Number of satellites used in the fix. */
+    uint8_t sv_used;
+    /** UTC date and time of the fix. */
+    struct nrf_modem_gnss_datetime datetime;
+};
+
+/** @brief Statistics of the GNSS event queue. */
+struct positioning_event_stats {
+    /** Number of events received from the GNSS driver. */
+    uint32_t received;
+    /** Number of events not queued because a queued event already covers them. */
+    uint32_t coalesced;
+    /** Number of events lost because the queue was full. */
+    uint32_t dropped;
+    /** Largest number of events waiting in the queue. */
+    uint32_t high_watermark;
+};
+
+/**
+ * @brief Handler for NMEA sentences
+ *
+ * @param sentence NUL terminated NMEA sentence. Points into the GNSS module's frame buffer and is only valid during
+ *   the call.
+ */
+typedef void (*positioning_nmea_handler_t)(const char *sentence);
+
+/**
+ * @brief Register a consumer of NMEA sentences. The GNSS only outputs the sentence types that have consumers, and
+ *   no NMEA is read at all without consumers. A new registration takes effect at the next search.
+ *
+ * @param mask NRF_MODEM_GNSS_NMEA_*_MASK bits of the sentence types to receive
+ * @param handler called from the GNSS event thread for each sentence of those types
+ * @return int 0 on success, -ENOMEM if CONFIG_POSITIONING_NMEA_CONSUMERS_MAX consumers are registered
+ */
+int positioning_nmea_consumer_register(uint16_t mask, positioning_nmea_handler_t handler);
+
+/**
+ * @brief Get a consistent copy of the latest fix. Never blocks the GNSS thread.
+ *
+ * @param snapshot where the fix is stored
+ * @return int 0 on success, -ENODATA if there has not been any fix yet
+ */
+int positioning_snapshot_get(struct pos_snapshot *snapshot);
+
+/**
+ * @brief Get the sequence number of the latest fix, to check for new fixes without copying the snapshot
+ *
+ * @return uint32_t the sequence number of the latest fix, 0 if there has not been any fix yet
+ */
+uint32_t positioning_snapshot_seq_get(void);
+
+/**
+ * @brief Get the statistics of the GNSS event queue
+ *
+ * @param stats where the statistics are stored
+ */
+void positioning_event_stats_get(struct positioning_event_stats *stats);
+
 /**
- * @brief
+ * @brief Convert a fix to the fixed-point record that is stored and sent
  *
- * @param latitude
- * @param longitude
- * @param altitude
- * @param accuracy
- * @param voltage_level
- * @return int
+ * @param snapshot the fix to convert
+ * @param record where the record is stored
  */
-int positioning_data_get(float *latitude, float *longitude, float *altitude, float *accuracy, int *voltage_level);
+void positioning_snapshot_to_record(const struct pos_snapshot *snapshot, struct position_record *record);
 
 #endif /* POSITIONING_H */
@@ -0,0 +1,121 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+#include <nrf_modem_gnss.h>
+
+#include "src/lib/event_bus.h"
+#include "src/positioning/ttff_test.h"
+
+#define MODULE  ttff_test
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_POSITIONING_LOG_LEVEL);
+
+static struct k_spinlock ttff_lock;
+static int64_t start_time;
+static struct ttff_test_stats stats = {
+    .ttff_min = UINT32_MAX,
+};
+
+static void ttff_test_timer_fn(struct k_timer *timer_id)
+{
+    event_bus_post(APP_EVENT_GNSS_SEARCH_REQ);
+}
+
+
+static K_TIMER_DEFINE(ttff_test_timer, ttff_test_timer_fn, NULL);
+
+/**
+ * @brief Print the test results as one line of key=value pairs, followed by the comma separated histogram
+ *
+ * @param summary the results to print
+ */
+static void ttff_test_summary_print(const struct ttff_test_stats *summary)
+{
+    printk("TTFF summary: n=%u min_ms=%u mean_ms=%u max_ms=%u "
+      "sv_used_x10=%u pdop_x10=%u hdop_x10=%u bin_s=%u hist=",
+      summary->cnt, summary->ttff_min, (uint32_t)(summary->ttff_sum / summary->cnt), summary->ttff_max,
+      summary->sv_used_sum * 10 / summary->cnt, summary->pdop_sum / summary->cnt, summary->hdop_sum / summary->cnt,
+      CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST_BIN_WIDTH);
+
+    for (int i = 0; i < ARRAY_SIZE(summary->histogram); i++) {
+        printk("%u%s", summary->histogram[i], (i < ARRAY_SIZE(summary->histogram) - 1) ? "," : "\n");
+    }
+}
+
+
+void ttff_test_init(void)
+{
+    k_timer_start(&ttff_test_timer, K_NO_WAIT, K_NO_WAIT);
+}
+
+
+void ttff_test_search_start(struct gnss_schedule_params *params)
+{
+    int retval = 0;
+    k_spinlock_key_t key;
+
+    if (IS_ENABLED(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST_COLD_START)) {
+        retval = nrf_modem_gnss_nv_data_delete(NRF_MODEM_GNSS_DELETE_EPHEMERIDES |
+            NRF_MODEM_GNSS_DELETE_ALMANACS |
+            NRF_MODEM_GNSS_DELETE_IONO_CORRECTION_DATA |
+            NRF_MODEM_GNSS_DELETE_LAST_GOOD_FIX |
+            NRF_MODEM_GNSS_DELETE_GPS_TOW |
+            NRF_MODEM_GNSS_DELETE_GPS_WEEK |
+            NRF_MODEM_GNSS_DELETE_UTC_DATA |
+            NRF_MODEM_GNSS_DELETE_GPS_TOW_PRECISION);
+        if (0 != retval) {
+            LOG_WRN("%s: Failed to delete GNSS data, retval: %d", __func__, retval);
+        }
+    }
+
+    /* Track continuously without power saving until the first fix */
+    params->fix_interval = 1;
+    params->fix_retry = 0;
+    params->power_mode = NRF_MODEM_GNSS_PSM_DISABLED;
+
+    key = k_spin_lock(&ttff_lock);
+    start_time = k_uptime_get();
+    k_spin_unlock(&ttff_lock, key);
+}
+
+
+void ttff_test_fix(const struct pos_snapshot *snapshot)
+{
+    struct ttff_test_stats summary;
+    k_spinlock_key_t key = k_spin_lock(&ttff_lock);
+    uint32_t ttff = (uint32_t)(snapshot->uptime - start_time);
+    uint32_t bin = MIN(ttff / (CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST_BIN_WIDTH * MSEC_PER_SEC),
+      CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST_BINS - 1);
+    uint32_t pdop = (uint32_t)lroundf(snapshot->pdop * 10.0f);
+    uint32_t hdop = (uint32_t)lroundf(snapshot->hdop * 10.0f);
+
+    stats.cnt++;
+    stats.ttff_min = MIN(stats.ttff_min, ttff);
+    stats.ttff_max = MAX(stats.ttff_max, ttff);
+    stats.ttff_sum += ttff;
+    stats.sv_used_sum += snapshot->sv_used;
+    stats.pdop_sum += pdop;
+    stats.hdop_sum += hdop;
+    stats.histogram[bin]++;
+    summary = stats;
+
+    k_spin_unlock(&ttff_lock, key);
+
+    printk("TTFF result: n=%u ttff_ms=%u sv_used=%u pdop_x10=%u hdop_x10=%u cold=%d\n", summary.cnt, ttff,
+      snapshot->sv_used, pdop, hdop, IS_ENABLED(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST_COLD_START));
+    ttff_test_summary_print(&summary);
+
+    event_bus_post(APP_EVENT_GNSS_STOP);
+    k_timer_start(&ttff_test_timer, K_SECONDS(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST_INTERVAL), K_NO_WAIT);
+} /* ttff_test_fix */
+
+
+void ttff_test_stats_get(struct ttff_test_stats *stats_out)
+{
+    k_spinlock_key_t key = k_spin_lock(&ttff_lock);
+
+    *stats_out = stats;
+
+    k_spin_unlock(&ttff_lock, key);
+}
@@ -0,0 +1,57 @@
+#ifndef TTFF_TEST_H
+#define TTFF_TEST_H
+
+#include <zephyr.h>
+
+#include "src/positioning/gnss_schedule.h"
+#include "src/positioning/positioning.h"
+
+/** @brief TTFF test results. */
+struct ttff_test_stats {
+    /** Number of tests with a fix. */
+    uint32_t cnt;
+    /** Shortest time to first fix [ms]. */
+    uint32_t ttff_min;
+    /** Longest time to first fix [ms]. */
+    uint32_t ttff_max;
+    /** Sum of the times to first fix [ms]. */
+    uint64_t ttff_sum;
+    /** Sum of the satellites used in the first fixes. */
+    uint32_t sv_used_sum;
+    /** Sum of the PDOP values of the first fixes, times 10. */
+    uint32_t pdop_sum;
+    /** Sum of the HDOP values of the first fixes, times 10. */
+    uint32_t hdop_sum;
+    /** Number of tests per CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST_BIN_WIDTH wide TTFF bin, the last bin holds the rest. */
+    uint32_t histogram[CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST_BINS];
+};
+
+/**
+ * @brief Start the first test
+ *
+ */
+void ttff_test_init(void);
+
+/**
+ * @brief Prepare the GNSS for a test, deletes the GNSS data for a cold start if configured. The GNSS must be
+ *   stopped.
+ *
+ * @param params where the GNSS parameters for the test are stored
+ */
+void ttff_test_search_start(struct gnss_schedule_params *params);
+
+/**
+ * @brief Record the first fix of a test, print the result and the summary, and schedule the next test
+ *
+ * @param snapshot the first fix
+ */
+void ttff_test_fix(const struct pos_snapshot *snapshot);
+
+/**
+ * @brief Get the test results
+ *
+ * @param stats where the results are stored
+ */
+void ttff_test_stats_get(struct ttff_test_stats *stats);
+
+#endif /* TTFF_TEST_H */
@@ -0,0 +1,164 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+
+#include "src/battery/battery.h"
+#include "src/positioning/positioning.h"
+#include "src/report/report_batch.h"
+#include "src/report/report_queue.h"
+#include "src/report/report_sink.h"
+#if defined(CONFIG_TRACK_LOG)
+#include "src/track_log/track_log.h"
+#endif
+
+#include "src/lib/app_latency.h"
+#include "src/lib/common_events.h"
+#include "src/lib/event_bus.h"
+
+#define MODULE  report
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_REPORT_LOG_LEVEL);
+
+/**
+ * @brief Send the queued reports that are due
+ *
+ */
+static void report_queue_send(void)
+{
+    if (report_queue_flush() > 0) {
+        app_latency_mark(APP_LATENCY_SENT);
+    }
+}
+
+
+/**
+ * @brief Queue the batched fixes and send the queue
+ *
+ * @param reason why the batch is sent
+ * @return int 0 on success, negative if the batch could not be queued
+ */
+static int report_data_send(enum report_batch_flush reason)
+{
+    const uint8_t *data;
+    enum report_queue_prio prio = report_batch_movement_get() ? REPORT_QUEUE_PRIO_ALERT : REPORT_QUEUE_PRIO_POSITION;
+    struct report_batch_log log;
+    int retval = 0;
+
+    retval = report_batch_data_get(&data);
+    if (retval < 0) {
+        return (-ENODATA == retval) ? 0 : retval;
+    }
+
+    /* A batch that does not fit in the queue goes to the track log */
+    retval = report_queue_put(prio, data, retval, (0 == report_batch_log_get(&log)) ? &log : NULL);
+    report_batch_sent(retval, reason);
+
+    report_queue_send();
+
+    return retval;
+}
+
+
+/**
+ * @brief Add the current position to the batch and send the batch if the flush policy says so. A fix that has
+ *   already been added is not added again.
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int report_data_add(void)
+{
+    static uint32_t added_seq;
+    struct pos_snapshot snapshot;
+    struct position_record record;
+    uint16_t voltage_level = battery_voltage_get();
+    int retval = 0;
+
+    if (0 != positioning_snapshot_get(&snapshot)) {
+        return -1;
+    }
+
+    if (snapshot.seq == added_seq) {
+        return 0;
+    }
+    added_seq = snapshot.seq;
+
+    positioning_snapshot_to_record(&snapshot, &record);
+
+    retval = report_batch_add(&record, voltage_level);
+    if (-ENOMEM == retval) {
+        retval = report_data_send(REPORT_BATCH_FLUSH_FULL);
+        if (0 != retval) {
+            LOG_WRN("%s: Full batch not queued, retval: %d", __func__, retval);
+        }
+        retval = report_batch_add(&record, voltage_level);
+    }
+
+    if (-ENOMEM == retval) {
+        /* Does not fit in the new batch either, keep it for a later one */
+#if defined(CONFIG_TRACK_LOG)
+        retval = track_log_append(&record);
+#endif
+        if (0 != retval) {
+            LOG_ERR("%s: Fix dropped, retval: %d", __func__, retval);
+        }
+    } else if (REPORT_BATCH_FLUSH_NONE != retval) {
+        retval = report_data_send(retval);
+    }
+
+    return retval;
+} /* report_data_add */
+
+
+EVENT_BUS_SUBSCRIBER_DEFINE(report_subscriber,
+  APP_EVENT_MOVEMENT_TRIGGERED | APP_EVENT_GNSS_POSITION_FIXED | APP_EVENT_REPORT_FLUSH | APP_EVENT_REPORT_RETRY);
+
+static void report_thread(void)
+{
+    int ret = 0;
+    struct app_event evt;
+
+    event_bus_subscribe(&report_subscriber);
+
+    k_event_wait(&app_events, APP_EVENT_APPLICATION_INITIALIZED, 0, K_FOREVER);
+
+    report_sink_init();
+    report_queue_init();
+    /* Reports queued before a reset */
+    report_queue_send();
+
+    while (1) {
+        event_bus_wait(&report_subscriber, &evt, K_FOREVER);
+
+        switch (evt.type) {
+            case APP_EVENT_MOVEMENT_TRIGGERED:
+                /* Sent as a flag with the next batch instead of a report of its own */
+                report_batch_movement_set();
+                break;
+            case APP_EVENT_GNSS_POSITION_FIXED:
+                ret = report_data_add();
+                if (ret) {
+                    LOG_INF("%d: report send returned err: %d\n", __LINE__, ret);
+                }
+                break;
+            case APP_EVENT_REPORT_FLUSH:
+                ret = report_data_send(REPORT_BATCH_FLUSH_AGE);
+                if (ret) {
+                    LOG_INF("%d: report send returned err: %d\n", __LINE__, ret);
+                }
+                break;
+            case APP_EVENT_REPORT_RETRY:
+                report_queue_send();
+                break;
+            default:
+                break;
+        }
+    }
+} /* report_thread */
+
+
+#define REPORT_THREAD_STACK_SIZE    2048
+#define REPORT_THREAD_PRIORITY      7
+
+K_THREAD_DEFINE(report_thread_id, REPORT_THREAD_STACK_SIZE,
+  report_thread, NULL, NULL, NULL,
+  K_PRIO_PREEMPT(REPORT_THREAD_PRIORITY), 0, 0);
@@ -0,0 +1,372 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "src/lib/event_bus.h"
+#include "src/report/report_batch.h"
+#if defined(CONFIG_TRACK_LOG)
+#include "src/track_log/track_log.h"
+#endif
+
+#define MODULE  report_batch
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_REPORT_LOG_LEVEL);
+
+#if defined(CONFIG_SMS_SEND_CONCATENATED_MSG_MAX_CNT)
+BUILD_ASSERT(CONFIG_REPORT_BATCH_SMS_SEGMENTS <= CONFIG_SMS_SEND_CONCATENATED_MSG_MAX_CNT,
+  "A batch can span more SMS segments than the SMS library sends");
+#endif
+
+/* The batch is only used from the thread that sends the reports */
+static uint8_t batch_buf[POSITION_CODEC_SIZE_FOR_TEXT(REPORT_BATCH_TEXT_LEN_MAX)];
+static struct position_codec batch_codec;
+static struct position_record batch_records[POSITION_CODEC_FIXES_MAX];
+static uint8_t batch_cnt;
+static uint8_t batch_logged_cnt;
+static struct report_batch_log batch_log;
+static bool batch_started = false;
+static bool batch_movement = false;
+static struct report_batch_stats stats;
+#if defined(CONFIG_TRACK_LOG)
+/* Fixes not from the track log of the periodic position waiting in the outbound queue, there is at most one */
+static struct position_record queued_records[POSITION_CODEC_FIXES_MAX];
+static uint8_t queued_cnt;
+
+/* Track log fixes in a queued report, or in a sent one until the older fixes are sent too */
+struct report_batch_log_range {
+    struct report_batch_log log;
+    bool sent;
+};
+
+static struct report_batch_log_range log_ranges[2 * CONFIG_REPORT_QUEUE_SIZE];
+static uint8_t log_range_cnt;
+/* Every unread fix before the cursor is in log_ranges, not known after a reset until a batch read the track log */
+static uint32_t log_next;
+static bool log_next_valid = false;
+#endif
+
+static void report_batch_timer_fn(struct k_timer *timer_id)
+{
+    event_bus_post(APP_EVENT_REPORT_FLUSH);
+}
+
+
+static K_TIMER_DEFINE(report_batch_timer, report_batch_timer_fn, NULL);
+
+#if defined(CONFIG_TRACK_LOG)
+
+/**
+ * @brief Find the queued or sent report holding a track log fix
+ *
+ * @param seq sequence number of the fix
+ * @return struct report_batch_log_range* the report, NULL if the fix is in none
+ */
+static struct report_batch_log_range *report_batch_log_find(uint32_t seq)
+{
+    for (int i = 0; i < log_range_cnt; i++) {
+        if (((int32_t)(seq - log_ranges[i].log.first) >= 0) && ((int32_t)(log_ranges[i].log.last - seq) >= 0)) {
+            return &log_ranges[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * @brief Keep track of the track log fixes in a queued report
+ *
+ * @param log the fixes
+ */
+static void report_batch_log_add(const struct report_batch_log *log)
+{
+    if (log_range_cnt < ARRAY_SIZE(log_ranges)) {
+        log_ranges[log_range_cnt].log = *log;
+        log_ranges[log_range_cnt].sent = false;
+        log_range_cnt++;
+    }
+}
+
+
+static void report_batch_log_remove(struct report_batch_log_range *range)
+{
+    *range = log_ranges[--log_range_cnt];
+}
+
+
+/**
+ * @brief Put the oldest unsent fixes from the track log that are not in a queued report first in the batch, leaving
+ *   room for one more fix. The fixes added are kept in batch_log.
+ *
+ * @return uint8_t number of fixes added
+ */
+static uint8_t report_batch_track_log_add(void)
+{
+    struct track_log_record records[POSITION_CODEC_FIXES_MAX - 1];
+    struct report_batch_log_range *range;
+    size_t size = batch_codec.size;
+    uint8_t added = 0;
+    bool from = log_next_valid;
+    uint32_t seq = log_next;
+    int cnt = 0;
+    int i = 0;
+
+    if (log_range_cnt >= ARRAY_SIZE(log_ranges)) {
+        LOG_WRN("%s: Too many reports with track log fixes waiting", __func__);
+        return 0;
+    }
+
+    /* Skip the fixes already in a report, every full read skips at least one report */
+    for (int pass = 0; pass <= ARRAY_SIZE(log_ranges); pass++) {
+        cnt = from ? track_log_read_from(seq, records, ARRAY_SIZE(records)) :
+          track_log_read(records, ARRAY_SIZE(records));
+        for (i = 0; i < cnt; i++) {
+            range = report_batch_log_find(records[i].seq);
+            if (NULL == range) {
+                break;
+            }
+            seq = range->log.last + 1;
+            from = true;
+        }
+        if ((i < cnt) || (cnt < (int)ARRAY_SIZE(records))) {
+            break;
+        }
+    }
+
+    if (cnt < 0) {
+        return 0;
+    }
+
+    if (i < cnt) {
+        seq = records[i].seq;
+        from = true;
+    }
+    if (from) {
+        log_next = seq;
+        log_next_valid = true;
+    }
+
+    batch_codec.size -= MIN(size, POSITION_CODEC_FIX_SIZE_MAX);
+    for (; (i < cnt) && (NULL == report_batch_log_find(records[i].seq)); i++) {
+        if (0 != position_codec_add(&batch_codec, &records[i].record)) {
+            break;
+        }
+        batch_log.first = (0 == added) ? records[i].seq : batch_log.first;
+        batch_log.last = records[i].seq;
+        added++;
+    }
+    batch_codec.size = size;
+
+    return added;
+} /* report_batch_track_log_add */
+
+
+#endif /* if defined(CONFIG_TRACK_LOG) */
+
+int report_batch_add(const struct position_record *record, uint16_t voltage)
+{
+    if (!batch_started) {
+        position_codec_init(&batch_codec, batch_buf, sizeof(batch_buf), voltage);
+#if defined(CONFIG_TRACK_LOG)
+        batch_logged_cnt = report_batch_track_log_add();
+#endif
+        batch_started = true;
+        k_timer_start(&report_batch_timer, K_SECONDS(CONFIG_REPORT_BATCH_FLUSH_AGE), K_NO_WAIT);
+    }
+
+    if (0 != position_codec_add(&batch_codec, record)) {
+        return -ENOMEM;
+    }
+    batch_records[batch_cnt++] = *record;
+
+    if (batch_movement && IS_ENABLED(CONFIG_REPORT_BATCH_FLUSH_ON_MOVEMENT)) {
+        return REPORT_BATCH_FLUSH_MOVEMENT;
+    }
+
+    if (batch_codec.cnt >= CONFIG_REPORT_BATCH_FLUSH_COUNT) {
+        return REPORT_BATCH_FLUSH_COUNT;
+    }
+
+    if ((batch_codec.cnt >= POSITION_CODEC_FIXES_MAX) ||
+      (batch_codec.size - batch_codec.len < POSITION_CODEC_FIX_SIZE_MAX))
+    {
+        return REPORT_BATCH_FLUSH_FULL;
+    }
+
+    return REPORT_BATCH_FLUSH_NONE;
+} /* report_batch_add */
+
+
+void report_batch_movement_set(void)
+{
+    batch_movement = true;
+}
+
+
+bool report_batch_movement_get(void)
+{
+    return batch_movement;
+}
+
+
+bool report_batch_is_empty(void)
+{
+    return !batch_started || (0 == batch_codec.cnt);
+}
+
+
+int report_batch_data_get(const uint8_t **data)
+{
+    if (report_batch_is_empty()) {
+        return -ENODATA;
+    }
+
+    position_codec_flags_set(&batch_codec, batch_movement ? POSITION_CODEC_FLAG_MOVEMENT : 0);
+    *data = batch_codec.buf;
+
+    return batch_codec.len;
+}
+
+
+int report_batch_log_get(struct report_batch_log *log)
+{
+    if (report_batch_is_empty() || (0 == batch_logged_cnt)) {
+        return -ENODATA;
+    }
+
+    *log = batch_log;
+
+    return 0;
+}
+
+
+void report_batch_sent(int result, enum report_batch_flush reason)
+{
+    uint8_t size = batch_codec.cnt;
+#if defined(CONFIG_TRACK_LOG)
+    struct report_batch_log_range *range;
+#endif
+
+    k_timer_stop(&report_batch_timer);
+
+    if (0 == result) {
+#if defined(CONFIG_TRACK_LOG)
+        /* The fixes from the track log stay unread until the queue has sent the batch, the next batches skip them */
+        if (0 != batch_logged_cnt) {
+            report_batch_log_add(&batch_log);
+            /* Unless a dropped report moved the cursor back meanwhile, also past the reports that follow */
+            if (log_next == batch_log.first) {
+                log_next = batch_log.last + 1;
+                for (range = report_batch_log_find(log_next); NULL != range; range = report_batch_log_find(log_next)) {
+                    log_next = range->log.last + 1;
+                }
+            }
+        }
+        if (!batch_movement) {
+            memcpy(queued_records, batch_records, batch_cnt * sizeof(batch_records[0]));
+            queued_cnt = batch_cnt;
+        }
+#endif
+        stats.batches++;
+        stats.fixes += size;
+        stats.last_size = size;
+        stats.max_size = MAX(stats.max_size, size);
+        stats.flushes[reason]++;
+        batch_movement = false;
+        LOG_INF("Batch of %u fixes queued", size);
+    } else {
+#if defined(CONFIG_TRACK_LOG)
+        for (int i = 0; i < batch_cnt; i++) {
+            if (0 != track_log_append(&batch_records[i])) {
+                LOG_WRN("%s: Failed to store fix in the track log", __func__);
+            }
+        }
+#endif
+        LOG_WRN("%s: Batch of %u fixes not queued, result: %d", __func__, size, result);
+    }
+
+    batch_started = false;
+    batch_cnt = 0;
+    batch_logged_cnt = 0;
+} /* report_batch_sent */
+
+
+void report_batch_dropped(bool position, const struct report_batch_log *log)
+{
+#if defined(CONFIG_TRACK_LOG)
+    struct report_batch_log_range *range;
+
+    if (NULL != log) {
+        range = report_batch_log_find(log->first);
+        if (NULL != range) {
+            report_batch_log_remove(range);
+        }
+        /* Its fixes are read again by the next batch */
+        if (log_next_valid && ((int32_t)(log->first - log_next) < 0)) {
+            log_next = log->first;
+        }
+    }
+
+    if (position) {
+        for (int i = 0; i < queued_cnt; i++) {
+            if (0 != track_log_append(&queued_records[i])) {
+                LOG_WRN("%s: Failed to store fix in the track log", __func__);
+            }
+        }
+        queued_cnt = 0;
+    }
+#endif
+} /* report_batch_dropped */
+
+
+void report_batch_log_sent(const struct report_batch_log *log)
+{
+#if defined(CONFIG_TRACK_LOG)
+    struct report_batch_log_range *range = report_batch_log_find(log->first);
+    uint32_t end = log_next;
+    int retval = 0;
+
+    if (NULL != range) {
+        range->sent = true;
+    }
+
+    /* Until a batch read the track log after a reset, older fixes may be in no report */
+    if (!log_next_valid) {
+        return;
+    }
+
+    /* The fixes before the cursor are all in a report, the ones before the oldest queued report have been sent */
+    for (int i = 0; i < log_range_cnt; i++) {
+        if (!log_ranges[i].sent && ((int32_t)(log_ranges[i].log.first - end) < 0)) {
+            end = log_ranges[i].log.first;
+        }
+    }
+
+    retval = track_log_consume(end - 1);
+    if (0 != retval) {
+        LOG_WRN("%s: Failed to mark the fixes as read, retval: %d", __func__, retval);
+        return;
+    }
+
+    for (int i = log_range_cnt - 1; i >= 0; i--) {
+        if ((int32_t)(log_ranges[i].log.last - end) < 0) {
+            report_batch_log_remove(&log_ranges[i]);
+        }
+    }
+#endif
+} /* report_batch_log_sent */
+
+
+void report_batch_log_queued(const struct report_batch_log *log)
+{
+#if defined(CONFIG_TRACK_LOG)
+    report_batch_log_add(log);
+#endif
+}
+
+
+void report_batch_stats_get(struct report_batch_stats *stats_out)
+{
+    *stats_out = stats;
+}
@@ -0,0 +1,137 @@
+#ifndef REPORT_BATCH_H
+#define REPORT_BATCH_H
+
+#include <zephyr.h>
+
+#include "src/lib/position_codec.h"
+
+/* Maximum text length of a batch, concatenated SMS segments carry 153 characters each */
+#if CONFIG_REPORT_BATCH_SMS_SEGMENTS > 1
+# define REPORT_BATCH_TEXT_LEN_MAX  (CONFIG_REPORT_BATCH_SMS_SEGMENTS * 153)
+#else
+# define REPORT_BATCH_TEXT_LEN_MAX  160
+#endif
+
+/** @brief Reason for flushing a batch. */
+enum report_batch_flush {
+    REPORT_BATCH_FLUSH_NONE,
+    REPORT_BATCH_FLUSH_COUNT,
+    REPORT_BATCH_FLUSH_AGE,
+    REPORT_BATCH_FLUSH_FULL,
+    REPORT_BATCH_FLUSH_MOVEMENT,
+    REPORT_BATCH_FLUSH_CNT,
+};
+
+/** @brief Batch statistics. */
+struct report_batch_stats {
+    /** Number of batches queued. */
+    uint32_t batches;
+    /** Number of fixes queued in batches. */
+    uint32_t fixes;
+    /** Number of fixes in the last batch queued. */
+    uint8_t last_size;
+    /** Largest number of fixes queued in one batch. */
+    uint8_t max_size;
+    /** Number of batches queued for each report_batch_flush reason. */
+    uint32_t flushes[REPORT_BATCH_FLUSH_CNT];
+};
+
+/** @brief Track log fixes in a report, by sequence number. */
+struct report_batch_log {
+    /** Sequence number of the first fix. */
+    uint32_t first;
+    /** Sequence number of the last fix. */
+    uint32_t last;
+};
+
+/**
+ * @brief Add a fix to the batch. The first fix of a batch starts the age timer, which posts APP_EVENT_REPORT_FLUSH
+ *   when it expires. With the track log enabled, unsent fixes from the log are put first in a new batch, skipping the
+ *   ones already in a queued report.
+ *
+ * @param record the fix to add
+ * @param voltage battery voltage [mV], used when the fix starts a new batch
+ * @return int the report_batch_flush reason if the batch should be sent now, REPORT_BATCH_FLUSH_NONE if not,
+ *   -ENOMEM if the fix did not fit and the batch has to be sent before adding it again
+ */
+int report_batch_add(const struct position_record *record, uint16_t voltage);
+
+/**
+ * @brief Flag that movement was detected, the flag is sent with the next batch
+ *
+ */
+void report_batch_movement_set(void);
+
+/**
+ * @brief Check if movement was detected since the last batch was sent
+ *
+ * @return true if the next batch carries the movement flag
+ */
+bool report_batch_movement_get(void);
+
+/**
+ * @brief Check if the batch holds any fixes
+ *
+ * @return true if there is nothing to send
+ */
+bool report_batch_is_empty(void);
+
+/**
+ * @brief Get the binary encoded batch, to be sent with report_sink_send()
+ *
+ * @param data where a pointer to the encoded batch is stored, valid until report_batch_sent() is called
+ * @return int length of the batch on success, negative on fail
+ */
+int report_batch_data_get(const uint8_t **data);
+
+/**
+ * @brief Get the track log fixes in the batch, to be handed back once the batch is sent or dropped
+ *
+ * @param log where the sequence numbers are stored
+ * @return int 0 on success, -ENODATA if the batch has no fixes from the track log
+ */
+int report_batch_log_get(struct report_batch_log *log);
+
+/**
+ * @brief Finish the batch after handing it to the outbound queue and start a new one. If the queue did not take it
+ *   the fixes are stored in the track log, if it is enabled.
+ *
+ * @param result the result of queueing the batch, 0 on success
+ * @param reason why the batch was sent
+ */
+void report_batch_sent(int result, enum report_batch_flush reason);
+
+/**
+ * @brief Hand back a report the outbound queue dropped before it was sent. Its track log fixes are read again by the
+ *   next batch. The fixes of a periodic position that were not read from the track log are stored in the track log,
+ *   if it is enabled, so the next batch carries them.
+ *
+ * @param position true for the periodic position
+ * @param log the track log fixes in the report, NULL if it has none
+ */
+void report_batch_dropped(bool position, const struct report_batch_log *log);
+
+/**
+ * @brief Hand back the track log fixes of a report the outbound queue sent. They are marked as read once every older
+ *   fix read from the track log has been sent as well.
+ *
+ * @param log the track log fixes in the report
+ */
+void report_batch_log_sent(const struct report_batch_log *log);
+
+/**
+ * @brief Tell which track log fixes a report kept in the outbound queue over a reset holds, so the next batches skip
+ *   them
+ *
+ * @param log the track log fixes in the report
+ */
+void report_batch_log_queued(const struct report_batch_log *log);
+
+/**
+ * @brief Get the batch statistics
+ *
+ * @param stats where the statistics are stored
+ */
+void report_batch_stats_get(struct report_batch_stats *stats);
+
+#endif /* REPORT_BATCH_H */
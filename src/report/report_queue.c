@@ -0,0 +1,330 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(CONFIG_REPORT_QUEUE_PERSISTENT)
+#include <zephyr/settings/settings.h>
+#endif
+
+#include "src/lib/event_bus.h"
+#include "src/report/report_batch.h"
+#include "src/report/report_queue.h"
+#include "src/report/report_sink.h"
+
+#define MODULE  report_queue
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_REPORT_LOG_LEVEL);
+
+/* Stored as is in settings, up to the end of the data */
+struct report_queue_msg {
+    /** Order the reports were queued in, kept over a reset. */
+    uint32_t seq;
+    /** Track log fixes in the report, valid if logged is set. */
+    struct report_batch_log log;
+    uint16_t len;
+    uint8_t prio;
+    /** The report holds fixes from the track log, they are handed back when it is sent or dropped. */
+    uint8_t logged;
+    uint8_t data[REPORT_QUEUE_MSG_LEN_MAX];
+} __packed;
+
+#define REPORT_QUEUE_MSG_HDR_LEN    offsetof(struct report_queue_msg, data)
+
+#if defined(CONFIG_REPORT_QUEUE_PERSISTENT)
+BUILD_ASSERT(sizeof(struct report_queue_msg) <= SETTINGS_MAX_VAL_LEN,
+  "A queued report must fit in one setting, lower REPORT_BATCH_SMS_SEGMENTS");
+#endif
+
+/* Slots with len 0 are empty */
+static struct report_queue_msg msgs[CONFIG_REPORT_QUEUE_SIZE];
+/* Failed sends per slot, not kept over a reset */
+static uint8_t attempts[CONFIG_REPORT_QUEUE_SIZE];
+static uint32_t next_seq;
+
+static uint32_t backoff;
+static int64_t retry_at;
+static atomic_t link_up;
+
+static struct k_spinlock stats_lock;
+static struct report_queue_stats stats;
+
+static void report_queue_timer_fn(struct k_timer *timer_id)
+{
+    event_bus_post(APP_EVENT_REPORT_RETRY);
+}
+
+
+static K_TIMER_DEFINE(report_queue_timer, report_queue_timer_fn, NULL);
+
+#if defined(CONFIG_REPORT_QUEUE_PERSISTENT)
+
+static int report_queue_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    unsigned long idx = strtoul(name, NULL, 10);
+    struct report_queue_msg *msg;
+
+    if ((idx >= ARRAY_SIZE(msgs)) || (len <= REPORT_QUEUE_MSG_HDR_LEN) || (len > sizeof(*msg))) {
+        return -EINVAL;
+    }
+
+    msg = &msgs[idx];
+    if ((read_cb(cb_arg, msg, len) != len) || (msg->len != len - REPORT_QUEUE_MSG_HDR_LEN)) {
+        msg->len = 0;
+        return -EIO;
+    }
+
+    next_seq = MAX(next_seq, msg->seq + 1);
+
+    return 0;
+}
+
+
+SETTINGS_STATIC_HANDLER_DEFINE(report_queue, "report", NULL, report_queue_settings_set, NULL, NULL);
+
+#endif /* if defined(CONFIG_REPORT_QUEUE_PERSISTENT) */
+
+/**
+ * @brief Store a slot in settings, or delete it if it is empty
+ *
+ * @param idx index of the slot
+ */
+static void report_queue_save(int idx)
+{
+#if defined(CONFIG_REPORT_QUEUE_PERSISTENT)
+    char name[sizeof("report/") + 3];
+    int retval = 0;
+
+    snprintf(name, sizeof(name), "report/%d", idx);
+    if (0 != msgs[idx].len) {
+        retval = settings_save_one(name, &msgs[idx], REPORT_QUEUE_MSG_HDR_LEN + msgs[idx].len);
+    } else {
+        retval = settings_delete(name);
+    }
+
+    if (0 != retval) {
+        LOG_WRN("%s: Failed to save slot %d, retval: %d", __func__, idx, retval);
+    }
+#endif
+}
+
+
+/**
+ * @brief Drop a report before it was sent. Its fixes go back to the batch, the ones it read from the track log were
+ *   never marked as read.
+ *
+ * @param idx index of the slot
+ */
+static void report_queue_drop(int idx)
+{
+    struct report_batch_log log = msgs[idx].log;
+
+    report_batch_dropped(REPORT_QUEUE_PRIO_POSITION == msgs[idx].prio, msgs[idx].logged ? &log : NULL);
+
+    msgs[idx].len = 0;
+    attempts[idx] = 0;
+}
+
+
+/**
+ * @brief Update the count in the statistics
+ *
+ */
+static void report_queue_count_update(void)
+{
+    uint32_t cnt = 0;
+    k_spinlock_key_t key;
+
+    for (int i = 0; i < ARRAY_SIZE(msgs); i++) {
+        cnt += (0 != msgs[i].len);
+    }
+
+    key = k_spin_lock(&stats_lock);
+    stats.count = cnt;
+    stats.backoff = backoff;
+    k_spin_unlock(&stats_lock, key);
+}
+
+
+/**
+ * @brief Find the slot to send next, or to drop when the queue is full
+ *
+ * @param lowest true for the oldest report with the lowest priority, false for the oldest with the highest priority
+ * @return int index of the slot, -1 if the queue is empty
+ */
+static int report_queue_find(bool lowest)
+{
+    int idx = -1;
+
+    for (int i = 0; i < ARRAY_SIZE(msgs); i++) {
+        if (0 == msgs[i].len) {
+            continue;
+        }
+        if ((idx < 0) || (lowest ? (msgs[i].prio < msgs[idx].prio) : (msgs[i].prio > msgs[idx].prio)) ||
+          ((msgs[i].prio == msgs[idx].prio) && (msgs[i].seq < msgs[idx].seq)))
+        {
+            idx = i;
+        }
+    }
+
+    return idx;
+}
+
+
+int report_queue_init(void)
+{
+    struct report_batch_log log;
+    int retval = 0;
+
+#if defined(CONFIG_REPORT_QUEUE_PERSISTENT)
+    retval = settings_subsys_init();
+    retval |= settings_load_subtree("report");
+    if (0 != retval) {
+        LOG_WRN("%s: Failed to load the queue, retval: %d", __func__, retval);
+    }
+#endif
+
+    /* The next batches must not read their track log fixes again */
+    for (int i = 0; i < ARRAY_SIZE(msgs); i++) {
+        if ((0 != msgs[i].len) && msgs[i].logged) {
+            log = msgs[i].log;
+            report_batch_log_queued(&log);
+        }
+    }
+
+    report_queue_count_update();
+
+    return retval;
+}
+
+
+int report_queue_put(enum report_queue_prio prio, const uint8_t *data, size_t len, const struct report_batch_log *log)
+{
+    int idx = -1;
+    k_spinlock_key_t key;
+
+    if ((0 == len) || (len > REPORT_QUEUE_MSG_LEN_MAX)) {
+        return -EINVAL;
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(msgs); i++) {
+        if (0 == msgs[i].len) {
+            idx = (idx < 0) ? i : idx;
+        } else if ((REPORT_QUEUE_PRIO_POSITION == prio) && (REPORT_QUEUE_PRIO_POSITION == msgs[i].prio)) {
+            /* Only the newest periodic position is worth sending */
+            idx = i;
+            break;
+        }
+    }
+
+    if (idx < 0) {
+        idx = report_queue_find(true);
+        if (msgs[idx].prio > prio) {
+            return -ENOMEM;
+        }
+    }
+
+    if (0 != msgs[idx].len) {
+        LOG_INF("Report %u superseded", msgs[idx].seq);
+        report_queue_drop(idx);
+        key = k_spin_lock(&stats_lock);
+        stats.coalesced++;
+        k_spin_unlock(&stats_lock, key);
+    }
+
+    msgs[idx].seq = next_seq++;
+    msgs[idx].prio = prio;
+    msgs[idx].logged = (NULL != log);
+    if (NULL != log) {
+        msgs[idx].log = *log;
+    }
+    msgs[idx].len = len;
+    memcpy(msgs[idx].data, data, len);
+
+    report_queue_save(idx);
+    report_queue_count_update();
+
+    return 0;
+} /* report_queue_put */
+
+
+int report_queue_flush(void)
+{
+    struct report_batch_log log;
+    int cnt = 0;
+    int idx;
+    int retval = 0;
+    k_spinlock_key_t key;
+
+    if (atomic_cas(&link_up, 1, 0)) {
+        backoff = 0;
+        retry_at = 0;
+        k_timer_stop(&report_queue_timer);
+    }
+
+    if (k_uptime_get() < retry_at) {
+        return 0;
+    }
+
+    for (idx = report_queue_find(false); idx >= 0; idx = report_queue_find(false)) {
+        retval = report_sink_send(msgs[idx].data, msgs[idx].len);
+        if (0 != retval) {
+            break;
+        }
+
+        /* The fixes it read from the track log are only done with now */
+        if (msgs[idx].logged) {
+            log = msgs[idx].log;
+            report_batch_log_sent(&log);
+        }
+        msgs[idx].len = 0;
+        attempts[idx] = 0;
+        report_queue_save(idx);
+        backoff = 0;
+        cnt++;
+    }
+
+    if (idx >= 0) {
+        backoff = (0 == backoff) ? CONFIG_REPORT_QUEUE_BACKOFF_MIN : MIN(backoff * 2, CONFIG_REPORT_QUEUE_BACKOFF_MAX);
+        retry_at = k_uptime_get() + backoff * MSEC_PER_SEC;
+        k_timer_start(&report_queue_timer, K_SECONDS(backoff), K_NO_WAIT);
+        LOG_WRN("%s: Report %u not sent, retval: %d, retry in %u s", __func__, msgs[idx].seq, retval, backoff);
+
+        key = k_spin_lock(&stats_lock);
+        stats.retries++;
+        k_spin_unlock(&stats_lock, key);
+
+        /* A report that keeps failing must not hold back the ones behind it */
+        if (++attempts[idx] >= CONFIG_REPORT_QUEUE_SEND_ATTEMPTS) {
+            LOG_WRN("%s: Report %u dropped after %u attempts", __func__, msgs[idx].seq, attempts[idx]);
+            report_queue_drop(idx);
+            report_queue_save(idx);
+
+            key = k_spin_lock(&stats_lock);
+            stats.dropped++;
+            k_spin_unlock(&stats_lock, key);
+        }
+    }
+
+    report_queue_count_update();
+
+    return cnt;
+} /* report_queue_flush */
+
+
+void report_queue_link_up(void)
+{
+    atomic_set(&link_up, 1);
+    event_bus_post(APP_EVENT_REPORT_RETRY);
+}
+
+
+void report_queue_stats_get(struct report_queue_stats *stats_out)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    *stats_out = stats;
+
+    k_spin_unlock(&stats_lock, key);
+}
@@ -0,0 +1,86 @@
+#ifndef REPORT_QUEUE_H
+#define REPORT_QUEUE_H
+
+#include <zephyr.h>
+
+#include "src/lib/position_codec.h"
+#include "src/report/report_batch.h"
+
+/* Largest message in the queue, a binary batch [bytes] */
+#define REPORT_QUEUE_MSG_LEN_MAX    POSITION_CODEC_SIZE_FOR_TEXT(REPORT_BATCH_TEXT_LEN_MAX)
+
+/** @brief Priority of a queued report, higher priorities are sent first and evicted last. */
+enum report_queue_prio {
+    /** Periodic position, superseded by the next one while it waits. */
+    REPORT_QUEUE_PRIO_POSITION,
+    /** Position with movement, kept until it is sent or the queue is full of alerts. */
+    REPORT_QUEUE_PRIO_ALERT,
+};
+
+/** @brief Queue statistics. */
+struct report_queue_stats {
+    /** Number of reports waiting. */
+    uint32_t count;
+    /** Number of reports dropped because a newer report superseded them or the queue was full. */
+    uint32_t coalesced;
+    /** Number of send attempts that failed. */
+    uint32_t retries;
+    /** Number of reports dropped after CONFIG_REPORT_QUEUE_SEND_ATTEMPTS failed sends. */
+    uint32_t dropped;
+    /** Current back-off [s], 0 if sending is not backed off. */
+    uint32_t backoff;
+};
+
+/*
+ * Outbound queue of the reports. Reports wait in the queue, which is kept in settings over a reset with
+ *   CONFIG_REPORT_QUEUE_PERSISTENT, until report_sink_send() succeeds. After a fail the queue backs off exponentially
+ *   from CONFIG_REPORT_QUEUE_BACKOFF_MIN to CONFIG_REPORT_QUEUE_BACKOFF_MAX, or until the LTE link registers again. A
+ *   report is dropped after CONFIG_REPORT_QUEUE_SEND_ATTEMPTS failed sends. The track log fixes of a report are handed
+ *   back with report_batch_log_sent() when it is sent, and a report that is superseded or dropped is handed back with
+ *   report_batch_dropped(). Not thread safe except for report_queue_link_up() and report_queue_stats_get(), all
+ *   other calls must come from the same thread.
+ */
+
+/**
+ * @brief Load the queued reports from settings
+ *
+ * @return int 0 on success, negative on fail
+ */
+int report_queue_init(void);
+
+/**
+ * @brief Queue a report. A periodic position supersedes a waiting one. If the queue is full the oldest report with
+ *   the lowest priority not above prio is dropped.
+ *
+ * @param prio the priority
+ * @param data the report
+ * @param len length of the report, at most REPORT_QUEUE_MSG_LEN_MAX
+ * @param log track log fixes in the report, handed back when the report is sent or dropped, NULL if the report has no
+ *   fixes from the track log
+ * @return int 0 on success, -ENOMEM if the queue is full of reports with a higher priority, negative on other fails
+ */
+int report_queue_put(enum report_queue_prio prio, const uint8_t *data, size_t len, const struct report_batch_log *log);
+
+/**
+ * @brief Send the queued reports, highest priority and oldest first, unless sending is backed off. Stops at the first
+ *   fail and starts the back-off timer, which posts APP_EVENT_REPORT_RETRY when it expires.
+ *
+ * @return int number of reports sent
+ */
+int report_queue_flush(void);
+
+/**
+ * @brief End the back-off and post APP_EVENT_REPORT_RETRY, called when the LTE link registers. Can be called from any
+ *   context.
+ *
+ */
+void report_queue_link_up(void);
+
+/**
+ * @brief Get the queue statistics
+ *
+ * @param stats where the statistics are stored
+ */
+void report_queue_stats_get(struct report_queue_stats *stats);
+
+#endif /* REPORT_QUEUE_H */
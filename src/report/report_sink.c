@@ -0,0 +1,296 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <stdio.h>
+#include <modem/lte_lc.h>
+
+#include "src/report/report_batch.h"
+#include "src/report/report_queue.h"
+#include "src/report/report_sink.h"
+#if defined(CONFIG_COAP_REPORT)
+#include "src/coap/coap_report.h"
+#endif
+#if defined(CONFIG_SMS)
+#include "src/sms/sms.h"
+#endif
+
+#define MODULE  report_sink
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_REPORT_LOG_LEVEL);
+
+/* Bits in link_state */
+#define REPORT_LINK_REGISTERED  0
+#define REPORT_LINK_IP          1
+
+/* Length of the base64 text of _len bytes */
+#define REPORT_SINK_BASE64_LEN(_len)    ((((_len) + 2) / 3) * 4)
+
+struct report_sink {
+    const char *name;
+    /** Sent even when it failed recently, as the last resort. */
+    bool fallback;
+    /**
+     * @brief Check if the transport can send a report
+     *
+     * @param link the link state, REPORT_LINK_* bits
+     * @param len length of the report
+     * @return true if it can
+     */
+    bool (*available)(uint32_t link, size_t len);
+    /**
+     * @brief Estimate the radio time of sending a report
+     *
+     * @param len length of the report
+     * @return uint32_t the radio time [ms]
+     */
+    uint32_t (*cost)(size_t len);
+    /**
+     * @brief Get the radio time of a report that was sent
+     *
+     * @param len length of the report
+     * @param time measured time of the send [ms]
+     * @return uint32_t the radio time [ms]
+     */
+    uint32_t (*radio_time)(size_t len, uint32_t time);
+    int (*send)(const uint8_t *data, size_t len);
+};
+
+#if defined(CONFIG_COAP_REPORT)
+
+static bool report_sink_coap_available(uint32_t link, size_t len)
+{
+    return (link & BIT(REPORT_LINK_REGISTERED)) && (link & BIT(REPORT_LINK_IP)) &&
+           (len <= COAP_REPORT_PAYLOAD_LEN_MAX);
+}
+
+
+static uint32_t report_sink_coap_cost(size_t len)
+{
+    /* The report and its ACK are one datagram each, the exchange is followed by the inactivity tail */
+    return CONFIG_ENERGY_LTE_COAP_EXCHANGE_TIME + CONFIG_ENERGY_LTE_COAP_TIME;
+}
+
+
+static uint32_t report_sink_coap_radio_time(size_t len, uint32_t time)
+{
+    /* The exchange as measured, and the inactivity tail after it */
+    return time + CONFIG_ENERGY_LTE_COAP_TIME;
+}
+
+
+#endif /* if defined(CONFIG_COAP_REPORT) */
+
+#if defined(CONFIG_SMS)
+
+static bool report_sink_sms_available(uint32_t link, size_t len)
+{
+    /* The modem tries to register when a SMS is sent, so the link state is not checked */
+    return REPORT_SINK_BASE64_LEN(len) <= REPORT_BATCH_TEXT_LEN_MAX;
+}
+
+
+static uint32_t report_sink_sms_cost(size_t len)
+{
+    size_t text_len = REPORT_SINK_BASE64_LEN(len);
+    uint32_t segments = (text_len <= 160) ? 1 : ((text_len + 152) / 153);
+
+    return segments * CONFIG_ENERGY_LTE_SMS_TIME;
+}
+
+
+static uint32_t report_sink_sms_radio_time(size_t len, uint32_t time)
+{
+    /* The send returns when the modem has the SMS, before it is on air */
+    return report_sink_sms_cost(len);
+}
+
+
+#endif /* if defined(CONFIG_SMS) */
+
+static const struct report_sink sinks[REPORT_TRANSPORT_CNT] = {
+#if defined(CONFIG_COAP_REPORT)
+    [REPORT_TRANSPORT_COAP] = { "coap", false, report_sink_coap_available, report_sink_coap_cost,
+                                report_sink_coap_radio_time, coap_report_send },
+#endif
+#if defined(CONFIG_SMS)
+    [REPORT_TRANSPORT_SMS] = { "sms", true, report_sink_sms_available, report_sink_sms_cost,
+                               report_sink_sms_radio_time, sms_report_send },
+#endif
+};
+
+static atomic_t link_state;
+
+/* Only changed from the thread that sends the reports */
+static int64_t retry_at[REPORT_TRANSPORT_CNT];
+
+static struct k_spinlock stats_lock;
+static struct report_sink_stats stats[REPORT_TRANSPORT_CNT];
+/* Charge per transport [nA * ms], kept in full so small sends add up */
+static uint64_t charge[REPORT_TRANSPORT_CNT];
+
+static void report_sink_lte_handler(const struct lte_lc_evt *const evt)
+{
+    bool registered;
+
+    switch (evt->type) {
+        case LTE_LC_EVT_NW_REG_STATUS:
+            registered = (LTE_LC_NW_REG_REGISTERED_HOME == evt->nw_reg_status) ||
+                         (LTE_LC_NW_REG_REGISTERED_ROAMING == evt->nw_reg_status);
+            /* Reports waiting for coverage are sent right away instead of after the back-off */
+            if (registered && !atomic_test_and_set_bit(&link_state, REPORT_LINK_REGISTERED)) {
+                report_queue_link_up();
+            } else if (!registered) {
+                atomic_clear_bit(&link_state, REPORT_LINK_REGISTERED);
+            }
+            break;
+        case LTE_LC_EVT_LTE_MODE_UPDATE:
+            /* LTE-M and NB-IoT both attach with a default PDN */
+            atomic_set_bit_to(&link_state, REPORT_LINK_IP, LTE_LC_LTE_MODE_NONE != evt->lte_mode);
+            break;
+        default:
+            break;
+    }
+}
+
+
+/**
+ * @brief Add a send to the statistics of a transport
+ *
+ * @param transport the transport
+ * @param result the result of the send, 0 on success
+ * @param len length of the report
+ * @param time time spent sending [ms]
+ */
+static void report_sink_stats_add(enum report_transport transport, int result, size_t len, uint32_t time)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    /* Only reports that were sent are charged, their radio time is known */
+    if (0 == result) {
+        stats[transport].sent++;
+        stats[transport].bytes += len;
+        charge[transport] += (uint64_t)sinks[transport].radio_time(len, time) * CONFIG_ENERGY_CURRENT_LTE;
+    } else {
+        stats[transport].failed++;
+    }
+    stats[transport].time += time;
+    stats[transport].time_max = MAX(stats[transport].time_max, time);
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+
+int report_sink_init(void)
+{
+    int retval = 0;
+    enum lte_lc_nw_reg_status status;
+    enum lte_lc_lte_mode mode;
+
+    lte_lc_register_handler(report_sink_lte_handler);
+
+    /* The link may have come up before the handler was registered */
+    retval = lte_lc_nw_reg_status_get(&status);
+    if (0 == retval) {
+        atomic_set_bit_to(&link_state, REPORT_LINK_REGISTERED,
+          (LTE_LC_NW_REG_REGISTERED_HOME == status) || (LTE_LC_NW_REG_REGISTERED_ROAMING == status));
+    }
+
+    retval |= lte_lc_lte_mode_get(&mode);
+    if (0 == retval) {
+        atomic_set_bit_to(&link_state, REPORT_LINK_IP, LTE_LC_LTE_MODE_NONE != mode);
+    }
+
+    if (0 != retval) {
+        LOG_WRN("%s: Failed to get the link state, retval: %d", __func__, retval);
+    }
+
+    return retval;
+}
+
+
+int report_sink_send(const uint8_t *data, size_t len)
+{
+    int retval = -ENETUNREACH;
+    uint32_t link = (uint32_t)atomic_get(&link_state);
+    uint32_t tried = 0;
+    uint32_t cost;
+    uint32_t best_cost = 0;
+    uint32_t start;
+    int best;
+
+    while (1) {
+        best = -1;
+        for (int i = 0; i < REPORT_TRANSPORT_CNT; i++) {
+            if ((NULL == sinks[i].send) || (tried & BIT(i)) || !sinks[i].available(link, len) ||
+              (!sinks[i].fallback && (k_uptime_get() < retry_at[i])))
+            {
+                continue;
+            }
+
+            cost = sinks[i].cost(len);
+            if ((best < 0) || (cost < best_cost)) {
+                best = i;
+                best_cost = cost;
+            }
+        }
+
+        if (best < 0) {
+            break;
+        }
+        tried |= BIT(best);
+
+        start = k_uptime_get_32();
+        retval = sinks[best].send(data, len);
+        report_sink_stats_add(best, retval, len, k_uptime_get_32() - start);
+        if (0 == retval) {
+            LOG_INF("Report of %zu bytes sent over %s", len, sinks[best].name);
+            break;
+        }
+
+        LOG_WRN("%s: Failed to send over %s, retval: %d", __func__, sinks[best].name, retval);
+        retry_at[best] = k_uptime_get() + CONFIG_REPORT_SINK_FAIL_BACKOFF * MSEC_PER_SEC;
+    }
+
+    return retval;
+} /* report_sink_send */
+
+
+void report_sink_stats_get(enum report_transport transport, struct report_sink_stats *stats_out)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    *stats_out = stats[transport];
+    /* 1 uAh is 3.6e9 nA * ms */
+    stats_out->charge = (uint32_t)(charge[transport] / 3600000000ULL);
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+
+int report_sink_text_get(char *str, size_t str_size)
+{
+    struct report_sink_stats sink_stats;
+    struct report_queue_stats queue_stats;
+    uint32_t link = (uint32_t)atomic_get(&link_state);
+    int len = 0;
+
+    len += snprintf(str, str_size, "Uplink\nLTE: %s%s", (link & BIT(REPORT_LINK_REGISTERED)) ? "reg" : "-",
+        (link & BIT(REPORT_LINK_IP)) ? ",ip" : "");
+    for (int i = 0; (i < REPORT_TRANSPORT_CNT) && ((size_t)len < str_size); i++) {
+        if (NULL == sinks[i].send) {
+            continue;
+        }
+        report_sink_stats_get(i, &sink_stats);
+        len += snprintf(&str[len], str_size - len, "\n%s: %u/%u %uB %u/%ums %uuAh", sinks[i].name, sink_stats.sent,
+          sink_stats.failed, sink_stats.bytes, sink_stats.time / MAX(sink_stats.sent + sink_stats.failed, 1),
+          sink_stats.time_max, sink_stats.charge);
+    }
+
+    report_queue_stats_get(&queue_stats);
+    if ((size_t)len < str_size) {
+        len += snprintf(&str[len], str_size - len, "\nQueue: %u, %u superseded, %u retries, %u dropped, %u s",
+          queue_stats.count, queue_stats.coalesced, queue_stats.retries, queue_stats.dropped, queue_stats.backoff);
+    }
+
+    return MIN((size_t)len, str_size - 1);
+} /* report_sink_text_get */
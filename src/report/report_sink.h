@@ -0,0 +1,67 @@
+#ifndef REPORT_SINK_H
+#define REPORT_SINK_H
+
+#include <zephyr.h>
+
+/** @brief Transports a report can be sent over, cheapest first when the link allows it. */
+enum report_transport {
+    /** Binary CoAP POST over UDP, needs CONFIG_COAP_REPORT and an IP bearer. */
+    REPORT_TRANSPORT_COAP,
+    /** base64 text SMS to CONFIG_SMS_SEND_PHONE_NUMBER, the fallback when nothing else works. */
+    REPORT_TRANSPORT_SMS,
+    REPORT_TRANSPORT_CNT,
+};
+
+/** @brief Statistics of one transport. */
+struct report_sink_stats {
+    /** Number of reports sent. */
+    uint32_t sent;
+    /** Number of failed sends. */
+    uint32_t failed;
+    /** Payload sent [bytes]. */
+    uint32_t bytes;
+    /** Total time spent sending, including failed sends [ms]. */
+    uint32_t time;
+    /** Longest time spent sending [ms]. */
+    uint32_t time_max;
+    /** Estimated charge used by the radio for the reports sent [uAh]. */
+    uint32_t charge;
+};
+
+/**
+ * @brief Start tracking the LTE link state. Must be called before the first report is sent.
+ *
+ * @return int 0 on success, negative on fail
+ */
+int report_sink_init(void);
+
+/**
+ * @brief Send a report over the cheapest transport that is available for the current link state and the size of the
+ *   report. If the send fails, the next cheapest transport is tried, ending with SMS. A transport that failed is
+ *   skipped for CONFIG_REPORT_SINK_FAIL_BACKOFF seconds, except for SMS.
+ *
+ * @param data the binary report
+ * @param len length of the report
+ * @return int 0 on success, negative if no transport could send the report
+ */
+int report_sink_send(const uint8_t *data, size_t len);
+
+/**
+ * @brief Get the statistics of a transport
+ *
+ * @param transport the transport
+ * @param stats where the statistics are stored
+ */
+void report_sink_stats_get(enum report_transport transport, struct report_sink_stats *stats);
+
+/**
+ * @brief Encode the link state and the statistics of the enabled transports as text, one line per transport with
+ *   sent/failed reports, bytes, mean/max send time [ms] and charge [uAh], followed by the outbound queue
+ *
+ * @param str where the NUL terminated text is stored
+ * @param str_size size of str
+ * @return int length of the text
+ */
+int report_sink_text_get(char *str, size_t str_size);
+
+#endif /* REPORT_SINK_H */
@@ -1,37 +1,127 @@
+#include <stdarg.h>
 #include <stdio.h>
 #include <zephyr.h>
 #include <modem/lte_lc.h>
 #include <zephyr/kernel.h>
 #include <string.h>
 #include <modem/sms.h>
+#include <zephyr/sys/base64.h>
+#include "src/energy/energy.h"
+#if defined(CONFIG_MOVEMENT_CLASSIFIER)
+#include "src/movement/motion_class.h"
+#endif
+#include "src/movement/movement_profile.h"
+#include "src/positioning/gnss_schedule.h"
 #include "src/positioning/positioning.h"
-
+#if defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+#include "src/positioning/ttff_test.h"
+#endif
+#include "src/report/report_batch.h"
+#include "src/report/report_sink.h"
+#include "src/sms/sms.h"
+#include "src/sms/sms_cmd.h"
+#include "src/sms/sms_concat.h"
+
+#include "src/lib/app_latency.h"
 #include "src/lib/common_events.h"
+#include "src/lib/event_bus.h"
+#include "src/lib/instr.h"
+#include "src/lib/wakeup.h"
 
 #define MODULE  sms_module
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(MODULE, CONFIG_SMS_LOG_LEVEL);
 
+/* Longest text of the "Stats" reply, sent as concatenated segments of 153 characters */
+#define SMS_STATS_TEXT_LEN_MAX  (3 * 153)
+
+#if defined(CONFIG_SMS_SEND_CONCATENATED_MSG_MAX_CNT)
+BUILD_ASSERT(CONFIG_SMS_SEND_CONCATENATED_MSG_MAX_CNT >= 3, "The Stats SMS spans three SMS segments");
+#endif
+
+/* Longest text kept of a received SMS, longer texts are cut */
+#define SMS_RX_TEXT_LEN_MAX     160
+
+/** @brief A received SMS, copied out of the modem library callback. */
+struct sms_rx_msg {
+    /** Cycle counter when the callback was entered. */
+    uint32_t start;
+    enum sms_type type;
+    struct sms_deliver_header header;
+    /** Length of the payload as received. */
+    int payload_len;
+    /** Length of text. */
+    uint16_t text_len;
+    char text[SMS_RX_TEXT_LEN_MAX + 1];
+};
+
+K_MSGQ_DEFINE(sms_rx_msgq, sizeof(struct sms_rx_msg), CONFIG_SMS_RX_QUEUE_SIZE, 4);
+
+/* Received SMS that did not fit in sms_rx_msgq */
+static atomic_t sms_rx_dropped;
+
 /**
- * @brief Send a sms with current position and voltage level of the device
+ * @brief Send a text SMS to CONFIG_SMS_SEND_PHONE_NUMBER
  *
+ * @param str the NUL terminated text
  * @return int 0 on success, negative on fail
  */
-static int sms_app_data_send(void)
+static int sms_app_text_send(const char *str)
 {
-    char str[150];
-    float latitude, longitude, altitude, accuracy;
-    int voltage_level;
+    int retval = 0;
 
-    if (0 != positioning_data_get(&latitude, &longitude, &altitude, &accuracy, &voltage_level)) {
-        return -1;
+    INSTR_BEGIN(INSTR_SMS_SEND);
+    retval = sms_send_text(CONFIG_SMS_SEND_PHONE_NUMBER, str);
+    INSTR_END(INSTR_SMS_SEND);
+
+#if defined(CONFIG_ENERGY)
+    /* A SMS the modem did not accept was never on air */
+    if (0 == retval) {
+        energy_time_add(ENERGY_LTE, CONFIG_ENERGY_LTE_SMS_TIME);
+    }
+#endif
+
+    return retval;
+}
+
+
+int sms_report_send(const uint8_t *data, size_t len)
+{
+    char str[REPORT_BATCH_TEXT_LEN_MAX + 1];
+    size_t str_len = 0;
+    int retval = 0;
+
+    retval = base64_encode((uint8_t *)str, sizeof(str), &str_len, data, len);
+    if (0 != retval) {
+        return retval;
     }
 
-    sprintf(str, "Latitude: %f\nLongitude: %f\nAltitude: %f\nAccuracy: %f\nVoltage level: %d", latitude, longitude,
-      altitude, accuracy, voltage_level);
+    return sms_app_text_send(str);
+}
+
+
+/**
+ * @brief Append a line to a text, formatted like printf. Nothing is appended once the text is full.
+ *
+ * @param str the NUL terminated text
+ * @param str_size size of str
+ * @param len length of the text, updated with the length appended
+ * @param fmt printf format of the line
+ */
+static void sms_text_append(char *str, size_t str_size, int *len, const char *fmt, ...)
+{
+    va_list args;
+
+    if ((size_t)*len >= str_size - 1) {
+        return;
+    }
 
-    return sms_send_text(CONFIG_SMS_SEND_PHONE_NUMBER, str);
+    va_start(args, fmt);
+    *len += vsnprintf(&str[*len], str_size - *len, fmt, args);
+    va_end(args);
+
+    *len = MIN((size_t)*len, str_size - 1);
 }
 
 
@@ -42,48 +132,185 @@ static int sms_app_data_send(void)
  */
 static int sms_app_log_send(void)
 {
-    char str[150] = { 0 };
-    uint32_t events = k_event_wait(&app_events, -1, 0, K_NO_WAIT);
+    char str[160] = { 0 };
+    int len = 0;
+    uint32_t events = app_events_get();
+    struct event_bus_stats stats;
+    struct report_batch_stats batch_stats;
+    struct app_latency_stats latency;
+    uint32_t hours = MAX(k_uptime_get() / (MSEC_PER_SEC * 3600), 1);
 
     if (events & APP_EVENT_APPLICATION_INITIALIZED) {
-        sprintf(str, "Tracker idle");
+        event_bus_total_stats_get(&stats);
+        report_batch_stats_get(&batch_stats);
+        app_latency_stats_get(&latency);
+        len = snprintf(str, sizeof(str), "Tracker idle\nWakeups: %u (%u/h)\nDropped events: %u\n"
+          "Batches: %u\nBatched fixes: %u\nMax batch: %u\nLatency [s]: %u/%u/%u", stats.wakeups,
+          stats.wakeups / hours, stats.dropped, batch_stats.batches, batch_stats.fixes,
+          batch_stats.max_size, latency.last[APP_LATENCY_GNSS_START] / MSEC_PER_SEC,
+          latency.last[APP_LATENCY_FIX] / MSEC_PER_SEC, latency.last[APP_LATENCY_SENT] / MSEC_PER_SEC);
+#if defined(CONFIG_WAKEUP_STATS)
+        if ((size_t)len < sizeof(str)) {
+            snprintf(&str[len], sizeof(str) - len, "\nCPU wakeups: %u/h", wakeup_cpu_count_get() / hours);
+        }
+#endif
     } else {
         sprintf(str, "Device not initialized!");
     }
 
-    return sms_send_text(CONFIG_SMS_SEND_PHONE_NUMBER, str);
+    return sms_app_text_send(str);
 }
 
 
 /**
- * @brief
+ * @brief Send the module statistics and the instrumentation counters, and print the counters with the RAM ring on
+ *   the console
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int sms_app_stats_send(void)
+{
+    char str[SMS_STATS_TEXT_LEN_MAX + 1] = { 0 };
+    int len = 0;
+    struct positioning_event_stats gnss_events;
+    struct gnss_schedule_stats schedule;
+#if defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+    struct ttff_test_stats ttff;
+#endif
+#if defined(CONFIG_MOVEMENT_CLASSIFIER)
+    struct motion_class_stats motion;
+#endif
+
+    positioning_event_stats_get(&gnss_events);
+    gnss_schedule_stats_get(&schedule);
+
+    sms_text_append(str, sizeof(str), &len, "Stats");
+    sms_text_append(str, sizeof(str), &len, "\nGNSS events: %u (coalesced %u, dropped %u, max queued %u)",
+      gnss_events.received, gnss_events.coalesced, gnss_events.dropped, gnss_events.high_watermark);
+    sms_text_append(str, sizeof(str), &len, "\nGNSS searches: %u (timeouts %u, fixes %u, on %u s, next in %u s)",
+      schedule.searches, schedule.timeouts, schedule.fixes, (uint32_t)(schedule.on_time / MSEC_PER_SEC), schedule.interval);
+#if defined(CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST)
+    ttff_test_stats_get(&ttff);
+    if (ttff.cnt > 0) {
+        sms_text_append(str, sizeof(str), &len, "\nTTFF [ms]: %u tests, %u/%u/%u", ttff.cnt, ttff.ttff_min,
+          (uint32_t)(ttff.ttff_sum / ttff.cnt), ttff.ttff_max);
+    }
+#endif
+#if defined(CONFIG_MOVEMENT_CLASSIFIER)
+    /* The triggers that did not lead to a GNSS request are the false triggers the classifier saved */
+    motion_class_stats_get(&motion);
+    sms_text_append(str, sizeof(str), &len, "\nMotion: %u triggers (false %u), %u requests, still/handled/walk/vehicle "
+      "%u/%u/%u/%u", motion.triggers, (motion.triggers > motion.requests) ? motion.triggers - motion.requests : 0,
+      motion.requests, motion.windows[MOTION_CLASS_STILL], motion.windows[MOTION_CLASS_HANDLED],
+      motion.windows[MOTION_CLASS_WALKING], motion.windows[MOTION_CLASS_VEHICLE]);
+#endif
+#if defined(CONFIG_SMS_CONCAT)
+    sms_text_append(str, sizeof(str), &len, "\nSMS concat dropped: %u", sms_concat_evicted_get());
+#endif
+#if defined(CONFIG_INSTR)
+    len += instr_text_get(&str[len], sizeof(str) - len);
+    instr_dump();
+#endif
+
+    return sms_app_text_send(str);
+}
+
+
+#if defined(CONFIG_ENERGY)
+
+/**
+ * @brief Send the charge used per subsystem and the projected runtime
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int sms_app_energy_send(void)
+{
+    char str[160] = { 0 };
+
+    energy_text_get(str, sizeof(str));
+
+    return sms_app_text_send(str);
+}
+
+
+#endif /* if defined(CONFIG_ENERGY) */
+
+/**
+ * @brief Send the active movement profile
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int sms_app_profile_send(void)
+{
+    char str[160] = { 0 };
+
+    movement_profile_text_get(str, sizeof(str));
+
+    return sms_app_text_send(str);
+}
+
+
+/**
+ * @brief Send the link state and the statistics per report transport
  *
- * @param data
- * @param context
+ * @return int 0 on success, negative on fail
+ */
+static int sms_app_uplink_send(void)
+{
+    char str[160] = { 0 };
+
+    report_sink_text_get(str, sizeof(str));
+
+    return sms_app_text_send(str);
+}
+
+
+/**
+ * @brief Copy a received SMS to the queue for sms_rx_thread. Runs in the modem library context, so nothing is
+ *   parsed or logged here.
+ *
+ * @param data the SMS
+ * @param context not used
  */
 static void sms_callback(struct sms_data *const data, void *context)
 {
+    struct sms_rx_msg msg;
+
     if (data == NULL) {
-        LOG_INF("%s with NULL data\n", __func__);
         return;
     }
 
+    INSTR_BEGIN(INSTR_SMS_CALLBACK);
+
+    msg.start = k_cycle_get_32();
+    msg.type = data->type;
     if (data->type == SMS_TYPE_DELIVER) {
-        /* When SMS message is received, print information */
-        struct sms_deliver_header *header = &data->header.deliver;
+        msg.header = data->header.deliver;
+    }
+    msg.payload_len = data->payload_len;
+    msg.text_len = MIN(MAX(data->payload_len, 0), SMS_RX_TEXT_LEN_MAX);
+    memcpy(msg.text, data->payload, msg.text_len);
+    msg.text[msg.text_len] = '\0';
 
-        if (header->concatenated.ref_number) {
-            ;
-        }
+    if (0 != k_msgq_put(&sms_rx_msgq, &msg, K_NO_WAIT)) {
+        atomic_inc(&sms_rx_dropped);
+    }
 
-        if (0 == strcmp("Status", data->payload)) {
-            k_event_post(&app_events, APP_EVENT_GNSS_SEARCH_REQ);
-        }
+    INSTR_END(INSTR_SMS_CALLBACK);
+} /* sms_callback */
 
-        if (0 == strcmp("Log", data->payload)) {
-            k_event_post(&app_events, APP_EVENT_SMS_LOG_SEND);
-        }
 
+/**
+ * @brief Print a received SMS and run its commands
+ *
+ * @param msg the SMS, the text is changed while the commands are parsed
+ */
+static void sms_rx_handle(struct sms_rx_msg *msg)
+{
+    struct sms_deliver_header *header = &msg->header;
+
+    if (msg->type == SMS_TYPE_DELIVER) {
+        /* When SMS message is received, print information */
         LOG_INF("\nSMS received:\n");
         LOG_INF("\tTime:   %02d-%02d-%02d %02d:%02d:%02d\n",
           header->time.year,
@@ -93,8 +320,8 @@ static void sms_callback(struct sms_data *const data, void *context)
           header->time.minute,
           header->time.second);
 
-        LOG_INF("\tText:   '%s'\n", data->payload);
-        LOG_INF("\tLength: %d\n", data->payload_len);
+        LOG_INF("\tText:   '%s'\n", msg->text);
+        LOG_INF("\tLength: %d\n", msg->payload_len);
 
         if (header->app_port.present) {
             LOG_INF("\tApplication port addressing scheme: dest_port=%d, src_port=%d\n",
@@ -107,12 +334,29 @@ static void sms_callback(struct sms_data *const data, void *context)
               header->concatenated.seq_number,
               header->concatenated.total_msgs);
         }
-    } else if (data->type == SMS_TYPE_STATUS_REPORT) {
+
+#if defined(CONFIG_SMS_CONCAT)
+        if (header->concatenated.present && (header->concatenated.total_msgs > 1)) {
+            char *text;
+            int len = sms_concat_add(k_uptime_get(), header->concatenated.ref_number,
+              header->concatenated.seq_number, header->concatenated.total_msgs, msg->text, msg->text_len, &text);
+
+            if (len < 0) {
+                LOG_INF("Concatenated SMS part dropped, retval: %d", len);
+            } else if (len > 0) {
+                sms_cmd_dispatch(text);
+                sms_concat_release(text);
+            }
+            return;
+        }
+#endif
+        sms_cmd_dispatch(msg->text);
+    } else if (msg->type == SMS_TYPE_STATUS_REPORT) {
         LOG_INF("SMS status report received\n");
     } else {
         LOG_INF("SMS protocol message with unknown type received\n");
     }
-} /* sms_callback */
+} /* sms_rx_handle */
 
 
 /**
@@ -123,6 +367,8 @@ static int sms_init()
 {
     int handle = 0;
 
+    sms_cmd_init();
+
     handle = sms_register_listener(sms_callback, NULL);
     if (0 != handle) {
         LOG_INF("sms_register_listener returned err: %d\n", handle);
@@ -133,52 +379,66 @@ static int sms_init()
 }
 
 
+EVENT_BUS_SUBSCRIBER_DEFINE(sms_subscriber,
+  APP_EVENT_SMS_LOG_SEND | APP_EVENT_SMS_STATS_SEND | APP_EVENT_SMS_ENERGY_SEND | APP_EVENT_SMS_PROFILE_SEND |
+  APP_EVENT_SMS_UPLINK_SEND);
+
 static void sms_thread(void)
 {
     int ret = 0;
-    uint32_t events = 0;
-    bool movement_triggered_send = true;
+    struct app_event evt;
 
     if (0 != sms_init()) {
         return;
     }
 
-    k_event_post(&app_events, APP_EVENT_SMS_INITIALIZED);
+    event_bus_subscribe(&sms_subscriber);
+
+    app_events_post(APP_EVENT_SMS_INITIALIZED);
     k_event_wait(&app_events, APP_EVENT_APPLICATION_INITIALIZED, 0, K_FOREVER);
 
     while (1) {
-        events = k_event_wait(&app_events, -1, 0, K_FOREVER);
-
-        if (APP_EVENT_MOVEMENT_TRIGGERED & events) {
-            if (movement_triggered_send) {
-                ret = sms_send_text(CONFIG_SMS_SEND_PHONE_NUMBER, "Movement triggered!");
-                if (0 == ret) {
-                    movement_triggered_send = false;
-                } else {
-                    LOG_INF("sms_send returned err: %d\n", ret);
+        event_bus_wait(&sms_subscriber, &evt, K_FOREVER);
+        INSTR_BEGIN(INSTR_SMS_EVENT);
+
+        switch (evt.type) {
+            case APP_EVENT_SMS_LOG_SEND:
+                ret = sms_app_log_send();
+                if (ret) {
+                    LOG_INF("%d: sms_send returned err: %d\n", __LINE__, ret);
                 }
-            }
-            k_event_set_masked(&app_events, 0, ~APP_EVENT_MOVEMENT_TRIGGERED);
-        }
-
-        if (APP_EVENT_GNSS_POSITION_FIXED & events) {
-            ret = sms_app_data_send();
-            if (ret) {
-                LOG_INF("%d: sms_send returned err: %d\n", __LINE__, ret);
-            }
-            movement_triggered_send = true;
-            k_event_set_masked(&app_events, APP_EVENT_GNSS_STOP, ~APP_EVENT_GNSS_POSITION_FIXED);
-        }
-
-        if (APP_EVENT_SMS_LOG_SEND & events) {
-            ret = sms_app_log_send();
-            if (ret) {
-                LOG_INF("%d: sms_send returned err: %d\n", __LINE__, ret);
-            }
-            k_event_set_masked(&app_events, 0, ~APP_EVENT_SMS_LOG_SEND);
+                break;
+            case APP_EVENT_SMS_STATS_SEND:
+                ret = sms_app_stats_send();
+                if (ret) {
+                    LOG_INF("%d: sms_send returned err: %d\n", __LINE__, ret);
+                }
+                break;
+#if defined(CONFIG_ENERGY)
+            case APP_EVENT_SMS_ENERGY_SEND:
+                ret = sms_app_energy_send();
+                if (ret) {
+                    LOG_INF("%d: sms_send returned err: %d\n", __LINE__, ret);
+                }
+                break;
+#endif
+            case APP_EVENT_SMS_PROFILE_SEND:
+                ret = sms_app_profile_send();
+                if (ret) {
+                    LOG_INF("%d: sms_send returned err: %d\n", __LINE__, ret);
+                }
+                break;
+            case APP_EVENT_SMS_UPLINK_SEND:
+                ret = sms_app_uplink_send();
+                if (ret) {
+                    LOG_INF("%d: sms_send returned err: %d\n", __LINE__, ret);
+                }
+                break;
+            default:
+                break;
         }
 
-        k_msleep(CONFIG_SMS_THREAD_SLEEP);
+        INSTR_END(INSTR_SMS_EVENT);
     }
 } /* sms_thread */
 
@@ -189,3 +449,54 @@ static void sms_thread(void)
 K_THREAD_DEFINE(sms_thread_id, SMS_THREAD_STACK_SIZE,
   sms_thread, NULL, NULL, NULL,
   K_PRIO_PREEMPT(SMS_THREAD_PRIORITY), 0, 0);
+
+/**
+ * @brief Get how long the receive thread may wait for the next SMS
+ *
+ * @return k_timeout_t until the next concatenated SMS with missing parts times out, K_FOREVER if there is none
+ */
+static k_timeout_t sms_rx_timeout_get(void)
+{
+#if defined(CONFIG_SMS_CONCAT)
+    int64_t next = sms_concat_expire(k_uptime_get());
+
+    if (next >= 0) {
+        return K_TIMEOUT_ABS_MS(next);
+    }
+#endif
+
+    return K_FOREVER;
+}
+
+
+static void sms_rx_thread(void)
+{
+    struct sms_rx_msg msg;
+    atomic_val_t dropped;
+
+    while (1) {
+        /* Wakes up without an SMS only to free a concatenated SMS whose missing parts never came */
+        if (0 != k_msgq_get(&sms_rx_msgq, &msg, sms_rx_timeout_get())) {
+            continue;
+        }
+
+        dropped = atomic_set(&sms_rx_dropped, 0);
+        if (0 != dropped) {
+            LOG_WRN("%ld received SMS dropped, queue full", (long)dropped);
+        }
+
+        sms_rx_handle(&msg);
+
+#if defined(CONFIG_INSTR)
+        instr_record(INSTR_SMS_RX, msg.start);
+#endif
+    }
+}
+
+
+#define SMS_RX_THREAD_STACK_SIZE    1536
+#define SMS_RX_THREAD_PRIORITY      7
+
+K_THREAD_DEFINE(sms_rx_thread_id, SMS_RX_THREAD_STACK_SIZE,
+  sms_rx_thread, NULL, NULL, NULL,
+  K_PRIO_PREEMPT(SMS_RX_THREAD_PRIORITY), 0, 0);
\ No newline at end of file
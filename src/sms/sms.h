@@ -0,0 +1,16 @@
+#ifndef SMS_H
+#define SMS_H
+
+#include <zephyr.h>
+
+/**
+ * @brief Send a binary report as a base64 text SMS to CONFIG_SMS_SEND_PHONE_NUMBER. The text is decoded with
+ *   tools/position_decode.py.
+ *
+ * @param data the report
+ * @param len length of the report, at most POSITION_CODEC_SIZE_FOR_TEXT(REPORT_BATCH_TEXT_LEN_MAX) bytes
+ * @return int 0 on success, negative on fail
+ */
+int sms_report_send(const uint8_t *data, size_t len);
+
+#endif /* SMS_H */
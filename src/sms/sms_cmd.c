@@ -0,0 +1,182 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "src/lib/event_bus.h"
+#include "src/movement/movement_profile.h"
+#include "src/sms/sms_cmd.h"
+
+#define MODULE  sms_cmd
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_SMS_LOG_LEVEL);
+
+/* Hash table slots, a power of two with room to spare so a lookup is one or two probes */
+#define SMS_CMD_SLOTS   16
+#define SMS_CMD_EMPTY   0xFF
+
+struct sms_cmd {
+    const char *name;
+    /**
+     * @brief Run the command
+     *
+     * @param args the arguments after the name, leading spaces removed, "" without arguments
+     * @return int 0 on success, negative on fail
+     */
+    int (*handler)(const char *args);
+};
+
+static int sms_cmd_status(const char *args)
+{
+    event_bus_post(APP_EVENT_GNSS_SEARCH_REQ);
+    return 0;
+}
+
+
+static int sms_cmd_log(const char *args)
+{
+    event_bus_post(APP_EVENT_SMS_LOG_SEND);
+    return 0;
+}
+
+
+static int sms_cmd_stats(const char *args)
+{
+    event_bus_post(APP_EVENT_SMS_STATS_SEND);
+    return 0;
+}
+
+
+static int sms_cmd_energy(const char *args)
+{
+    event_bus_post(APP_EVENT_SMS_ENERGY_SEND);
+    return 0;
+}
+
+
+static int sms_cmd_uplink(const char *args)
+{
+    event_bus_post(APP_EVENT_SMS_UPLINK_SEND);
+    return 0;
+}
+
+
+static int sms_cmd_profile(const char *args)
+{
+    return movement_profile_request(args);
+}
+
+
+static const struct sms_cmd cmds[] = {
+    { "Status", sms_cmd_status },
+    { "Log", sms_cmd_log },
+    { "Stats", sms_cmd_stats },
+    { "Energy", sms_cmd_energy },
+    { "Profile", sms_cmd_profile },
+    { "Uplink", sms_cmd_uplink },
+};
+
+BUILD_ASSERT(ARRAY_SIZE(cmds) < SMS_CMD_SLOTS, "The SMS command table needs an empty slot");
+
+/* Index in cmds per hash slot, SMS_CMD_EMPTY if the slot is empty */
+static uint8_t slots[SMS_CMD_SLOTS];
+
+/**
+ * @brief FNV-1a hash of a command name
+ *
+ * @param name the name
+ * @param len length of the name
+ * @return uint32_t the hash
+ */
+static uint32_t sms_cmd_hash(const char *name, size_t len)
+{
+    uint32_t hash = 2166136261U;
+
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+
+/**
+ * @brief Find a command
+ *
+ * @param name the name, not NUL terminated
+ * @param len length of the name
+ * @return const struct sms_cmd* the command, NULL if there is none with the name
+ */
+static const struct sms_cmd *sms_cmd_find(const char *name, size_t len)
+{
+    uint32_t slot = sms_cmd_hash(name, len);
+    const struct sms_cmd *cmd;
+
+    for (int i = 0; i < SMS_CMD_SLOTS; i++, slot++) {
+        if (SMS_CMD_EMPTY == slots[slot & (SMS_CMD_SLOTS - 1)]) {
+            break;
+        }
+
+        cmd = &cmds[slots[slot & (SMS_CMD_SLOTS - 1)]];
+        if ((strlen(cmd->name) == len) && (0 == strncmp(cmd->name, name, len))) {
+            return cmd;
+        }
+    }
+
+    return NULL;
+}
+
+
+void sms_cmd_init(void)
+{
+    uint32_t slot;
+
+    memset(slots, SMS_CMD_EMPTY, sizeof(slots));
+
+    for (int i = 0; i < ARRAY_SIZE(cmds); i++) {
+        slot = sms_cmd_hash(cmds[i].name, strlen(cmds[i].name));
+        while (SMS_CMD_EMPTY != slots[slot & (SMS_CMD_SLOTS - 1)]) {
+            slot++;
+        }
+        slots[slot & (SMS_CMD_SLOTS - 1)] = i;
+    }
+}
+
+
+int sms_cmd_dispatch(char *text)
+{
+    int cnt = 0;
+    int retval = 0;
+    size_t len;
+    char *args;
+    char *save = NULL;
+    const struct sms_cmd *cmd;
+
+    for (char *line = strtok_r(text, SMS_CMD_SEPARATORS, &save); NULL != line;
+      line = strtok_r(NULL, SMS_CMD_SEPARATORS, &save))
+    {
+        line += strspn(line, " ");
+        len = strcspn(line, " ");
+        if (0 == len) {
+            continue;
+        }
+
+        cmd = sms_cmd_find(line, len);
+        if (NULL == cmd) {
+            LOG_INF("Unknown command: %s", line);
+            continue;
+        }
+
+        args = line + len;
+        args += strspn(args, " ");
+
+        retval = cmd->handler(args);
+        if (0 != retval) {
+            LOG_INF("Command %s failed, retval: %d", cmd->name, retval);
+        }
+        cnt++;
+    }
+
+    return cnt;
+} /* sms_cmd_dispatch */
@@ -0,0 +1,24 @@
+#ifndef SMS_CMD_H
+#define SMS_CMD_H
+
+#include <zephyr.h>
+
+/* Separators between the commands of one message */
+#define SMS_CMD_SEPARATORS  ";\n"
+
+/**
+ * @brief Build the command lookup table
+ *
+ */
+void sms_cmd_init(void);
+
+/**
+ * @brief Run the commands in a received text. Commands are separated by SMS_CMD_SEPARATORS, each command is a name
+ *   followed by its arguments, e.g. "Log;Profile vehicle".
+ *
+ * @param text the NUL terminated text, changed while it is parsed
+ * @return int number of commands that were run
+ */
+int sms_cmd_dispatch(char *text);
+
+#endif /* SMS_CMD_H */
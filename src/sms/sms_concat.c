@@ -0,0 +1,160 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "src/sms/sms_concat.h"
+
+#define MODULE  sms_concat
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_SMS_LOG_LEVEL);
+
+struct sms_concat_slot {
+    /** Uptime of the first part [ms]. */
+    int64_t first;
+    uint16_t ref;
+    uint8_t total;
+    /** Bit per received part. */
+    uint8_t received;
+    /** The reassembled text has been handed over. */
+    bool busy;
+    uint8_t len[CONFIG_SMS_CONCAT_PARTS_MAX];
+    /** Part n is stored at offset (n - 1) * SMS_CONCAT_PART_LEN_MAX. */
+    char text[CONFIG_SMS_CONCAT_PARTS_MAX * SMS_CONCAT_PART_LEN_MAX + 1];
+};
+
+BUILD_ASSERT(CONFIG_SMS_CONCAT_PARTS_MAX <= 8, "received has one bit per part");
+
+static struct sms_concat_slot slots[CONFIG_SMS_CONCAT_SLOTS];
+/* Read from other threads for the statistics */
+static atomic_t evicted;
+
+
+/**
+ * @brief Find the slot of a concatenated SMS, or take a free one. If all slots are in use, the oldest one not handed
+ *   over is taken.
+ *
+ * @param ref reference number of the concatenated SMS
+ * @param total number of parts
+ * @return struct sms_concat_slot* the slot, NULL if all slots have been handed over
+ */
+static struct sms_concat_slot *sms_concat_slot_get(uint16_t ref, uint8_t total)
+{
+    struct sms_concat_slot *slot = NULL;
+
+    for (int i = 0; i < ARRAY_SIZE(slots); i++) {
+        if ((0 != slots[i].received) && (slots[i].ref == ref) && (slots[i].total == total)) {
+            return &slots[i];
+        }
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(slots); i++) {
+        if (slots[i].busy) {
+            continue;
+        }
+        if (0 == slots[i].received) {
+            return &slots[i];
+        }
+        if ((NULL == slot) || (slots[i].first < slot->first)) {
+            slot = &slots[i];
+        }
+    }
+
+    if (NULL != slot) {
+        LOG_WRN("Concatenated SMS %u dropped, no free slot", slot->ref);
+        slot->received = 0;
+        atomic_inc(&evicted);
+    }
+
+    return slot;
+}
+
+
+int sms_concat_add(int64_t now, uint16_t ref, uint8_t seq, uint8_t total, const char *text, uint16_t len,
+  char **out)
+{
+    struct sms_concat_slot *slot;
+    uint16_t text_len = 0;
+
+    if ((0 == seq) || (seq > total) || (total > CONFIG_SMS_CONCAT_PARTS_MAX) || (len > SMS_CONCAT_PART_LEN_MAX)) {
+        return -EINVAL;
+    }
+
+    sms_concat_expire(now);
+
+    slot = sms_concat_slot_get(ref, total);
+    if (NULL == slot) {
+        return -ENOMEM;
+    }
+
+    if (0 == slot->received) {
+        slot->first = now;
+        slot->ref = ref;
+        slot->total = total;
+    }
+
+    if (slot->received & BIT(seq - 1)) {
+        return 0;
+    }
+
+    memcpy(&slot->text[(seq - 1) * SMS_CONCAT_PART_LEN_MAX], text, len);
+    slot->len[seq - 1] = len;
+    slot->received |= BIT(seq - 1);
+
+    if (slot->received != BIT_MASK(total)) {
+        return 0;
+    }
+
+    /* Close the gaps after the parts, the text stays in the slot */
+    for (int i = 0; i < total; i++) {
+        memmove(&slot->text[text_len], &slot->text[i * SMS_CONCAT_PART_LEN_MAX], slot->len[i]);
+        text_len += slot->len[i];
+    }
+    slot->text[text_len] = '\0';
+    slot->busy = true;
+
+    *out = slot->text;
+
+    return text_len;
+} /* sms_concat_add */
+
+
+void sms_concat_release(char *text)
+{
+    for (int i = 0; i < ARRAY_SIZE(slots); i++) {
+        if (slots[i].text == text) {
+            slots[i].busy = false;
+            slots[i].received = 0;
+        }
+    }
+}
+
+
+int64_t sms_concat_expire(int64_t now)
+{
+    int64_t next = -1;
+    int64_t timeout;
+
+    for (int i = 0; i < ARRAY_SIZE(slots); i++) {
+        if ((0 == slots[i].received) || slots[i].busy) {
+            continue;
+        }
+
+        timeout = slots[i].first + CONFIG_SMS_CONCAT_TIMEOUT * MSEC_PER_SEC;
+        if (now >= timeout) {
+            LOG_WRN("Concatenated SMS %u timed out", slots[i].ref);
+            slots[i].received = 0;
+            atomic_inc(&evicted);
+        } else if ((next < 0) || (timeout < next)) {
+            next = timeout;
+        }
+    }
+
+    return next;
+}
+
+
+uint32_t sms_concat_evicted_get(void)
+{
+    return (uint32_t)atomic_get(&evicted);
+}
@@ -0,0 +1,54 @@
+#ifndef SMS_CONCAT_H
+#define SMS_CONCAT_H
+
+#include <zephyr.h>
+
+/* Longest text of one part */
+#define SMS_CONCAT_PART_LEN_MAX     160
+
+/*
+ * Reassembly of concatenated SMS. Parts are stored at their place in a fixed slot, so the reassembled text is handed
+ *   over in place. Not thread safe, all calls must come from the same thread.
+ */
+
+/**
+ * @brief Add a part of a concatenated SMS
+ *
+ * @param now current uptime [ms]
+ * @param ref reference number of the concatenated SMS
+ * @param seq sequence number of the part, starting from 1
+ * @param total number of parts
+ * @param text the text of the part, not NUL terminated
+ * @param len length of text
+ * @param out where the reassembled NUL terminated text is stored when all parts have been received. It is kept until
+ *   sms_concat_release() is called.
+ * @return int length of the reassembled text, 0 if parts are missing or the part is a duplicate, negative on fail
+ */
+int sms_concat_add(int64_t now, uint16_t ref, uint8_t seq, uint8_t total, const char *text, uint16_t len,
+  char **out);
+
+/**
+ * @brief Release a reassembled text so its slot can be reused
+ *
+ * @param text the text from sms_concat_add()
+ */
+void sms_concat_release(char *text);
+
+/**
+ * @brief Free the slots of SMS with parts missing after CONFIG_SMS_CONCAT_TIMEOUT. Called from sms_concat_add(), and
+ *   when the returned time is reached without another part.
+ *
+ * @param now current uptime [ms]
+ * @return int64_t uptime when the next SMS with missing parts times out [ms], -1 if there is none
+ */
+int64_t sms_concat_expire(int64_t now);
+
+/**
+ * @brief Get the number of concatenated SMS dropped because parts were missing after CONFIG_SMS_CONCAT_TIMEOUT or
+ *   because all slots were in use. Can be called from any thread.
+ *
+ * @return uint32_t the number of dropped SMS
+ */
+uint32_t sms_concat_evicted_get(void);
+
+#endif /* SMS_CONCAT_H */
@@ -0,0 +1,415 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+
+#include "src/track_log/track_log.h"
+
+#define MODULE  track_log
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(MODULE, CONFIG_TRACK_LOG_LOG_LEVEL);
+
+/* Each entry starts with a state word. The payload is written first and the state word last, so an entry that was
+ *   torn by a reset is neither erased nor valid and is skipped. Marking an entry as read only clears bits in the
+ *   already written state word, so every word is written at most twice between erases. Every record carries a
+ *   sequence number, so records are consumed by sequence and not by position, which changes when a sector holding
+ *   unread records is erased.
+ */
+#define TRACK_LOG_STATE_ERASED  0xFFFFFFFF
+#define TRACK_LOG_STATE_VALID   0x54524B32
+#define TRACK_LOG_STATE_READ    0x00000000
+
+struct track_log_entry {
+    uint32_t state;
+    uint32_t seq;
+    struct position_record record;
+};
+
+BUILD_ASSERT(sizeof(struct track_log_entry) % 4 == 0, "Track log entries must be word aligned");
+
+#define TRACK_LOG_ENTRIES_PER_SECTOR    (CONFIG_TRACK_LOG_SECTOR_SIZE / sizeof(struct track_log_entry))
+
+K_MSGQ_DEFINE(track_log_msgq, sizeof(struct position_record), CONFIG_TRACK_LOG_QUEUE_SIZE, 4);
+static K_MUTEX_DEFINE(track_log_mutex);
+
+static const struct flash_area *flash_area;
+static bool initialized = false;
+static uint32_t sector_cnt;
+static uint32_t slot_cnt;
+
+/* Next slot to write and oldest slot that can hold an unread record */
+static uint32_t write_idx;
+static uint32_t read_idx;
+static uint32_t record_cnt;
+static uint32_t next_seq;
+
+static atomic_t appended;
+static atomic_t dropped;
+static atomic_t overwritten;
+
+static off_t track_log_slot_offset(uint32_t idx)
+{
+    return (idx / TRACK_LOG_ENTRIES_PER_SECTOR) * CONFIG_TRACK_LOG_SECTOR_SIZE
+           + (idx % TRACK_LOG_ENTRIES_PER_SECTOR) * sizeof(struct track_log_entry);
+}
+
+
+static uint32_t track_log_slot_next(uint32_t idx)
+{
+    return (idx + 1) % slot_cnt;
+}
+
+
+static int track_log_entry_read(uint32_t idx, struct track_log_entry *entry)
+{
+    return flash_area_read(flash_area, track_log_slot_offset(idx), entry, sizeof(*entry));
+}
+
+
+static bool track_log_entry_is_erased(const struct track_log_entry *entry)
+{
+    const uint32_t *words = (const uint32_t *)entry;
+
+    for (int i = 0; i < sizeof(*entry) / sizeof(uint32_t); i++) {
+        if (TRACK_LOG_STATE_ERASED != words[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Erase a sector. Unread records in it are lost and the read position is moved past it.
+ *
+ * @param sector the sector to erase
+ * @return int 0 on success, negative on fail
+ */
+static int track_log_sector_erase(uint32_t sector)
+{
+    struct track_log_entry entry;
+    uint32_t first = sector * TRACK_LOG_ENTRIES_PER_SECTOR;
+    uint32_t lost = 0;
+
+    for (uint32_t idx = first; idx < first + TRACK_LOG_ENTRIES_PER_SECTOR; idx++) {
+        if ((0 == track_log_entry_read(idx, &entry)) && (TRACK_LOG_STATE_VALID == entry.state)) {
+            lost++;
+        }
+    }
+
+    if (lost) {
+        record_cnt -= MIN(lost, record_cnt);
+        atomic_add(&overwritten, lost);
+        LOG_WRN("%s: %u unread records overwritten", __func__, lost);
+    }
+
+    if (0 == record_cnt) {
+        read_idx = write_idx;
+    } else if ((read_idx / TRACK_LOG_ENTRIES_PER_SECTOR) == sector) {
+        read_idx = ((sector + 1) % sector_cnt) * TRACK_LOG_ENTRIES_PER_SECTOR;
+    }
+
+    return flash_area_erase(flash_area, sector * CONFIG_TRACK_LOG_SECTOR_SIZE, CONFIG_TRACK_LOG_SECTOR_SIZE);
+} /* track_log_sector_erase */
+
+
+/**
+ * @brief Write a record to the next free slot. The sector after a full sector is erased right away so there is
+ *   always an erased sector marking the end of the log after a reset.
+ *
+ * @param record the record to write
+ * @return int 0 on success, negative on fail
+ */
+static int track_log_entry_write(const struct position_record *record)
+{
+    int retval = 0;
+    struct track_log_entry entry;
+    uint32_t state = TRACK_LOG_STATE_VALID;
+    off_t offset = track_log_slot_offset(write_idx);
+
+    /* Only happens if a reset hit the erase of the next sector */
+    if (0 == (write_idx % TRACK_LOG_ENTRIES_PER_SECTOR)) {
+        retval = track_log_entry_read(write_idx, &entry);
+        if ((0 == retval) && !track_log_entry_is_erased(&entry)) {
+            retval = track_log_sector_erase(write_idx / TRACK_LOG_ENTRIES_PER_SECTOR);
+        }
+        if (0 != retval) {
+            return retval;
+        }
+    }
+
+    entry.seq = next_seq++;
+    entry.record = *record;
+
+    retval = flash_area_write(flash_area, offset + sizeof(entry.state), &entry.seq,
+      sizeof(entry) - sizeof(entry.state));
+    retval |= flash_area_write(flash_area, offset, &state, sizeof(state));
+    if (0 != retval) {
+        /* Skip the slot, it is ignored as a torn entry when reading */
+        write_idx = track_log_slot_next(write_idx);
+        return retval;
+    }
+
+    if (0 == record_cnt) {
+        read_idx = write_idx;
+    }
+    record_cnt++;
+    atomic_inc(&appended);
+
+    write_idx = track_log_slot_next(write_idx);
+    if (0 == (write_idx % TRACK_LOG_ENTRIES_PER_SECTOR)) {
+        retval = track_log_sector_erase(write_idx / TRACK_LOG_ENTRIES_PER_SECTOR);
+    }
+
+    return retval;
+} /* track_log_entry_write */
+
+
+/**
+ * @brief Recover the write position, read position, number of unread records and next sequence number from flash
+ *
+ * @return int 0 on success, negative on fail
+ */
+static int track_log_scan(void)
+{
+    int retval = 0;
+    struct track_log_entry entry;
+    bool prev_erased;
+    bool erased;
+
+    retval = track_log_entry_read(slot_cnt - 1, &entry);
+    if (0 != retval) {
+        return retval;
+    }
+    prev_erased = track_log_entry_is_erased(&entry);
+
+    /* The log ends at the first erased slot that follows a written slot */
+    write_idx = 0;
+    for (uint32_t idx = 0; idx < slot_cnt; idx++) {
+        retval = track_log_entry_read(idx, &entry);
+        if (0 != retval) {
+            return retval;
+        }
+
+        erased = track_log_entry_is_erased(&entry);
+        if (erased && !prev_erased) {
+            write_idx = idx;
+            break;
+        }
+        prev_erased = erased;
+    }
+
+    /* The oldest unread record is the first valid one after the end of the log, the newest record holds the last
+     *   sequence number used
+     */
+    record_cnt = 0;
+    read_idx = write_idx;
+    next_seq = 0;
+    for (uint32_t i = 0, idx = write_idx; i < slot_cnt; i++, idx = track_log_slot_next(idx)) {
+        retval = track_log_entry_read(idx, &entry);
+        if (0 != retval) {
+            return retval;
+        }
+
+        if (TRACK_LOG_STATE_VALID == entry.state) {
+            if (0 == record_cnt) {
+                read_idx = idx;
+            }
+            record_cnt++;
+        }
+
+        if ((TRACK_LOG_STATE_VALID == entry.state) || (TRACK_LOG_STATE_READ == entry.state)) {
+            next_seq = entry.seq + 1;
+        }
+    }
+
+    return 0;
+} /* track_log_scan */
+
+
+static int track_log_init(void)
+{
+    int retval = 0;
+
+    retval = flash_area_open(FLASH_AREA_ID(track_log), &flash_area);
+    if (0 != retval) {
+        LOG_ERR("%s: Failed to open flash area, retval: %d", __func__, retval);
+        return retval;
+    }
+
+    sector_cnt = flash_area->fa_size / CONFIG_TRACK_LOG_SECTOR_SIZE;
+    if (sector_cnt < 2) {
+        LOG_ERR("%s: The track log needs at least two sectors", __func__);
+        return -EINVAL;
+    }
+    slot_cnt = sector_cnt * TRACK_LOG_ENTRIES_PER_SECTOR;
+
+    retval = track_log_scan();
+    if (0 != retval) {
+        LOG_ERR("%s: Failed to scan flash area, retval: %d", __func__, retval);
+        return retval;
+    }
+
+    LOG_INF("Track log: %u unread records, %u slots", record_cnt, slot_cnt);
+
+    return 0;
+} /* track_log_init */
+
+
+int track_log_append(const struct position_record *record)
+{
+    if (0 != k_msgq_put(&track_log_msgq, record, K_NO_WAIT)) {
+        atomic_inc(&dropped);
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Read the oldest unread records without removing them from the log
+ *
+ * @param from sequence number of the first record to read, NULL to read from the oldest unread record
+ * @param records where the records are stored
+ * @param max_cnt maximum number of records to read
+ * @return int number of records read, negative on fail
+ */
+static int track_log_records_read(const uint32_t *from, struct track_log_record *records, size_t max_cnt)
+{
+    int retval = 0;
+    int cnt = 0;
+    struct track_log_entry entry;
+
+    k_mutex_lock(&track_log_mutex, K_FOREVER);
+
+    if (!initialized) {
+        k_mutex_unlock(&track_log_mutex);
+        return -EAGAIN;
+    }
+
+    for (uint32_t idx = read_idx; (idx != write_idx) && (cnt < max_cnt) && (cnt < record_cnt);
+      idx = track_log_slot_next(idx)) {
+        retval = track_log_entry_read(idx, &entry);
+        if (0 != retval) {
+            break;
+        }
+
+        if ((TRACK_LOG_STATE_VALID == entry.state) && ((NULL == from) || ((int32_t)(entry.seq - *from) >= 0))) {
+            records[cnt].seq = entry.seq;
+            records[cnt].record = entry.record;
+            cnt++;
+        }
+    }
+
+    k_mutex_unlock(&track_log_mutex);
+
+    return (0 != retval) ? retval : cnt;
+} /* track_log_records_read */
+
+
+int track_log_read(struct track_log_record *records, size_t max_cnt)
+{
+    return track_log_records_read(NULL, records, max_cnt);
+}
+
+
+int track_log_read_from(uint32_t seq, struct track_log_record *records, size_t max_cnt)
+{
+    return track_log_records_read(&seq, records, max_cnt);
+}
+
+
+int track_log_consume(uint32_t seq)
+{
+    int retval = 0;
+    struct track_log_entry entry;
+    uint32_t state = TRACK_LOG_STATE_READ;
+
+    k_mutex_lock(&track_log_mutex, K_FOREVER);
+
+    if (!initialized) {
+        k_mutex_unlock(&track_log_mutex);
+        return -EAGAIN;
+    }
+
+    while ((read_idx != write_idx) && (record_cnt > 0)) {
+        retval = track_log_entry_read(read_idx, &entry);
+        if (0 != retval) {
+            break;
+        }
+
+        if (TRACK_LOG_STATE_VALID == entry.state) {
+            /* Newer than the last record to consume, also when the records read were overwritten meanwhile */
+            if ((int32_t)(entry.seq - seq) > 0) {
+                break;
+            }
+
+            retval = flash_area_write(flash_area, track_log_slot_offset(read_idx), &state, sizeof(state));
+            if (0 != retval) {
+                break;
+            }
+            record_cnt--;
+        }
+
+        read_idx = track_log_slot_next(read_idx);
+    }
+
+    k_mutex_unlock(&track_log_mutex);
+
+    return retval;
+} /* track_log_consume */
+
+
+void track_log_stats_get(struct track_log_stats *stats)
+{
+    k_mutex_lock(&track_log_mutex, K_FOREVER);
+    stats->count = record_cnt;
+    k_mutex_unlock(&track_log_mutex);
+
+    stats->appended = atomic_get(&appended);
+    stats->dropped = atomic_get(&dropped);
+    stats->overwritten = atomic_get(&overwritten);
+}
+
+
+/*************************************************************/
+/* Threads */
+/*************************************************************/
+
+/* Write queued records to flash, keeps flash erase and write time out of the callers */
+static void track_log_thread(void)
+{
+    int retval = 0;
+    struct position_record record;
+
+    k_mutex_lock(&track_log_mutex, K_FOREVER);
+    retval = track_log_init();
+    initialized = (0 == retval);
+    k_mutex_unlock(&track_log_mutex);
+
+    if (0 != retval) {
+        return;
+    }
+
+    while (1) {
+        k_msgq_get(&track_log_msgq, &record, K_FOREVER);
+
+        k_mutex_lock(&track_log_mutex, K_FOREVER);
+        retval = track_log_entry_write(&record);
+        k_mutex_unlock(&track_log_mutex);
+
+        if (0 != retval) {
+            LOG_ERR("%s: Failed to write record, retval: %d", __func__, retval);
+        }
+    }
+} /* track_log_thread */
+
+
+#define TRACK_LOG_THREAD_STACK_SIZE    1536
+#define TRACK_LOG_THREAD_PRIORITY      8
+
+K_THREAD_DEFINE(track_log_thread_id, TRACK_LOG_THREAD_STACK_SIZE,
+  track_log_thread, NULL, NULL, NULL,
+  K_PRIO_PREEMPT(TRACK_LOG_THREAD_PRIORITY), 0, 0);
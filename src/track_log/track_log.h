@@ -0,0 +1,71 @@
+#ifndef TRACK_LOG_H
+#define TRACK_LOG_H
+
+#include <zephyr.h>
+
+#include "src/lib/position_codec.h"
+
+/** @brief Track log statistics. */
+struct track_log_stats {
+    /** Number of unread records in the log. */
+    uint32_t count;
+    /** Number of records written to flash. */
+    uint32_t appended;
+    /** Number of appends dropped because the write queue was full. */
+    uint32_t dropped;
+    /** Number of unread records lost when the oldest sector was erased. */
+    uint32_t overwritten;
+};
+
+/** @brief A fix read from the log. */
+struct track_log_record {
+    /** Sequence number, increases by one for every record written. */
+    uint32_t seq;
+    /** The fix. */
+    struct position_record record;
+};
+
+/**
+ * @brief Queue a fix to be appended to the log. Never blocks, the flash is written from the track log thread.
+ *
+ * @param record the fix to append
+ * @return int 0 on success, -ENOMEM if the write queue is full
+ */
+int track_log_append(const struct position_record *record);
+
+/**
+ * @brief Read the oldest unread records without removing them from the log
+ *
+ * @param records where the records are stored
+ * @param max_cnt maximum number of records to read
+ * @return int number of records read, negative on fail
+ */
+int track_log_read(struct track_log_record *records, size_t max_cnt);
+
+/**
+ * @brief Read the oldest unread records from a sequence number on, without removing them from the log
+ *
+ * @param seq sequence number of the first record to read
+ * @param records where the records are stored
+ * @param max_cnt maximum number of records to read
+ * @return int number of records read, negative on fail
+ */
+int track_log_read_from(uint32_t seq, struct track_log_record *records, size_t max_cnt);
+
+/**
+ * @brief Mark the unread records up to and including a sequence number as read. Used after the records from
+ *   track_log_read() have been handled, records appended since then are kept even if the ones read were overwritten.
+ *
+ * @param seq sequence number of the last record to mark as read
+ * @return int 0 on success, negative on fail
+ */
+int track_log_consume(uint32_t seq);
+
+/**
+ * @brief Get the track log statistics
+ *
+ * @param stats where the statistics are stored
+ */
+void track_log_stats_get(struct track_log_stats *stats);
+
+#endif /* TRACK_LOG_H */
@@ -0,0 +1,128 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+#include <stdlib.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/sys/byteorder.h>
+
+/* Cycles per sample of the accelerometer threshold path, from the raw ADXL362 data registers to the threshold decision.
+ *   The integer path is the one of drivers/sensor/accelerometer.c, the float path the one it replaced: the Zephyr
+ *   driver's conversion to a sensor_value in m/s2, sensor_value_to_double() and a double threshold.
+ */
+
+#define BENCH_SAMPLES   256
+#define BENCH_ROUNDS    16
+#define CHANNELS        3
+
+/* Default profile at 2 g, 1 mg per LSB */
+#define THRESHOLD_MG    510
+#define RANGE_SHIFT     0
+#define THRESHOLD_M_S2  (THRESHOLD_MG * SENSOR_G / 1000000000.0)
+
+/* Raw data registers of the samples, little endian */
+static uint8_t raw[BENCH_SAMPLES][CHANNELS * sizeof(int16_t)];
+static volatile uint32_t sink;
+
+/**
+ * @brief Integer path, sign extended data registers shifted to mg and compared per axis
+ *
+ * @param data the data registers of a sample
+ * @return true if any axis is above the threshold
+ */
+static bool int_path(const uint8_t *data)
+{
+    int16_t xyz[CHANNELS];
+
+    for (int i = 0; i < CHANNELS; i++) {
+        xyz[i] = (int16_t)sys_get_le16(&data[i * sizeof(int16_t)]) * (1 << RANGE_SHIFT);
+    }
+
+    return (abs(xyz[0]) > THRESHOLD_MG) || (abs(xyz[1]) > THRESHOLD_MG) || (abs(xyz[2]) > THRESHOLD_MG);
+}
+
+
+/**
+ * @brief Float path, converted to m/s2 as the Zephyr ADXL362 driver does and compared as doubles
+ *
+ * @param data the data registers of a sample
+ * @return true if any axis is above the threshold
+ */
+static bool float_path(const uint8_t *data)
+{
+    struct sensor_value val;
+    double accel[CHANNELS];
+    int32_t micro_ms2;
+
+    for (int i = 0; i < CHANNELS; i++) {
+        micro_ms2 = (int16_t)sys_get_le16(&data[i * sizeof(int16_t)]) * (SENSOR_G / 1000);
+        val.val1 = micro_ms2 / 1000000;
+        val.val2 = micro_ms2 % 1000000;
+        accel[i] = sensor_value_to_double(&val);
+    }
+
+    return (fabs(accel[0]) > THRESHOLD_M_S2) || (fabs(accel[1]) > THRESHOLD_M_S2) ||
+           (fabs(accel[2]) > THRESHOLD_M_S2);
+}
+
+
+/**
+ * @brief Run a path over the samples
+ *
+ * @param path the path
+ * @return uint32_t cycles per sample
+ */
+static uint32_t bench_run(bool (*path)(const uint8_t *data))
+{
+    uint32_t triggers = 0;
+    uint32_t start = k_cycle_get_32();
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int i = 0; i < BENCH_SAMPLES; i++) {
+            triggers += path(raw[i]);
+        }
+    }
+
+    /* Keeps the calls from being optimized out */
+    sink = triggers;
+
+    return (k_cycle_get_32() - start) / (BENCH_ROUNDS * BENCH_SAMPLES);
+}
+
+
+static void test_accel_bench_cycles_per_sample(void)
+{
+    uint32_t seed = 1;
+    uint32_t int_cycles;
+    uint32_t float_cycles;
+    uint32_t int_triggers;
+    uint32_t float_triggers;
+
+    /* Gravity on z and a vibration around the threshold on x and y */
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        for (int j = 0; j < CHANNELS; j++) {
+            seed = seed * 1103515245U + 12345U;
+            sys_put_le16((2 == j) ? 1000 : (int16_t)((seed >> 16) % 1400) - 700, &raw[i][j * sizeof(int16_t)]);
+        }
+    }
+
+    int_cycles = bench_run(int_path);
+    int_triggers = sink;
+    float_cycles = bench_run(float_path);
+    float_triggers = sink;
+
+    TC_PRINT("Cycles per sample: integer %u, float %u\n", int_cycles, float_cycles);
+
+    /* Gravity is above the threshold on every sample */
+    zassert_equal(int_triggers, BENCH_ROUNDS * BENCH_SAMPLES, "Integer path missed samples");
+    zassert_equal(float_triggers, BENCH_ROUNDS * BENCH_SAMPLES, "Float path missed samples");
+    zassert_true(int_cycles < float_cycles, "The integer path takes %u cycles per sample, the float path %u",
+      int_cycles, float_cycles);
+}
+
+
+void test_main(void)
+{
+    ztest_test_suite(accel_bench,
+      ztest_unit_test(test_accel_bench_cycles_per_sample));
+    ztest_run_test_suite(accel_bench);
+}
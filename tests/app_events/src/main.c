@@ -0,0 +1,129 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+
+#include "src/lib/common_events.h"
+
+#define STRESS_THREADS      4
+#define STRESS_ITERATIONS   20000
+#define STRESS_STACK_SIZE   1024
+#define STRESS_PRIORITY     K_PRIO_PREEMPT(5)
+
+/* Each poster owns two bits, one set and cleared with app_events_post()/app_events_clear() and one toggled with
+ *   app_events_set_masked(). The timer toggles a bit of its own from ISR context.
+ */
+#define POSTER_POST_BIT(_i)     BIT(16 + 2 * (_i))
+#define POSTER_TOGGLE_BIT(_i)   BIT(17 + 2 * (_i))
+#define TIMER_BIT               BIT(31)
+
+K_THREAD_STACK_ARRAY_DEFINE(poster_stacks, STRESS_THREADS, STRESS_STACK_SIZE);
+static struct k_thread poster_threads[STRESS_THREADS];
+
+static atomic_t lost;
+static uint32_t poster_expected[STRESS_THREADS];
+static uint32_t timer_expected;
+
+/**
+ * @brief Toggle a bit with app_events_set_masked(), leaving all other bits alone
+ *
+ * @param bit the bit
+ * @param set true to set it
+ */
+static void toggle(uint32_t bit, bool set)
+{
+    if (set) {
+        app_events_set_masked(bit, UINT32_MAX);
+    } else {
+        app_events_set_masked(0, ~bit);
+    }
+}
+
+
+static void timer_fn(struct k_timer *timer_id)
+{
+    timer_expected ^= TIMER_BIT;
+    toggle(TIMER_BIT, 0 != timer_expected);
+}
+
+
+static K_TIMER_DEFINE(stress_timer, timer_fn, NULL);
+
+static void poster_fn(void *p1, void *p2, void *p3)
+{
+    int idx = POINTER_TO_INT(p1);
+    uint32_t post_bit = POSTER_POST_BIT(idx);
+    uint32_t toggle_bit = POSTER_TOGGLE_BIT(idx);
+    uint32_t expected = 0;
+
+    for (int i = 0; i < STRESS_ITERATIONS; i++) {
+        app_events_post(post_bit);
+        if (0 == (app_events_get() & post_bit)) {
+            atomic_inc(&lost);
+        }
+
+        expected ^= toggle_bit;
+        toggle(toggle_bit, 0 != expected);
+        if ((app_events_get() & toggle_bit) != expected) {
+            atomic_inc(&lost);
+        }
+
+        /* Other posters must not have cleared the bit between the read and the write of their update */
+        if (0 == (app_events_clear(post_bit) & post_bit)) {
+            atomic_inc(&lost);
+        }
+
+        /* native_posix only switches threads in kernel calls, so interleave the posters explicitly as well */
+        if (0 == (i % 7)) {
+            k_yield();
+        }
+    }
+
+    poster_expected[idx] = expected;
+}
+
+
+static void test_app_events_no_lost_bits(void)
+{
+    uint32_t expected = 0;
+
+    app_events_set_masked(0, 0);
+    k_timer_start(&stress_timer, K_MSEC(1), K_MSEC(1));
+
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        k_thread_create(&poster_threads[i], poster_stacks[i], K_THREAD_STACK_SIZEOF(poster_stacks[i]), poster_fn,
+          INT_TO_POINTER(i), NULL, NULL, STRESS_PRIORITY, 0, K_NO_WAIT);
+    }
+
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        k_thread_join(&poster_threads[i], K_FOREVER);
+        expected |= poster_expected[i];
+    }
+
+    k_timer_stop(&stress_timer);
+    expected |= timer_expected;
+
+    zassert_equal(atomic_get(&lost), 0, "%d bit updates lost", (int)atomic_get(&lost));
+    zassert_equal(app_events_get(), expected, "State 0x%08x, expected 0x%08x", app_events_get(), expected);
+    zassert_equal(k_event_wait(&app_events, UINT32_MAX, false, K_NO_WAIT), expected,
+      "The k_event mirror does not match the state");
+}
+
+
+static void test_app_events_set_masked_returns_previous(void)
+{
+    app_events_set_masked(BIT(0) | BIT(1), 0);
+
+    zassert_equal(app_events_set_masked(BIT(2), ~BIT(0)), BIT(0) | BIT(1), NULL);
+    zassert_equal(app_events_get(), BIT(1) | BIT(2), NULL);
+    zassert_equal(app_events_post(BIT(1)), BIT(1) | BIT(2), NULL);
+    zassert_equal(app_events_clear(BIT(1) | BIT(2)), BIT(1) | BIT(2), NULL);
+    zassert_equal(app_events_get(), 0, NULL);
+}
+
+
+void test_main(void)
+{
+    ztest_test_suite(app_events,
+      ztest_unit_test(test_app_events_set_masked_returns_previous),
+      ztest_unit_test(test_app_events_no_lost_bits));
+    ztest_run_test_suite(app_events);
+}
@@ -0,0 +1,190 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <date_time.h>
+#include <nrf_modem_gnss.h>
+
+#include "src/assistance/assistance.h"
+
+/* 2022-06-01 00:00:00 UTC [ms] */
+#define TIME_START          1654041600000LL
+#define EPHEMERIS_VALIDITY  (4 * 3600 * MSEC_PER_SEC)
+#define KLOBUCHAR_VALIDITY  (7 * 24 * 3600 * MSEC_PER_SEC)
+
+#define REQUEST_EPHE        (BIT(0) | BIT(4))
+#define REQUEST_WRITES      3
+#define WAIT_TIME           K_SECONDS(1)
+
+/* The minimal backend needs positioning, the tests install their own backend before every request */
+const struct assistance_backend assistance_minimal_backend = {
+    .name = "none",
+};
+
+static int64_t time_now = TIME_START;
+static int fetch_result;
+static K_SEM_DEFINE(fetch_sem, 0, 1);
+static K_SEM_DEFINE(write_sem, 0, 16);
+static uint32_t written_ephe;
+static uint32_t written_flags;
+
+int date_time_now(int64_t *unix_time_ms)
+{
+    *unix_time_ms = time_now;
+    return 0;
+}
+
+
+int32_t nrf_modem_gnss_agps_write(void *buf, int32_t buf_len, uint16_t type)
+{
+    if (NRF_MODEM_GNSS_AGPS_EPHEMERIDES == type) {
+        written_ephe |= BIT(((struct nrf_modem_gnss_agps_data_ephemeris *)buf)->sv_id - 1);
+    } else if (NRF_MODEM_GNSS_AGPS_KLOBUCHAR_IONOSPHERIC_CORRECTION == type) {
+        written_flags |= NRF_MODEM_GNSS_AGPS_KLOBUCHAR_REQUEST;
+    }
+
+    k_sem_give(&write_sem);
+
+    return 0;
+}
+
+
+/**
+ * @brief Stub fetch, stores the requested ephemerides and Klobuchar correction unless fetch_result is set
+ *
+ * @param req the data the GNSS still needs
+ * @return int fetch_result
+ */
+static int stub_fetch(const struct nrf_modem_gnss_agps_data_frame *req)
+{
+    struct nrf_modem_gnss_agps_data_ephemeris ephemeris = { 0 };
+    struct nrf_modem_gnss_agps_data_klobuchar klobuchar = { .alpha0 = 1 };
+
+    if (0 == fetch_result) {
+        for (int i = 0; i < NRF_MODEM_GNSS_NUM_GPS_SATELLITES; i++) {
+            if (req->sv_mask_ephe & BIT(i)) {
+                ephemeris.sv_id = i + 1;
+                zassert_ok(assistance_store_put(NRF_MODEM_GNSS_AGPS_EPHEMERIDES, &ephemeris, sizeof(ephemeris),
+                  time_now + EPHEMERIS_VALIDITY), "Failed to store ephemeris");
+            }
+        }
+
+        if (req->data_flags & NRF_MODEM_GNSS_AGPS_KLOBUCHAR_REQUEST) {
+            zassert_ok(assistance_store_put(NRF_MODEM_GNSS_AGPS_KLOBUCHAR_IONOSPHERIC_CORRECTION, &klobuchar,
+              sizeof(klobuchar), time_now + KLOBUCHAR_VALIDITY), "Failed to store Klobuchar");
+        }
+    }
+
+    k_sem_give(&fetch_sem);
+
+    return fetch_result;
+}
+
+
+static const struct assistance_backend stub_backend = {
+    .name = "stub",
+    .fetch = stub_fetch,
+};
+
+/**
+ * @brief Request ephemerides for REQUEST_EPHE and the Klobuchar correction, and wait until the request is handled
+ *
+ * @param writes number of writes to the GNSS the request is expected to give
+ */
+static void request(int writes)
+{
+    struct nrf_modem_gnss_agps_data_frame req = {
+        .sv_mask_ephe = REQUEST_EPHE,
+        .data_flags = NRF_MODEM_GNSS_AGPS_KLOBUCHAR_REQUEST,
+    };
+
+    assistance_backend_set(&stub_backend);
+    k_sem_reset(&fetch_sem);
+    k_sem_reset(&write_sem);
+    written_ephe = 0;
+    written_flags = 0;
+
+    zassert_ok(assistance_request(&req), "Request not queued");
+
+    for (int i = 0; i < writes; i++) {
+        zassert_ok(k_sem_take(&write_sem, WAIT_TIME), "Only %d of %d writes", i, writes);
+    }
+
+    /* Nothing more is written */
+    zassert_equal(k_sem_take(&write_sem, K_MSEC(100)), -EAGAIN, "More than %d writes", writes);
+}
+
+
+static void test_assistance_fetch_then_store(void)
+{
+    struct assistance_stats before;
+    struct assistance_stats stats;
+
+    assistance_stats_get(&before);
+
+    /* Empty store, the backend fetches everything and it is injected from the store */
+    request(REQUEST_WRITES);
+    zassert_ok(k_sem_take(&fetch_sem, K_NO_WAIT), "The backend was not asked");
+    zassert_equal(written_ephe, REQUEST_EPHE, "Wrong ephemerides 0x%08x", written_ephe);
+    zassert_equal(written_flags, NRF_MODEM_GNSS_AGPS_KLOBUCHAR_REQUEST, "Klobuchar not written");
+
+    /* Everything is in the store now */
+    request(REQUEST_WRITES);
+    zassert_equal(k_sem_take(&fetch_sem, K_NO_WAIT), -EBUSY, "The backend was asked for stored data");
+    zassert_equal(written_ephe, REQUEST_EPHE, "Wrong ephemerides 0x%08x", written_ephe);
+
+    assistance_stats_get(&stats);
+    zassert_equal(stats.requests - before.requests, 2, NULL);
+    zassert_equal(stats.fetches - before.fetches, 1, NULL);
+    zassert_equal(stats.store_hits - before.store_hits, 2 * REQUEST_WRITES, NULL);
+    zassert_equal(stats.fetch_errors - before.fetch_errors, 0, NULL);
+}
+
+
+static void test_assistance_expired(void)
+{
+    struct assistance_stats before;
+    struct assistance_stats stats;
+
+    request(REQUEST_WRITES);
+
+    /* The ephemerides expire, the Klobuchar correction is still valid */
+    time_now += EPHEMERIS_VALIDITY;
+    assistance_stats_get(&before);
+
+    request(REQUEST_WRITES);
+    zassert_ok(k_sem_take(&fetch_sem, K_NO_WAIT), "Expired ephemerides were not fetched");
+    zassert_equal(written_ephe, REQUEST_EPHE, "Wrong ephemerides 0x%08x", written_ephe);
+
+    assistance_stats_get(&stats);
+    zassert_equal(stats.fetches - before.fetches, 1, NULL);
+}
+
+
+static void test_assistance_fetch_error(void)
+{
+    struct assistance_stats before;
+    struct assistance_stats stats;
+
+    time_now += EPHEMERIS_VALIDITY;
+    fetch_result = -EIO;
+    assistance_stats_get(&before);
+
+    /* Only the still valid Klobuchar correction is injected */
+    request(1);
+    zassert_ok(k_sem_take(&fetch_sem, K_NO_WAIT), "The backend was not asked");
+    zassert_equal(written_ephe, 0, "Ephemerides written after a failed fetch");
+
+    assistance_stats_get(&stats);
+    zassert_equal(stats.fetch_errors - before.fetch_errors, 1, NULL);
+
+    fetch_result = 0;
+}
+
+
+void test_main(void)
+{
+    ztest_test_suite(assistance,
+      ztest_unit_test(test_assistance_fetch_then_store),
+      ztest_unit_test(test_assistance_expired),
+      ztest_unit_test(test_assistance_fetch_error));
+    ztest_run_test_suite(assistance);
+}
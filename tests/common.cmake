@@ -0,0 +1,5 @@
+# Included by every test after find_package(Zephyr). The application sources include their headers as "src/..."
+#   from the repository root.
+get_filename_component(APP_ROOT ${CMAKE_CURRENT_LIST_DIR}/.. ABSOLUTE)
+
+target_include_directories(app PRIVATE ${APP_ROOT})
@@ -0,0 +1,641 @@
+#define DT_DRV_COMPAT adi_adxl362
+
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/drivers/spi_emul.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "tests/fakes/fake_adxl362.h"
+
+/* Register model of the ADXL362 on the SPI emulator, for the Zephyr driver and for the raw register access of
+ *   drivers/sensor/accelerometer.c. The samples are computed from the trace when the registers are accessed, and INT1
+ *   is only driven from a timer when an interrupt is due, so the emulator does not wake the CPU at the output data
+ *   rate like the real sensor.
+ */
+
+BUILD_ASSERT(1 == DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT), "The emulator models a single ADXL362");
+
+#define ADXL362_CMD_WRITE_REG           0x0A
+#define ADXL362_CMD_READ_REG            0x0B
+#define ADXL362_CMD_READ_FIFO           0x0D
+
+#define ADXL362_REG_XDATA               0x08
+#define ADXL362_REG_STATUS              0x0B
+#define ADXL362_REG_FIFO_ENTRIES_L      0x0C
+#define ADXL362_REG_FIFO_ENTRIES_H      0x0D
+#define ADXL362_REG_XDATA_L             0x0E
+#define ADXL362_REG_ZDATA_H             0x13
+#define ADXL362_REG_SOFT_RESET          0x1F
+#define ADXL362_REG_THRESH_ACT_L        0x20
+#define ADXL362_REG_THRESH_ACT_H        0x21
+#define ADXL362_REG_TIME_ACT            0x22
+#define ADXL362_REG_THRESH_INACT_L      0x23
+#define ADXL362_REG_THRESH_INACT_H      0x24
+#define ADXL362_REG_TIME_INACT_L        0x25
+#define ADXL362_REG_ACT_INACT_CTL       0x27
+#define ADXL362_REG_FIFO_CONTROL        0x28
+#define ADXL362_REG_FIFO_SAMPLES        0x29
+#define ADXL362_REG_INTMAP1             0x2A
+#define ADXL362_REG_FILTER_CTL          0x2C
+#define ADXL362_REG_POWER_CTL           0x2D
+#define ADXL362_REG_CNT                 0x2F
+
+#define ADXL362_STATUS_DATA_READY       BIT(0)
+#define ADXL362_STATUS_FIFO_READY       BIT(1)
+#define ADXL362_STATUS_FIFO_WATERMARK   BIT(2)
+#define ADXL362_STATUS_FIFO_OVERRUN     BIT(3)
+#define ADXL362_STATUS_ACT              BIT(4)
+#define ADXL362_STATUS_INACT            BIT(5)
+#define ADXL362_STATUS_AWAKE            BIT(6)
+
+#define ADXL362_ACT_INACT_CTL_ACT_EN    BIT(0)
+#define ADXL362_ACT_INACT_CTL_ACT_REF   BIT(1)
+#define ADXL362_ACT_INACT_CTL_INACT_EN  BIT(2)
+#define ADXL362_ACT_INACT_CTL_INACT_REF BIT(3)
+#define ADXL362_ACT_INACT_CTL_LINKLOOP  (0x03 << 4)
+#define ADXL362_ACT_INACT_CTL_LOOP      (0x03 << 4)
+
+#define ADXL362_FIFO_CONTROL_MODE       0x03
+#define ADXL362_FIFO_CONTROL_OLDEST     0x01
+#define ADXL362_FIFO_CONTROL_TEMP       BIT(2)
+#define ADXL362_FIFO_CONTROL_AH         BIT(3)
+#define ADXL362_INTMAP_INT_LOW          BIT(7)
+#define ADXL362_FILTER_CTL_RANGE_POS    6
+#define ADXL362_FILTER_CTL_ODR          0x07
+#define ADXL362_POWER_CTL_MEASURE_MASK  0x03
+#define ADXL362_POWER_CTL_MEASURE       0x02
+#define ADXL362_SOFT_RESET_KEY          0x52
+
+#define ADXL362_FIFO_SIZE               512
+#define ADXL362_FIFO_AXIS_TEMP          3
+/* Sample period at the lowest output data rate, 12.5 Hz [us] */
+#define ADXL362_PERIOD_MAX              80000
+#define ADXL362_ODR_CODE_MAX            5
+
+#define GRAVITY_MG                      1000
+/* Longest look-ahead for the next interrupt [samples], about a day at 12.5 Hz */
+#define PREDICT_SAMPLES_MAX             1000000
+
+#define ADXL362_NODE                    DT_DRV_INST(0)
+
+struct fake_adxl362_state {
+    uint8_t reg[ADXL362_REG_CNT];
+    uint16_t fifo[ADXL362_FIFO_SIZE];
+    /** Index of the oldest FIFO entry. */
+    uint16_t fifo_head;
+    uint16_t fifo_cnt;
+    bool measuring;
+    /** Uptime of sample 0 [us]. */
+    int64_t t0;
+    /** Sample period [us]. */
+    uint32_t period;
+    /** Index of the next sample. */
+    uint64_t next;
+    /** Linked mode state, looking for inactivity when awake. */
+    bool awake;
+    /** The references are taken from the next sample. */
+    bool ref_pending;
+    int16_t act_ref[3];
+    int16_t inact_ref[3];
+    uint32_t act_cnt;
+    uint32_t inact_cnt;
+};
+
+struct fake_adxl362_cfg {
+    uint16_t chipsel;
+};
+
+static const uint8_t reg_defaults[ADXL362_REG_CNT] = {
+    [0x00] = 0xAD,
+    [0x01] = 0x1D,
+    [0x02] = 0xF2,
+    [0x03] = 0x01,
+    [ADXL362_REG_STATUS] = ADXL362_STATUS_AWAKE,
+    [ADXL362_REG_FILTER_CTL] = 0x13,
+};
+
+static const struct device *const gpio_dev = DEVICE_DT_GET(DT_GPIO_CTLR(ADXL362_NODE, int1_gpios));
+static const struct fake_adxl362_cfg cfg = {
+    .chipsel = DT_REG_ADDR(ADXL362_NODE),
+};
+
+static struct k_spinlock fake_adxl362_lock;
+static struct spi_emul spi_emul;
+static struct fake_adxl362_state state;
+/* Copy of the state the next interrupt is predicted with */
+static struct fake_adxl362_state sim;
+static bool pin_level;
+static const struct fake_adxl362_segment *trace;
+static size_t trace_cnt;
+static int64_t trace_start;
+static struct fake_adxl362_stats stats;
+/* SPI transfer buffers, a command byte, a register and the whole FIFO */
+static uint8_t tx_data[2 + 2 * ADXL362_FIFO_SIZE];
+static uint8_t rx_data[sizeof(tx_data)];
+
+static void fake_adxl362_timer_fn(struct k_timer *timer_id);
+
+static K_TIMER_DEFINE(fake_adxl362_timer, fake_adxl362_timer_fn, NULL);
+
+static int64_t uptime_us_get(void)
+{
+    return (int64_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+
+/**
+ * @brief Get the acceleration of the trace at a time
+ *
+ * @param time uptime [us]
+ * @param mg where the xyz acceleration [mg] is stored
+ */
+static void trace_sample(int64_t time, int16_t mg[3])
+{
+    const struct fake_adxl362_segment *segment = NULL;
+    double t;
+
+    mg[0] = 0;
+    mg[1] = 0;
+    mg[2] = GRAVITY_MG;
+
+    if ((NULL == trace) || (time < trace_start)) {
+        return;
+    }
+
+    t = (double)(time - trace_start) / USEC_PER_SEC;
+    for (size_t i = 0; (i < trace_cnt) && (trace[i].start <= t); i++) {
+        segment = &trace[i];
+    }
+
+    if ((NULL != segment) && (0 != segment->amplitude)) {
+        mg[0] = (int16_t)lround(segment->amplitude * sin(2.0 * M_PI * segment->freq * t));
+    }
+}
+
+
+/**
+ * @brief Update the status and FIFO entry registers from the FIFO
+ *
+ * @param s the state
+ */
+static void status_update(struct fake_adxl362_state *s)
+{
+    uint16_t watermark = s->reg[ADXL362_REG_FIFO_SAMPLES] |
+      ((s->reg[ADXL362_REG_FIFO_CONTROL] & ADXL362_FIFO_CONTROL_AH) ? 0x100 : 0);
+
+    WRITE_BIT(s->reg[ADXL362_REG_STATUS], 1, s->fifo_cnt > 0);
+    WRITE_BIT(s->reg[ADXL362_REG_STATUS], 2, (watermark > 0) && (s->fifo_cnt >= watermark));
+    WRITE_BIT(s->reg[ADXL362_REG_STATUS], 6, s->awake);
+    s->reg[ADXL362_REG_FIFO_ENTRIES_L] = s->fifo_cnt & 0xFF;
+    s->reg[ADXL362_REG_FIFO_ENTRIES_H] = s->fifo_cnt >> 8;
+}
+
+
+static bool int1_level_get(const struct fake_adxl362_state *s)
+{
+    bool level = 0 != (s->reg[ADXL362_REG_STATUS] & s->reg[ADXL362_REG_INTMAP1] & ~ADXL362_INTMAP_INT_LOW);
+
+    return level != (0 != (s->reg[ADXL362_REG_INTMAP1] & ADXL362_INTMAP_INT_LOW));
+}
+
+
+static void fifo_push(struct fake_adxl362_state *s, uint8_t axis, int16_t value)
+{
+    if (ADXL362_FIFO_SIZE == s->fifo_cnt) {
+        s->reg[ADXL362_REG_STATUS] |= ADXL362_STATUS_FIFO_OVERRUN;
+        if (ADXL362_FIFO_CONTROL_OLDEST == (s->reg[ADXL362_REG_FIFO_CONTROL] & ADXL362_FIFO_CONTROL_MODE)) {
+            return;
+        }
+        s->fifo_head = (s->fifo_head + 1) % ADXL362_FIFO_SIZE;
+        s->fifo_cnt--;
+    }
+
+    s->fifo[(s->fifo_head + s->fifo_cnt) % ADXL362_FIFO_SIZE] = (axis << 14) | ((uint16_t)value & 0x3FFF);
+    s->fifo_cnt++;
+}
+
+
+static uint16_t fifo_pop(struct fake_adxl362_state *s)
+{
+    uint16_t entry;
+
+    if (0 == s->fifo_cnt) {
+        return 0;
+    }
+
+    entry = s->fifo[s->fifo_head];
+    s->fifo_head = (s->fifo_head + 1) % ADXL362_FIFO_SIZE;
+    s->fifo_cnt--;
+
+    return entry;
+}
+
+
+/**
+ * @brief Check if any axis of a sample is above a threshold
+ *
+ * @param raw the sample [LSB]
+ * @param ref the reference [LSB], used in referenced mode
+ * @param referenced true in referenced mode, false in absolute mode
+ * @param thresh the threshold [LSB]
+ * @return true if any axis is above the threshold
+ */
+static bool motion_over(const int16_t raw[3], const int16_t ref[3], bool referenced, uint16_t thresh)
+{
+    for (int i = 0; i < 3; i++) {
+        if (abs(raw[i] - (referenced ? ref[i] : 0)) > thresh) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Run activity and inactivity detection on a sample
+ *
+ * @param s the state
+ * @param raw the sample [LSB]
+ */
+static void motion_detect(struct fake_adxl362_state *s, const int16_t raw[3])
+{
+    uint8_t ctl = s->reg[ADXL362_REG_ACT_INACT_CTL];
+    bool linked = 0 != (ctl & ADXL362_ACT_INACT_CTL_LINKLOOP);
+    bool loop = ADXL362_ACT_INACT_CTL_LOOP == (ctl & ADXL362_ACT_INACT_CTL_LINKLOOP);
+    uint16_t thresh_act = ((s->reg[ADXL362_REG_THRESH_ACT_H] & 0x07) << 8) | s->reg[ADXL362_REG_THRESH_ACT_L];
+    uint16_t thresh_inact = ((s->reg[ADXL362_REG_THRESH_INACT_H] & 0x07) << 8) | s->reg[ADXL362_REG_THRESH_INACT_L];
+    uint32_t time_act = MAX(s->reg[ADXL362_REG_TIME_ACT], 1);
+    uint32_t time_inact = MAX(sys_get_le16(&s->reg[ADXL362_REG_TIME_INACT_L]), 1);
+
+    if (s->ref_pending) {
+        memcpy(s->act_ref, raw, sizeof(s->act_ref));
+        memcpy(s->inact_ref, raw, sizeof(s->inact_ref));
+        s->ref_pending = false;
+    }
+
+    /* In linked mode the next state change waits until the host has read the status */
+    if (linked && !loop && (s->reg[ADXL362_REG_STATUS] & (ADXL362_STATUS_ACT | ADXL362_STATUS_INACT))) {
+        return;
+    }
+
+    if ((ctl & ADXL362_ACT_INACT_CTL_ACT_EN) && !(linked && s->awake)) {
+        s->act_cnt = motion_over(raw, s->act_ref, ctl & ADXL362_ACT_INACT_CTL_ACT_REF, thresh_act) ?
+          s->act_cnt + 1 : 0;
+        if (s->act_cnt >= time_act) {
+            s->reg[ADXL362_REG_STATUS] |= ADXL362_STATUS_ACT;
+            s->awake = true;
+            s->act_cnt = 0;
+            s->inact_cnt = 0;
+            memcpy(s->act_ref, raw, sizeof(s->act_ref));
+            memcpy(s->inact_ref, raw, sizeof(s->inact_ref));
+            if (linked) {
+                return;
+            }
+        }
+    }
+
+    if ((ctl & ADXL362_ACT_INACT_CTL_INACT_EN) && !(linked && !s->awake)) {
+        /* A sample above the threshold restarts the inactivity time with a new reference */
+        if (motion_over(raw, s->inact_ref, ctl & ADXL362_ACT_INACT_CTL_INACT_REF, thresh_inact)) {
+            s->inact_cnt = 0;
+            memcpy(s->inact_ref, raw, sizeof(s->inact_ref));
+        } else {
+            s->inact_cnt++;
+        }
+        if (s->inact_cnt >= time_inact) {
+            s->reg[ADXL362_REG_STATUS] |= ADXL362_STATUS_INACT;
+            s->awake = false;
+            s->inact_cnt = 0;
+            s->act_cnt = 0;
+            memcpy(s->act_ref, raw, sizeof(s->act_ref));
+        }
+    }
+} /* motion_detect */
+
+
+/**
+ * @brief Measure the next sample
+ *
+ * @param s the state
+ */
+static void sample_measure(struct fake_adxl362_state *s)
+{
+    int16_t mg[3];
+    int16_t raw[3];
+    int shift = MIN(s->reg[ADXL362_REG_FILTER_CTL] >> ADXL362_FILTER_CTL_RANGE_POS, 2);
+
+    trace_sample(s->t0 + (int64_t)s->next * s->period, mg);
+    s->next++;
+
+    for (int i = 0; i < 3; i++) {
+        raw[i] = CLAMP(mg[i] / (1 << shift), -2048, 2047);
+        sys_put_le16(raw[i], &s->reg[ADXL362_REG_XDATA_L + 2 * i]);
+        s->reg[ADXL362_REG_XDATA + i] = (uint8_t)(raw[i] >> 4);
+    }
+    s->reg[ADXL362_REG_STATUS] |= ADXL362_STATUS_DATA_READY;
+
+    if (0 != (s->reg[ADXL362_REG_FIFO_CONTROL] & ADXL362_FIFO_CONTROL_MODE)) {
+        for (int i = 0; i < 3; i++) {
+            fifo_push(s, i, raw[i]);
+        }
+        if (s->reg[ADXL362_REG_FIFO_CONTROL] & ADXL362_FIFO_CONTROL_TEMP) {
+            fifo_push(s, ADXL362_FIFO_AXIS_TEMP, 0);
+        }
+    }
+
+    motion_detect(s, raw);
+} /* sample_measure */
+
+
+/**
+ * @brief Measure the samples up to a time
+ *
+ * @param s the state
+ * @param now uptime [us]
+ * @return uint32_t number of samples measured
+ */
+static uint32_t state_advance(struct fake_adxl362_state *s, int64_t now)
+{
+    uint32_t cnt = 0;
+
+    while (s->measuring && (s->t0 + (int64_t)s->next * s->period <= now)) {
+        sample_measure(s);
+        cnt++;
+    }
+
+    status_update(s);
+
+    return cnt;
+}
+
+
+/**
+ * @brief Restart the sample clock after the measurement mode or the output data rate changed
+ *
+ * @param s the state
+ * @param now uptime [us]
+ */
+static void timing_restart(struct fake_adxl362_state *s, int64_t now)
+{
+    uint8_t odr_code = MIN(s->reg[ADXL362_REG_FILTER_CTL] & ADXL362_FILTER_CTL_ODR, ADXL362_ODR_CODE_MAX);
+
+    s->measuring = ADXL362_POWER_CTL_MEASURE == (s->reg[ADXL362_REG_POWER_CTL] & ADXL362_POWER_CTL_MEASURE_MASK);
+    s->period = ADXL362_PERIOD_MAX >> odr_code;
+    s->t0 = now;
+    s->next = 1;
+}
+
+
+static void state_reset(struct fake_adxl362_state *s, int64_t now)
+{
+    memset(s, 0, sizeof(*s));
+    memcpy(s->reg, reg_defaults, sizeof(s->reg));
+    s->awake = true;
+    s->ref_pending = true;
+    timing_restart(s, now);
+}
+
+
+static uint8_t reg_read(struct fake_adxl362_state *s, uint8_t reg)
+{
+    uint8_t value;
+
+    if (reg >= ADXL362_REG_CNT) {
+        return 0;
+    }
+
+    value = s->reg[reg];
+
+    if (ADXL362_REG_STATUS == reg) {
+        s->reg[reg] &= ~(ADXL362_STATUS_ACT | ADXL362_STATUS_INACT | ADXL362_STATUS_FIFO_OVERRUN);
+    } else if (((reg >= ADXL362_REG_XDATA) && (reg < ADXL362_REG_STATUS)) ||
+      ((reg >= ADXL362_REG_XDATA_L) && (reg <= ADXL362_REG_ZDATA_H)))
+    {
+        s->reg[ADXL362_REG_STATUS] &= ~ADXL362_STATUS_DATA_READY;
+    }
+
+    return value;
+}
+
+
+static void reg_write(struct fake_adxl362_state *s, uint8_t reg, uint8_t value, int64_t now)
+{
+    /* The registers before the soft reset are read only */
+    if ((reg < ADXL362_REG_SOFT_RESET) || (reg >= ADXL362_REG_CNT)) {
+        return;
+    }
+
+    if (ADXL362_REG_SOFT_RESET == reg) {
+        if (ADXL362_SOFT_RESET_KEY == value) {
+            state_reset(s, now);
+        }
+        return;
+    }
+
+    s->reg[reg] = value;
+
+    switch (reg) {
+        case ADXL362_REG_ACT_INACT_CTL:
+            s->act_cnt = 0;
+            s->inact_cnt = 0;
+            s->ref_pending = true;
+            break;
+        case ADXL362_REG_FIFO_CONTROL:
+            if (0 == (value & ADXL362_FIFO_CONTROL_MODE)) {
+                s->fifo_head = 0;
+                s->fifo_cnt = 0;
+            }
+            break;
+        case ADXL362_REG_FILTER_CTL:
+        case ADXL362_REG_POWER_CTL:
+            timing_restart(s, now);
+            break;
+        default:
+            break;
+    }
+}
+
+
+/**
+ * @brief Drive INT1 from the state and start the timer for the next interrupt. The pin can only rise again after
+ *   the host has cleared the status, which is a register access that reschedules.
+ *
+ * @param now uptime [us]
+ */
+static void int1_update(int64_t now)
+{
+    bool level = int1_level_get(&state);
+    int64_t due = -1;
+
+    if ((level != pin_level) && (0 == gpio_emul_input_set(gpio_dev, DT_GPIO_PIN(ADXL362_NODE, int1_gpios), level))) {
+        pin_level = level;
+        if (level) {
+            stats.interrupts++;
+        }
+    }
+
+    if (state.measuring && !level) {
+        sim = state;
+        for (uint32_t i = 0; i < PREDICT_SAMPLES_MAX; i++) {
+            sample_measure(&sim);
+            status_update(&sim);
+            if (int1_level_get(&sim)) {
+                break;
+            }
+        }
+        /* Without an interrupt in sight, look again at the end of the look-ahead */
+        due = sim.t0 + (int64_t)(sim.next - 1) * sim.period;
+    }
+
+    if (due < 0) {
+        k_timer_stop(&fake_adxl362_timer);
+    } else {
+        k_timer_start(&fake_adxl362_timer, K_USEC(MAX(due - now, 0)), K_NO_WAIT);
+    }
+} /* int1_update */
+
+
+static void fake_adxl362_timer_fn(struct k_timer *timer_id)
+{
+    int64_t now = uptime_us_get();
+    k_spinlock_key_t key = k_spin_lock(&fake_adxl362_lock);
+
+    stats.samples += state_advance(&state, now);
+    int1_update(now);
+
+    k_spin_unlock(&fake_adxl362_lock, key);
+}
+
+
+static size_t buf_set_len(const struct spi_buf_set *set)
+{
+    size_t len = 0;
+
+    for (size_t i = 0; (NULL != set) && (i < set->count); i++) {
+        len += set->buffers[i].len;
+    }
+
+    return len;
+}
+
+
+static int fake_adxl362_io(struct spi_emul *emul, const struct spi_config *config,
+  const struct spi_buf_set *tx_bufs, const struct spi_buf_set *rx_bufs)
+{
+    int64_t now = uptime_us_get();
+    size_t tx_len = MIN(buf_set_len(tx_bufs), sizeof(tx_data));
+    size_t len = MIN(MAX(tx_len, buf_set_len(rx_bufs)), sizeof(rx_data));
+    size_t pos = 0;
+    size_t n;
+    k_spinlock_key_t key = k_spin_lock(&fake_adxl362_lock);
+
+    for (size_t i = 0; (NULL != tx_bufs) && (i < tx_bufs->count) && (pos < tx_len); i++) {
+        n = MIN(tx_bufs->buffers[i].len, tx_len - pos);
+        if (NULL != tx_bufs->buffers[i].buf) {
+            memcpy(&tx_data[pos], tx_bufs->buffers[i].buf, n);
+        } else {
+            memset(&tx_data[pos], 0, n);
+        }
+        pos += n;
+    }
+    memset(rx_data, 0, len);
+
+    stats.samples += state_advance(&state, now);
+    stats.transfers++;
+
+    if (tx_len >= 2) {
+        switch (tx_data[0]) {
+            case ADXL362_CMD_WRITE_REG:
+                for (size_t i = 2; i < tx_len; i++) {
+                    reg_write(&state, tx_data[1] + i - 2, tx_data[i], now);
+                }
+                break;
+            case ADXL362_CMD_READ_REG:
+                for (size_t i = 2; i < len; i++) {
+                    rx_data[i] = reg_read(&state, tx_data[1] + i - 2);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if ((tx_len >= 1) && (ADXL362_CMD_READ_FIFO == tx_data[0])) {
+        for (size_t i = 1; i + 1 < len; i += 2) {
+            sys_put_le16(fifo_pop(&state), &rx_data[i]);
+            stats.fifo_reads++;
+        }
+    }
+
+    status_update(&state);
+    int1_update(now);
+
+    k_spin_unlock(&fake_adxl362_lock, key);
+
+    pos = 0;
+    for (size_t i = 0; (NULL != rx_bufs) && (i < rx_bufs->count) && (pos < len); i++) {
+        n = MIN(rx_bufs->buffers[i].len, len - pos);
+        if (NULL != rx_bufs->buffers[i].buf) {
+            memcpy(rx_bufs->buffers[i].buf, &rx_data[pos], n);
+        }
+        pos += n;
+    }
+
+    return 0;
+} /* fake_adxl362_io */
+
+
+static const struct spi_emul_api fake_adxl362_api = {
+    .io = fake_adxl362_io,
+};
+
+static int fake_adxl362_init(const struct emul *emul, const struct device *parent)
+{
+    const struct fake_adxl362_cfg *emul_cfg = emul->cfg;
+
+    state_reset(&state, uptime_us_get());
+
+    spi_emul.api = &fake_adxl362_api;
+    spi_emul.chipsel = emul_cfg->chipsel;
+
+    return spi_emul_register(parent, emul->dev_label, &spi_emul);
+}
+
+
+EMUL_DEFINE(fake_adxl362_init, ADXL362_NODE, &cfg);
+
+void fake_adxl362_trace_set(const struct fake_adxl362_segment *segments, size_t cnt)
+{
+    int64_t now = uptime_us_get();
+    k_spinlock_key_t key = k_spin_lock(&fake_adxl362_lock);
+
+    /* The samples up to now are measured with the previous trace */
+    stats.samples += state_advance(&state, now);
+
+    trace = segments;
+    trace_cnt = cnt;
+    trace_start = now;
+
+    int1_update(now);
+
+    k_spin_unlock(&fake_adxl362_lock, key);
+}
+
+
+void fake_adxl362_stats_get(struct fake_adxl362_stats *stats_out)
+{
+    k_spinlock_key_t key = k_spin_lock(&fake_adxl362_lock);
+
+    *stats_out = stats;
+
+    k_spin_unlock(&fake_adxl362_lock, key);
+}
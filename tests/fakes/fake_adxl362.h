@@ -0,0 +1,44 @@
+#ifndef FAKE_ADXL362_H
+#define FAKE_ADXL362_H
+
+#include <zephyr.h>
+
+/** @brief Segment of a recorded movement trace. */
+struct fake_adxl362_segment {
+    /** Start of the segment [s from the start of the trace]. */
+    uint32_t start;
+    /** Amplitude of the vibration on the x axis [mg], 0 when still. */
+    uint16_t amplitude;
+    /** Frequency of the vibration [Hz]. */
+    float freq;
+};
+
+/** @brief What the application did with the emulated ADXL362. */
+struct fake_adxl362_stats {
+    /** Number of INT1 interrupts, rising edges of the pin. */
+    uint32_t interrupts;
+    /** Number of SPI transfers. */
+    uint32_t transfers;
+    /** Number of samples measured. */
+    uint32_t samples;
+    /** Number of FIFO entries read. */
+    uint32_t fifo_reads;
+};
+
+/**
+ * @brief Replay a trace, starting now. The device lies flat with gravity on the z axis, the trace adds a vibration on
+ *   the x axis. Before a trace is set the device is still.
+ *
+ * @param segments the segments in order of their start, must stay valid while the trace runs
+ * @param cnt number of segments
+ */
+void fake_adxl362_trace_set(const struct fake_adxl362_segment *segments, size_t cnt);
+
+/**
+ * @brief Get what the application did with the emulated ADXL362
+ *
+ * @param stats where the statistics are stored
+ */
+void fake_adxl362_stats_get(struct fake_adxl362_stats *stats);
+
+#endif /* FAKE_ADXL362_H */
@@ -0,0 +1,216 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <nrf_modem_gnss.h>
+
+#include "tests/fakes/fake_gnss.h"
+
+/* Scripted nrf_modem_gnss. A search started with nrf_modem_gnss_start() ends with the next fix of the script, or with
+ *   NRF_MODEM_GNSS_EVT_SLEEP_AFTER_TIMEOUT after the fix retry timeout. With a fix interval other than 0 the search
+ *   goes on after the fix, with the same fix every fix interval until nrf_modem_gnss_stop(). The events are sent to
+ *   the handler from a timer, as the modem library sends them from its interrupt.
+ */
+
+/* Date of the fixes, the time of day follows the uptime */
+#define FAKE_GNSS_YEAR  2022
+#define FAKE_GNSS_MONTH 6
+#define FAKE_GNSS_DAY   1
+
+static struct k_spinlock fake_gnss_lock;
+static nrf_modem_gnss_event_handler_type_t event_handler;
+static const struct fake_gnss_search *script;
+static size_t script_cnt;
+static size_t script_idx;
+static const struct fake_gnss_search *search;
+static bool running;
+static struct nrf_modem_gnss_pvt_data_frame pvt;
+static struct fake_gnss_stats stats;
+
+static void fake_gnss_timer_fn(struct k_timer *timer_id)
+{
+    int event = NRF_MODEM_GNSS_EVT_SLEEP_AFTER_TIMEOUT;
+    int64_t uptime = k_uptime_get();
+    uint16_t fix_interval = 0;
+    k_spinlock_key_t key = k_spin_lock(&fake_gnss_lock);
+
+    if (!running) {
+        k_spin_unlock(&fake_gnss_lock, key);
+        return;
+    }
+    running = false;
+
+    if (0 != search->ttff) {
+        memset(&pvt, 0, sizeof(pvt));
+        pvt.latitude = search->latitude;
+        pvt.longitude = search->longitude;
+        pvt.speed = search->speed;
+        pvt.pdop = search->pdop;
+        pvt.hdop = search->hdop;
+        pvt.accuracy = 5.0f;
+        pvt.flags = NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID;
+        pvt.datetime.year = FAKE_GNSS_YEAR;
+        pvt.datetime.month = FAKE_GNSS_MONTH;
+        pvt.datetime.day = FAKE_GNSS_DAY;
+        pvt.datetime.hour = (uptime / (3600 * MSEC_PER_SEC)) % 24;
+        pvt.datetime.minute = (uptime / (60 * MSEC_PER_SEC)) % 60;
+        pvt.datetime.seconds = (uptime / MSEC_PER_SEC) % 60;
+        pvt.datetime.ms = uptime % MSEC_PER_SEC;
+        for (int i = 0; i < MIN(search->sv_used, NRF_MODEM_GNSS_MAX_SATELLITES); i++) {
+            pvt.sv[i].sv = i + 1;
+            pvt.sv[i].flags = NRF_MODEM_GNSS_SV_FLAG_USED_IN_FIX;
+        }
+        event = NRF_MODEM_GNSS_EVT_PVT;
+        stats.fixes++;
+        /* Continuous or periodic mode */
+        fix_interval = stats.fix_interval;
+        running = (0 != fix_interval);
+    } else {
+        stats.timeouts++;
+    }
+
+    k_spin_unlock(&fake_gnss_lock, key);
+
+    if (0 != fix_interval) {
+        k_timer_start(timer_id, K_SECONDS(fix_interval), K_NO_WAIT);
+    }
+
+    if (NULL != event_handler) {
+        event_handler(event);
+    }
+} /* fake_gnss_timer_fn */
+
+
+static K_TIMER_DEFINE(fake_gnss_timer, fake_gnss_timer_fn, NULL);
+
+void fake_gnss_script_set(const struct fake_gnss_search *searches, size_t cnt)
+{
+    k_spinlock_key_t key = k_spin_lock(&fake_gnss_lock);
+
+    script = searches;
+    script_cnt = cnt;
+    script_idx = 0;
+
+    k_spin_unlock(&fake_gnss_lock, key);
+}
+
+
+void fake_gnss_stats_get(struct fake_gnss_stats *stats_out)
+{
+    k_spinlock_key_t key = k_spin_lock(&fake_gnss_lock);
+
+    *stats_out = stats;
+
+    k_spin_unlock(&fake_gnss_lock, key);
+}
+
+
+int32_t nrf_modem_gnss_event_handler_set(nrf_modem_gnss_event_handler_type_t handler)
+{
+    event_handler = handler;
+    return 0;
+}
+
+
+int32_t nrf_modem_gnss_system_mask_set(uint8_t system_mask)
+{
+    return 0;
+}
+
+
+int32_t nrf_modem_gnss_fix_retry_set(uint16_t fix_retry)
+{
+    stats.fix_retry = fix_retry;
+    return 0;
+}
+
+
+int32_t nrf_modem_gnss_fix_interval_set(uint16_t fix_interval)
+{
+    stats.fix_interval = fix_interval;
+    return 0;
+}
+
+
+int32_t nrf_modem_gnss_nmea_mask_set(uint16_t nmea_mask)
+{
+    return 0;
+}
+
+
+int32_t nrf_modem_gnss_power_mode_set(uint8_t power_mode)
+{
+    stats.power_mode = power_mode;
+    return 0;
+}
+
+
+int32_t nrf_modem_gnss_start(void)
+{
+    k_timeout_t timeout = K_FOREVER;
+    k_spinlock_key_t key = k_spin_lock(&fake_gnss_lock);
+
+    if (running) {
+        k_spin_unlock(&fake_gnss_lock, key);
+        return -EINVAL;
+    }
+
+    stats.starts++;
+
+    /* Without a script entry the search never ends */
+    if (script_idx < script_cnt) {
+        search = &script[script_idx++];
+        running = true;
+        if (0 != search->ttff) {
+            timeout = K_MSEC(search->ttff);
+        } else if (0 != stats.fix_retry) {
+            timeout = K_SECONDS(stats.fix_retry);
+        }
+    }
+
+    k_spin_unlock(&fake_gnss_lock, key);
+
+    if (!K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+        k_timer_start(&fake_gnss_timer, timeout, K_NO_WAIT);
+    }
+
+    return 0;
+} /* nrf_modem_gnss_start */
+
+
+int32_t nrf_modem_gnss_stop(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&fake_gnss_lock);
+
+    running = false;
+    stats.stops++;
+
+    k_spin_unlock(&fake_gnss_lock, key);
+
+    k_timer_stop(&fake_gnss_timer);
+
+    return 0;
+}
+
+
+int32_t nrf_modem_gnss_nv_data_delete(uint32_t nv_data_flags)
+{
+    stats.nv_deletes++;
+    return 0;
+}
+
+
+int32_t nrf_modem_gnss_read(void *buf, int32_t buf_len, int type)
+{
+    int32_t retval = 0;
+    k_spinlock_key_t key = k_spin_lock(&fake_gnss_lock);
+
+    if ((NRF_MODEM_GNSS_DATA_PVT == type) && (buf_len >= sizeof(pvt))) {
+        memcpy(buf, &pvt, sizeof(pvt));
+    } else {
+        retval = -ENOMSG;
+    }
+
+    k_spin_unlock(&fake_gnss_lock, key);
+
+    return retval;
+}
@@ -0,0 +1,60 @@
+#ifndef FAKE_GNSS_H
+#define FAKE_GNSS_H
+
+#include <zephyr.h>
+
+/** @brief Outcome of one scripted search. */
+struct fake_gnss_search {
+    /** Time from nrf_modem_gnss_start() to the first fix [ms], 0 if the search runs until the fix retry timeout. */
+    uint32_t ttff;
+    /** Latitude of the fix [deg]. */
+    double latitude;
+    /** Longitude of the fix [deg]. */
+    double longitude;
+    /** Horizontal speed of the fix [m/s]. */
+    float speed;
+    /** Number of satellites used in the fix. */
+    uint8_t sv_used;
+    /** Position dilution of precision of the fix. */
+    float pdop;
+    /** Horizontal dilution of precision of the fix. */
+    float hdop;
+};
+
+/** @brief What the application did with the fake GNSS. */
+struct fake_gnss_stats {
+    /** Number of searches started. */
+    uint32_t starts;
+    /** Number of calls to nrf_modem_gnss_stop(). */
+    uint32_t stops;
+    /** Number of calls to nrf_modem_gnss_nv_data_delete(). */
+    uint32_t nv_deletes;
+    /** Number of fixes, also the ones after the first while tracking. */
+    uint32_t fixes;
+    /** Number of searches that timed out. */
+    uint32_t timeouts;
+    /** Fix interval of the last search [s]. */
+    uint16_t fix_interval;
+    /** Fix retry timeout of the last search [s]. */
+    uint16_t fix_retry;
+    /** Power saving mode of the last search. */
+    uint8_t power_mode;
+};
+
+/**
+ * @brief Script the searches of the fake nrf_modem_gnss. Each nrf_modem_gnss_start() takes the next search, a
+ *   search after the end of the script never ends.
+ *
+ * @param searches the searches, must stay valid while the script runs
+ * @param cnt number of searches
+ */
+void fake_gnss_script_set(const struct fake_gnss_search *searches, size_t cnt);
+
+/**
+ * @brief Get what the application did with the fake GNSS
+ *
+ * @param stats where the statistics are stored
+ */
+void fake_gnss_stats_get(struct fake_gnss_stats *stats);
+
+#endif /* FAKE_GNSS_H */
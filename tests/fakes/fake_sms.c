@@ -0,0 +1,96 @@
+#include <zephyr.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <modem/sms.h>
+
+#include "tests/fakes/fake_sms.h"
+
+/* SMS library that keeps the sent texts and delivers scripted ones to the single listener */
+
+static struct k_spinlock fake_sms_lock;
+static sms_callback_t listener;
+static void *listener_context;
+static int send_result;
+static struct fake_sms_stats stats;
+static K_SEM_DEFINE(sent_sem, 0, 1);
+
+void fake_sms_send_result_set(int result)
+{
+    send_result = result;
+}
+
+
+int fake_sms_wait(k_timeout_t timeout)
+{
+    return k_sem_take(&sent_sem, timeout);
+}
+
+
+void fake_sms_receive(const char *text)
+{
+    char payload[FAKE_SMS_TEXT_LEN_MAX + 1];
+    struct sms_data data = {
+        .type = SMS_TYPE_DELIVER,
+        .payload = payload,
+    };
+
+    data.payload_len = MIN(strlen(text), FAKE_SMS_TEXT_LEN_MAX);
+    memcpy(payload, text, data.payload_len);
+    payload[data.payload_len] = '\0';
+
+    if (NULL != listener) {
+        listener(&data, listener_context);
+    }
+}
+
+
+void fake_sms_stats_get(struct fake_sms_stats *stats_out)
+{
+    k_spinlock_key_t key = k_spin_lock(&fake_sms_lock);
+
+    *stats_out = stats;
+
+    k_spin_unlock(&fake_sms_lock, key);
+}
+
+
+int sms_register_listener(sms_callback_t callback, void *context)
+{
+    if (NULL != listener) {
+        return -ENOMEM;
+    }
+
+    listener = callback;
+    listener_context = context;
+
+    return 0;
+}
+
+
+void sms_unregister_listener(int handle)
+{
+    listener = NULL;
+}
+
+
+int sms_send_text(const char *number, const char *text)
+{
+    k_spinlock_key_t key;
+
+    if (0 != send_result) {
+        return send_result;
+    }
+
+    key = k_spin_lock(&fake_sms_lock);
+
+    stats.sent++;
+    stats.last_time = k_uptime_get();
+    strncpy(stats.last_text, text, FAKE_SMS_TEXT_LEN_MAX);
+    stats.last_text[FAKE_SMS_TEXT_LEN_MAX] = '\0';
+
+    k_spin_unlock(&fake_sms_lock, key);
+
+    k_sem_give(&sent_sem);
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#ifndef FAKE_SMS_H
+#define FAKE_SMS_H
+
+#include <zephyr.h>
+
+/* Longest text kept of a sent SMS, the Stats reply spans three segments */
+#define FAKE_SMS_TEXT_LEN_MAX   (3 * 153)
+
+/** @brief What the application sent with the fake SMS library. */
+struct fake_sms_stats {
+    /** Number of texts sent. */
+    uint32_t sent;
+    /** Uptime of the last text sent [ms]. */
+    int64_t last_time;
+    /** The last text sent, cut at FAKE_SMS_TEXT_LEN_MAX. */
+    char last_text[FAKE_SMS_TEXT_LEN_MAX + 1];
+};
+
+/**
+ * @brief Set the result of the following sends
+ *
+ * @param result 0 to send, negative to fail
+ */
+void fake_sms_send_result_set(int result);
+
+/**
+ * @brief Wait for the next text to be sent
+ *
+ * @param timeout how long to wait
+ * @return int 0 if a text was sent, -EAGAIN on timeout
+ */
+int fake_sms_wait(k_timeout_t timeout);
+
+/**
+ * @brief Deliver a text to the listener, as if it was received
+ *
+ * @param text the NUL terminated text
+ */
+void fake_sms_receive(const char *text);
+
+/**
+ * @brief Get what the application sent with the fake SMS library
+ *
+ * @param stats where the statistics are stored
+ */
+void fake_sms_stats_get(struct fake_sms_stats *stats);
+
+#endif /* FAKE_SMS_H */
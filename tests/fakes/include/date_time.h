@@ -0,0 +1,18 @@
+#ifndef DATE_TIME_H
+#define DATE_TIME_H
+
+/* The part of the nRF Connect SDK date_time library API used by the application. Tests implement the functions
+ *   they need.
+ */
+
+#include <zephyr.h>
+
+/**
+ * @brief Get the current UTC time
+ *
+ * @param unix_time_ms where the time [ms since 1970-01-01] is stored
+ * @return int 0 on success, -ENODATA if the time is not known
+ */
+int date_time_now(int64_t *unix_time_ms);
+
+#endif /* DATE_TIME_H */
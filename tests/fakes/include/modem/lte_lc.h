@@ -0,0 +1,48 @@
+#ifndef LTE_LC_H__
+#define LTE_LC_H__
+
+/* The part of the nRF Connect SDK LTE link control API used by the application */
+
+#include <zephyr.h>
+
+enum lte_lc_nw_reg_status {
+    LTE_LC_NW_REG_NOT_REGISTERED = 0,
+    LTE_LC_NW_REG_REGISTERED_HOME = 1,
+    LTE_LC_NW_REG_SEARCHING = 2,
+    LTE_LC_NW_REG_REGISTRATION_DENIED = 3,
+    LTE_LC_NW_REG_UNKNOWN = 4,
+    LTE_LC_NW_REG_REGISTERED_ROAMING = 5,
+    LTE_LC_NW_REG_UICC_FAIL = 90,
+};
+
+enum lte_lc_lte_mode {
+    LTE_LC_LTE_MODE_NONE = 0,
+    LTE_LC_LTE_MODE_LTEM = 7,
+    LTE_LC_LTE_MODE_NBIOT = 9,
+};
+
+enum lte_lc_evt_type {
+    LTE_LC_EVT_NW_REG_STATUS,
+    LTE_LC_EVT_PSM_UPDATE,
+    LTE_LC_EVT_EDRX_UPDATE,
+    LTE_LC_EVT_RRC_UPDATE,
+    LTE_LC_EVT_CELL_UPDATE,
+    LTE_LC_EVT_LTE_MODE_UPDATE,
+};
+
+struct lte_lc_evt {
+    enum lte_lc_evt_type type;
+    union {
+        enum lte_lc_nw_reg_status nw_reg_status;
+        enum lte_lc_lte_mode lte_mode;
+    };
+};
+
+typedef void (*lte_lc_evt_handler_t)(const struct lte_lc_evt *const evt);
+
+int lte_lc_init(void);
+void lte_lc_register_handler(lte_lc_evt_handler_t handler);
+int lte_lc_nw_reg_status_get(enum lte_lc_nw_reg_status *status);
+int lte_lc_lte_mode_get(enum lte_lc_lte_mode *mode);
+
+#endif /* LTE_LC_H__ */
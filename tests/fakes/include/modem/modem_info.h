@@ -0,0 +1,10 @@
+#ifndef MODEM_INFO_H_
+#define MODEM_INFO_H_
+
+/* The part of the nRF Connect SDK modem_info library API used by the application */
+
+#include <zephyr.h>
+
+int modem_info_init(void);
+
+#endif /* MODEM_INFO_H_ */
@@ -0,0 +1,66 @@
+#ifndef SMS_H_
+#define SMS_H_
+
+/* The part of the nRF Connect SDK SMS API used by the application */
+
+#include <zephyr.h>
+
+enum sms_type {
+    SMS_TYPE_DELIVER,
+    SMS_TYPE_STATUS_REPORT,
+};
+
+struct sms_time {
+    uint8_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    int8_t timezone;
+};
+
+struct sms_address {
+    char address_str[21];
+    uint8_t length;
+    uint8_t type;
+};
+
+struct sms_udh_app_port {
+    bool present;
+    uint16_t dest_port;
+    uint16_t src_port;
+};
+
+struct sms_udh_concat {
+    bool present;
+    uint16_t ref_number;
+    uint8_t total_msgs;
+    uint8_t seq_number;
+};
+
+struct sms_deliver_header {
+    struct sms_time time;
+    struct sms_address originating_address;
+    struct sms_udh_app_port app_port;
+    struct sms_udh_concat concatenated;
+};
+
+union sms_header {
+    struct sms_deliver_header deliver;
+};
+
+struct sms_data {
+    enum sms_type type;
+    union sms_header header;
+    int payload_len;
+    char *payload;
+};
+
+typedef void (*sms_callback_t)(struct sms_data *const data, void *context);
+
+int sms_register_listener(sms_callback_t listener, void *context);
+void sms_unregister_listener(int handle);
+int sms_send_text(const char *number, const char *text);
+
+#endif /* SMS_H_ */
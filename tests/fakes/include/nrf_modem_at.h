@@ -0,0 +1,8 @@
+#ifndef NRF_MODEM_AT_H__
+#define NRF_MODEM_AT_H__
+
+/* Included by the application, none of the AT API is used on native_posix */
+
+#include <zephyr.h>
+
+#endif /* NRF_MODEM_AT_H__ */
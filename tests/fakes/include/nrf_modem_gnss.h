@@ -0,0 +1,246 @@
+#ifndef NRF_MODEM_GNSS_H
+#define NRF_MODEM_GNSS_H
+
+/* The part of the nRF modem library GNSS API used by the application, with the values of the library, so the
+ *   modules using it build on native_posix. Tests implement the functions they need.
+ */
+
+#include <zephyr.h>
+
+#define NRF_MODEM_GNSS_MAX_SATELLITES   12
+#define NRF_MODEM_GNSS_NMEA_MAX_LEN     83
+
+/* Events passed to the event handler */
+#define NRF_MODEM_GNSS_EVT_PVT                  1
+#define NRF_MODEM_GNSS_EVT_FIX                  2
+#define NRF_MODEM_GNSS_EVT_NMEA                 3
+#define NRF_MODEM_GNSS_EVT_AGPS_REQ             4
+#define NRF_MODEM_GNSS_EVT_BLOCKED              5
+#define NRF_MODEM_GNSS_EVT_UNBLOCKED            6
+#define NRF_MODEM_GNSS_EVT_PERIODIC_WAKEUP      7
+#define NRF_MODEM_GNSS_EVT_SLEEP_AFTER_TIMEOUT  8
+#define NRF_MODEM_GNSS_EVT_SLEEP_AFTER_FIX      9
+#define NRF_MODEM_GNSS_EVT_REF_ALT_EXPIRED      10
+
+/* Data types for nrf_modem_gnss_read() */
+#define NRF_MODEM_GNSS_DATA_PVT         1
+#define NRF_MODEM_GNSS_DATA_NMEA        2
+#define NRF_MODEM_GNSS_DATA_AGPS_REQ    3
+
+#define NRF_MODEM_GNSS_SYSTEM_GPS_MASK  0x01
+#define NRF_MODEM_GNSS_SYSTEM_QZSS_MASK 0x04
+
+#define NRF_MODEM_GNSS_NMEA_GGA_MASK    0x01
+#define NRF_MODEM_GNSS_NMEA_GLL_MASK    0x02
+#define NRF_MODEM_GNSS_NMEA_GSA_MASK    0x04
+#define NRF_MODEM_GNSS_NMEA_GSV_MASK    0x08
+#define NRF_MODEM_GNSS_NMEA_RMC_MASK    0x10
+
+#define NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID           0x01
+#define NRF_MODEM_GNSS_PVT_FLAG_LEAP_SECOND_VALID   0x02
+#define NRF_MODEM_GNSS_PVT_FLAG_SLEEP_BETWEEN_PVT   0x04
+
+#define NRF_MODEM_GNSS_SV_FLAG_USED_IN_FIX  0x02
+#define NRF_MODEM_GNSS_SV_FLAG_UNHEALTHY    0x08
+
+/* Data for nrf_modem_gnss_nv_data_delete() */
+#define NRF_MODEM_GNSS_DELETE_EPHEMERIDES           0x001
+#define NRF_MODEM_GNSS_DELETE_ALMANACS              0x002
+#define NRF_MODEM_GNSS_DELETE_IONO_CORRECTION_DATA  0x004
+#define NRF_MODEM_GNSS_DELETE_LAST_GOOD_FIX         0x008
+#define NRF_MODEM_GNSS_DELETE_GPS_TOW               0x010
+#define NRF_MODEM_GNSS_DELETE_GPS_WEEK              0x020
+#define NRF_MODEM_GNSS_DELETE_UTC_DATA              0x040
+#define NRF_MODEM_GNSS_DELETE_GPS_TOW_PRECISION     0x100
+
+#define NRF_MODEM_GNSS_PSM_DISABLED                 0
+#define NRF_MODEM_GNSS_PSM_DUTY_CYCLING_PERFORMANCE 1
+#define NRF_MODEM_GNSS_PSM_DUTY_CYCLING_POWER       2
+
+/* Assistance data types */
+#define NRF_MODEM_GNSS_AGPS_UTC_PARAMETERS                  1
+#define NRF_MODEM_GNSS_AGPS_EPHEMERIDES                     2
+#define NRF_MODEM_GNSS_AGPS_ALMANAC                         3
+#define NRF_MODEM_GNSS_AGPS_KLOBUCHAR_IONOSPHERIC_CORRECTION 4
+#define NRF_MODEM_GNSS_AGPS_NEQUICK_IONOSPHERIC_CORRECTION  5
+#define NRF_MODEM_GNSS_AGPS_GPS_SYSTEM_CLOCK_AND_TOWS       6
+#define NRF_MODEM_GNSS_AGPS_LOCATION                        7
+#define NRF_MODEM_GNSS_AGPS_INTEGRITY                       8
+
+/* Assistance request flags */
+#define NRF_MODEM_GNSS_AGPS_GPS_UTC_REQUEST             0x01
+#define NRF_MODEM_GNSS_AGPS_KLOBUCHAR_REQUEST           0x02
+#define NRF_MODEM_GNSS_AGPS_NEQUICK_REQUEST             0x04
+#define NRF_MODEM_GNSS_AGPS_SYS_TIME_AND_SV_TOW_REQUEST 0x08
+#define NRF_MODEM_GNSS_AGPS_POSITION_REQUEST            0x10
+#define NRF_MODEM_GNSS_AGPS_INTEGRITY_REQUEST           0x20
+
+#define NRF_MODEM_GNSS_NUM_GPS_SATELLITES   32
+
+struct nrf_modem_gnss_datetime {
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t seconds;
+    uint16_t ms;
+};
+
+struct nrf_modem_gnss_sv {
+    uint16_t sv;
+    uint8_t signal;
+    uint16_t cn0;
+    int16_t elevation;
+    int16_t azimuth;
+    uint8_t flags;
+};
+
+struct nrf_modem_gnss_pvt_data_frame {
+    double latitude;
+    double longitude;
+    float altitude;
+    float accuracy;
+    float altitude_accuracy;
+    float speed;
+    float speed_accuracy;
+    float vertical_speed;
+    float vertical_speed_accuracy;
+    float heading;
+    float heading_accuracy;
+    struct nrf_modem_gnss_datetime datetime;
+    float pdop;
+    float hdop;
+    float vdop;
+    float tdop;
+    uint8_t flags;
+    struct nrf_modem_gnss_sv sv[NRF_MODEM_GNSS_MAX_SATELLITES];
+    uint16_t execution_time;
+};
+
+struct nrf_modem_gnss_nmea_data_frame {
+    char nmea_str[NRF_MODEM_GNSS_NMEA_MAX_LEN];
+};
+
+struct nrf_modem_gnss_agps_data_frame {
+    uint32_t sv_mask_ephe;
+    uint32_t sv_mask_alm;
+    uint32_t data_flags;
+};
+
+struct nrf_modem_gnss_agps_data_utc {
+    int32_t a1;
+    int32_t a0;
+    uint8_t tot;
+    uint8_t wn_t;
+    int8_t delta_tls;
+    uint8_t wn_lsf;
+    int8_t dn;
+    int8_t delta_tlsf;
+};
+
+struct nrf_modem_gnss_agps_data_ephemeris {
+    uint8_t sv_id;
+    uint8_t health;
+    uint16_t iodc;
+    uint16_t toc;
+    int8_t af2;
+    int16_t af1;
+    int32_t af0;
+    int8_t tgd;
+    uint8_t ura;
+    uint8_t fit_int;
+    uint16_t toe;
+    int32_t w;
+    int16_t delta_n;
+    int32_t m0;
+    int32_t omega_dot;
+    uint32_t e;
+    int16_t idot;
+    uint32_t sqrt_a;
+    int32_t i0;
+    int32_t omega0;
+    int16_t crs;
+    int16_t cis;
+    int16_t cus;
+    int16_t crc;
+    int16_t cic;
+    int16_t cuc;
+};
+
+struct nrf_modem_gnss_agps_data_almanac {
+    uint8_t sv_id;
+    uint8_t wn;
+    uint8_t toa;
+    uint8_t ioda;
+    uint16_t e;
+    int16_t delta_i;
+    int16_t omega_dot;
+    uint8_t sv_health;
+    uint32_t sqrt_a;
+    int32_t omega0;
+    int32_t w;
+    int32_t m0;
+    int16_t af0;
+    int16_t af1;
+};
+
+struct nrf_modem_gnss_agps_data_klobuchar {
+    int8_t alpha0;
+    int8_t alpha1;
+    int8_t alpha2;
+    int8_t alpha3;
+    int8_t beta0;
+    int8_t beta1;
+    int8_t beta2;
+    int8_t beta3;
+};
+
+struct nrf_modem_gnss_agps_data_tow_element {
+    uint16_t tlm;
+    uint8_t flags;
+};
+
+struct nrf_modem_gnss_agps_data_system_time_and_sv_tow {
+    uint16_t date_day;
+    uint32_t time_full_s;
+    uint16_t time_frac_ms;
+    uint32_t sv_mask;
+    struct nrf_modem_gnss_agps_data_tow_element sv_tow[NRF_MODEM_GNSS_NUM_GPS_SATELLITES];
+};
+
+struct nrf_modem_gnss_agps_data_location {
+    int32_t latitude;
+    int32_t longitude;
+    int16_t altitude;
+    uint8_t unc_semimajor;
+    uint8_t unc_semiminor;
+    uint8_t orientation_major;
+    uint8_t unc_altitude;
+    uint8_t confidence;
+};
+
+typedef void (*nrf_modem_gnss_event_handler_type_t)(int event);
+
+int32_t nrf_modem_gnss_event_handler_set(nrf_modem_gnss_event_handler_type_t handler);
+int32_t nrf_modem_gnss_system_mask_set(uint8_t system_mask);
+int32_t nrf_modem_gnss_fix_retry_set(uint16_t fix_retry);
+int32_t nrf_modem_gnss_fix_interval_set(uint16_t fix_interval);
+int32_t nrf_modem_gnss_nmea_mask_set(uint16_t nmea_mask);
+int32_t nrf_modem_gnss_power_mode_set(uint8_t mode);
+int32_t nrf_modem_gnss_start(void);
+int32_t nrf_modem_gnss_stop(void);
+int32_t nrf_modem_gnss_nv_data_delete(uint32_t nv_data);
+int32_t nrf_modem_gnss_read(void *buf, int32_t buf_len, int type);
+
+/**
+ * @brief Write assistance data to the GNSS
+ *
+ * @param buf the data
+ * @param buf_len length of the data
+ * @param type NRF_MODEM_GNSS_AGPS_* data type
+ * @return int32_t 0 on success, negative on fail
+ */
+int32_t nrf_modem_gnss_agps_write(void *buf, int32_t buf_len, uint16_t type);
+
+#endif /* NRF_MODEM_GNSS_H */
@@ -0,0 +1,239 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+
+#include "src/lib/event_bus.h"
+#include "src/positioning/gnss_schedule.h"
+
+/* Replays a recorded movement trace against the scheduler in simulated time. The searches are modelled from the
+ *   trace: with a sky view a search ends with a fix after TRACE_FIX_TIME, without one it runs until the fix retry
+ *   timeout of the scheduler. While tracking, continuous mode gives a fix every second and periodic mode one
+ *   TRACE_FIX_TIME after each fix interval.
+ */
+
+#define HOUR    3600
+#define DAY     (24 * HOUR)
+
+#define TRACE_DAYS              3
+/* Time from the start of a search to the fix with a sky view [s], the GNSS has recent data for a hot start */
+#define TRACE_FIX_TIME          10
+/* Interval between accelerometer triggers while the device moves [s] */
+#define TRACE_TRIGGER_INTERVAL  60
+
+struct trace_segment {
+    /** Start of the segment [s from the start of the trace]. */
+    uint32_t start;
+    /** Speed [km/h], 0 when stationary. */
+    uint16_t speed;
+    /** True if the GNSS has a sky view. */
+    bool sky;
+};
+
+static const struct trace_segment trace[] = {
+    /* Day 1: parked outside */
+    { 0, 0, true },
+    /* Day 2: commute */
+    { DAY, 0, true },
+    { DAY + 8 * HOUR, 50, true },
+    { DAY + 9 * HOUR, 0, true },
+    { DAY + 17 * HOUR, 50, true },
+    { DAY + 18 * HOUR, 0, true },
+    /* Day 3: stored indoors */
+    { 2 * DAY, 0, false },
+};
+
+EVENT_BUS_SUBSCRIBER_DEFINE(search_subscriber, APP_EVENT_GNSS_SEARCH_REQ);
+
+/* Scheduler statistics at the end of each day */
+static struct gnss_schedule_stats day_end[TRACE_DAYS];
+/* The GNSS keeps running after the first fix, the next fix is due at next_fix */
+static bool tracking;
+static uint16_t fix_interval;
+static int64_t next_fix;
+
+/**
+ * @brief Get the trace segment at a time
+ *
+ * @param time time from the start of the trace [s]
+ * @return int index of the segment
+ */
+static int trace_segment_get(uint32_t time)
+{
+    int idx = 0;
+
+    while ((idx + 1 < ARRAY_SIZE(trace)) && (trace[idx + 1].start <= time)) {
+        idx++;
+    }
+
+    return idx;
+}
+
+
+/**
+ * @brief Run a search as the GNSS would in the current trace segment
+ *
+ * @param segment the trace segment
+ */
+static void trace_search(const struct trace_segment *segment)
+{
+    struct gnss_schedule_params params;
+
+    gnss_schedule_search_start(k_uptime_get(), &params);
+
+    /* A fix retry timeout of 0 searches until a fix, which never comes without a sky view */
+    zassert_true(segment->sky || (0 != params.fix_retry), "Endless search without a sky view");
+
+    k_sleep(K_SECONDS(segment->sky ? TRACE_FIX_TIME : params.fix_retry));
+
+    tracking = (0 == gnss_schedule_search_done(k_uptime_get(), segment->sky, segment->speed / 3.6f));
+    zassert_true(!tracking || params.tracking, "Tracking after a single fix search");
+    fix_interval = params.fix_interval;
+    next_fix = k_uptime_get() + ((1 == fix_interval) ? 1 : fix_interval + TRACE_FIX_TIME) * MSEC_PER_SEC;
+}
+
+
+/**
+ * @brief Give the next fix while tracking, as the GNSS would in the current trace segment
+ *
+ * @param segment the trace segment
+ */
+static void trace_track(const struct trace_segment *segment)
+{
+    if (!segment->sky) {
+        tracking = false;
+        gnss_schedule_search_done(k_uptime_get(), false, 0.0f);
+        return;
+    }
+
+    switch (gnss_schedule_track_fix(k_uptime_get(), segment->speed / 3.6f)) {
+        case GNSS_SCHEDULE_TRACK_RESTART:
+            trace_search(segment);
+            break;
+        case GNSS_SCHEDULE_TRACK_STOP:
+            tracking = false;
+            break;
+        default:
+            next_fix = k_uptime_get() + ((1 == fix_interval) ? 1 : fix_interval + TRACE_FIX_TIME) * MSEC_PER_SEC;
+            break;
+    }
+}
+
+
+/**
+ * @brief Replay the trace, storing the scheduler statistics at the end of each day in day_end
+ *
+ */
+static void trace_replay(void)
+{
+    struct app_event evt;
+    int64_t start = k_uptime_get();
+    int64_t next_trigger = start;
+    int64_t now;
+    int64_t wake;
+    uint32_t time;
+    int idx;
+
+    gnss_schedule_init(start);
+
+    for (int day = 0; day < TRACE_DAYS; day++) {
+        while ((now = k_uptime_get()) < start + (int64_t)(day + 1) * DAY * MSEC_PER_SEC) {
+            time = (uint32_t)((now - start) / MSEC_PER_SEC);
+            idx = trace_segment_get(time);
+
+            if ((trace[idx].speed > 0) && (now >= next_trigger)) {
+                gnss_schedule_motion_set(now);
+                next_trigger = now + TRACE_TRIGGER_INTERVAL * MSEC_PER_SEC;
+            }
+
+            if (tracking && (now >= next_fix)) {
+                trace_track(&trace[idx]);
+                continue;
+            }
+
+            /* Wake for the next search request, trigger, segment or day, whichever comes first */
+            wake = start + (int64_t)(day + 1) * DAY * MSEC_PER_SEC;
+            if (idx + 1 < ARRAY_SIZE(trace)) {
+                wake = MIN(wake, start + (int64_t)trace[idx + 1].start * MSEC_PER_SEC);
+            }
+            if (trace[idx].speed > 0) {
+                wake = MIN(wake, next_trigger);
+            }
+            if (tracking) {
+                wake = MIN(wake, next_fix);
+            }
+
+            if (0 == event_bus_wait(&search_subscriber, &evt, K_MSEC(MAX(wake - now, 1)))) {
+                trace_search(&trace[idx]);
+            }
+        }
+
+        gnss_schedule_stats_get(&day_end[day]);
+    }
+} /* trace_replay */
+
+
+/**
+ * @brief Get the statistics of one day of the replay
+ *
+ * @param day the day
+ * @param stats where the statistics of the day are stored
+ */
+static void day_stats_get(int day, struct gnss_schedule_stats *stats)
+{
+    *stats = day_end[day];
+    if (day > 0) {
+        stats->searches -= day_end[day - 1].searches;
+        stats->timeouts -= day_end[day - 1].timeouts;
+        stats->fixes -= day_end[day - 1].fixes;
+        stats->on_time -= day_end[day - 1].on_time;
+    }
+
+    TC_PRINT("Day %d: %u searches, %u timeouts, %u fixes, GNSS on %u s (%u.%02u %%)\n", day + 1, stats->searches,
+      stats->timeouts, stats->fixes, (uint32_t)(stats->on_time / MSEC_PER_SEC), (uint32_t)(stats->on_time / (DAY * 10)),
+      (uint32_t)(stats->on_time / (DAY / 10)) % 100);
+}
+
+
+static void test_gnss_schedule_replay(void)
+{
+    struct gnss_schedule_stats parked;
+    struct gnss_schedule_stats commute;
+    struct gnss_schedule_stats indoors;
+
+    zassert_ok(event_bus_subscribe(&search_subscriber), "Subscribe failed");
+
+    trace_replay();
+
+    day_stats_get(0, &parked);
+    day_stats_get(1, &commute);
+    day_stats_get(2, &indoors);
+
+    /* Parked, the interval doubles up to the stationary maximum */
+    zassert_equal(parked.timeouts, 0, "%u timeouts with a sky view", parked.timeouts);
+    zassert_true(parked.searches <= 16, "%u searches while parked", parked.searches);
+    zassert_true(parked.on_time <= 5 * 60 * MSEC_PER_SEC, "GNSS on %u s while parked",
+      (uint32_t)(parked.on_time / MSEC_PER_SEC));
+
+    /* Two hours of driving are tracked about every CONFIG_GNSS_SCHEDULE_MOVING_DISTANCE meters, the GNSS keeps
+     *   running in periodic mode instead of a search per fix
+     */
+    zassert_true(commute.fixes >= 2 * HOUR / (CONFIG_GNSS_SCHEDULE_MOVING_INTERVAL_MAX + TRACE_FIX_TIME),
+      "%u fixes on the commute day", commute.fixes);
+    zassert_true(commute.searches < commute.fixes / 4, "%u searches for %u fixes", commute.searches,
+      commute.fixes);
+    zassert_true(commute.on_time <= HOUR * MSEC_PER_SEC, "GNSS on %u s on the commute day",
+      (uint32_t)(commute.on_time / MSEC_PER_SEC));
+
+    /* Indoors every search times out, the backoff keeps the time spent searching down */
+    zassert_equal(indoors.timeouts, indoors.searches, "%u of %u searches found a fix indoors", indoors.searches -
+      indoors.timeouts, indoors.searches);
+    zassert_true(indoors.on_time <= HOUR * MSEC_PER_SEC, "GNSS on %u s indoors",
+      (uint32_t)(indoors.on_time / MSEC_PER_SEC));
+} /* test_gnss_schedule_replay */
+
+
+void test_main(void)
+{
+    ztest_test_suite(gnss_schedule,
+      ztest_unit_test(test_gnss_schedule_replay));
+    ztest_run_test_suite(gnss_schedule);
+}
@@ -0,0 +1,187 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <modem/lte_lc.h>
+#include <modem/modem_info.h>
+
+#include "src/battery/battery.h"
+#include "src/lib/app_latency.h"
+#include "src/lib/common_events.h"
+#include "src/lib/event_bus.h"
+#include "src/lib/wakeup.h"
+#include "src/movement/movement.h"
+#include "tests/fakes/fake_adxl362.h"
+#include "tests/fakes/fake_gnss.h"
+#include "tests/fakes/fake_sms.h"
+
+/* Runs the application in simulated time with the GNSS, the SMS library and the ADXL362 faked. The device lies still
+ *   for the first hours, then the trace shakes it and the report is followed from the accelerometer interrupt to the
+ *   SMS.
+ */
+
+#define HOUR    (3600 * MSEC_PER_SEC)
+
+/* Time from the start of a search to the fix [ms], the GNSS has recent data for a hot start */
+#define GNSS_TTFF               10000
+#define GNSS_SEARCHES           64
+/* Time the threads and the SPI transfers may add between two stages of a report [ms] */
+#define STAGE_SLACK             1000
+/* Still from boot, the second hour is measured */
+#define IDLE_START              HOUR
+#define IDLE_END                (2 * HOUR)
+/* A stationary search and the report of its fix take about ten wakeups, there is one search in the idle hour */
+#define IDLE_WAKEUPS_MAX        30
+/* Time from the start of the vibration to the accelerometer interrupt [ms] */
+#define MOVEMENT_DETECT_MAX     2000
+
+static struct fake_gnss_search searches[GNSS_SEARCHES];
+
+/* Shaken along x, above the 510 mg activity threshold of the default profile */
+static const struct fake_adxl362_segment shake[] = {
+    { .start = 0, .amplitude = 800, .freq = 2.0f },
+};
+
+int lte_lc_init(void)
+{
+    return 0;
+}
+
+
+void lte_lc_register_handler(lte_lc_evt_handler_t handler)
+{
+}
+
+
+int lte_lc_nw_reg_status_get(enum lte_lc_nw_reg_status *status)
+{
+    *status = LTE_LC_NW_REG_REGISTERED_HOME;
+    return 0;
+}
+
+
+int lte_lc_lte_mode_get(enum lte_lc_lte_mode *mode)
+{
+    *mode = LTE_LC_LTE_MODE_LTEM;
+    return 0;
+}
+
+
+int modem_info_init(void)
+{
+    return 0;
+}
+
+
+uint16_t battery_voltage_get(void)
+{
+    return 4000;
+}
+
+
+void battery_sample_request(void)
+{
+}
+
+
+static void test_integration_idle(void)
+{
+    struct fake_adxl362_stats accel_start;
+    struct fake_adxl362_stats accel_end;
+    struct event_bus_stats bus_start;
+    struct event_bus_stats bus_end;
+    uint32_t wakeups;
+
+    k_sleep(K_TIMEOUT_ABS_MS(IDLE_START));
+
+    wakeups = wakeup_cpu_count_get();
+    event_bus_total_stats_get(&bus_start);
+    fake_adxl362_stats_get(&accel_start);
+
+    k_sleep(K_TIMEOUT_ABS_MS(IDLE_END));
+
+    wakeups = wakeup_cpu_count_get() - wakeups;
+    event_bus_total_stats_get(&bus_end);
+    fake_adxl362_stats_get(&accel_end);
+
+    TC_PRINT("Idle hour: %u CPU wakeups, %u event bus wakeups, %u accelerometer interrupts\n", wakeups,
+      bus_end.wakeups - bus_start.wakeups, accel_end.interrupts - accel_start.interrupts);
+
+    zassert_true(wakeups <= IDLE_WAKEUPS_MAX, "%u CPU wakeups in the idle hour", wakeups);
+    zassert_true(bus_end.wakeups - bus_start.wakeups <= IDLE_WAKEUPS_MAX, "%u event bus wakeups in the idle hour",
+      bus_end.wakeups - bus_start.wakeups);
+
+    /* Linked mode, the accelerometer is neither polled nor interrupts while the device is still */
+    zassert_equal(accel_end.interrupts, accel_start.interrupts, "Accelerometer interrupts while still");
+    zassert_equal(accel_end.transfers, accel_start.transfers, "Accelerometer transfers while still");
+} /* test_integration_idle */
+
+
+static void test_integration_movement_latency(void)
+{
+    struct app_latency_stats before;
+    struct app_latency_stats stats;
+    struct fake_sms_stats sms;
+    int64_t start;
+
+    app_latency_stats_get(&before);
+
+    /* Only the report of the movement counts */
+    while (0 == fake_sms_wait(K_NO_WAIT)) {
+    }
+
+    start = k_uptime_get();
+    fake_adxl362_trace_set(shake, ARRAY_SIZE(shake));
+
+    zassert_ok(fake_sms_wait(K_MSEC(MOVEMENT_DETECT_MAX + GNSS_TTFF + 2 * STAGE_SLACK)), "No SMS after the movement");
+
+    /* Still again, and let the report thread close the latency trace after the send */
+    fake_adxl362_trace_set(NULL, 0);
+    k_sleep(K_MSEC(STAGE_SLACK));
+
+    app_latency_stats_get(&stats);
+    fake_sms_stats_get(&sms);
+
+    TC_PRINT("Movement to SMS: %u ms, GNSS start %u ms, fix %u ms, sent %u ms after the trigger\n",
+      (uint32_t)(sms.last_time - start), stats.last[APP_LATENCY_GNSS_START], stats.last[APP_LATENCY_FIX],
+      stats.last[APP_LATENCY_SENT]);
+
+    zassert_equal(stats.cnt, before.cnt + 1, "The movement report was not traced");
+    zassert_true(sms.last_time - start <= MOVEMENT_DETECT_MAX + GNSS_TTFF + 2 * STAGE_SLACK,
+      "SMS %u ms after the movement", (uint32_t)(sms.last_time - start));
+
+    /* The trigger starts the search at once, the fix is sent at once with REPORT_BATCH_FLUSH_ON_MOVEMENT */
+    zassert_true(stats.last[APP_LATENCY_GNSS_START] <= STAGE_SLACK, "GNSS started %u ms after the trigger",
+      stats.last[APP_LATENCY_GNSS_START]);
+    zassert_true((stats.last[APP_LATENCY_FIX] - stats.last[APP_LATENCY_GNSS_START] >= GNSS_TTFF) &&
+      (stats.last[APP_LATENCY_FIX] - stats.last[APP_LATENCY_GNSS_START] <= GNSS_TTFF + STAGE_SLACK),
+      "Fix %u ms after the GNSS start", stats.last[APP_LATENCY_FIX] - stats.last[APP_LATENCY_GNSS_START]);
+    zassert_true(stats.last[APP_LATENCY_SENT] - stats.last[APP_LATENCY_FIX] <= STAGE_SLACK,
+      "Sent %u ms after the fix", stats.last[APP_LATENCY_SENT] - stats.last[APP_LATENCY_FIX]);
+} /* test_integration_movement_latency */
+
+
+void test_main(void)
+{
+    for (int i = 0; i < ARRAY_SIZE(searches); i++) {
+        searches[i] = (struct fake_gnss_search) {
+            .ttff = GNSS_TTFF,
+            .latitude = 57.70,
+            .longitude = 11.97,
+            .sv_used = 8,
+            .pdop = 1.5f,
+            .hdop = 1.0f,
+        };
+    }
+    fake_gnss_script_set(searches, ARRAY_SIZE(searches));
+
+    /* As the application main() */
+    if (0 != movement_init()) {
+        TC_PRINT("Failed to init movement\n");
+    }
+    k_event_wait_all(&app_events, APP_EVENT_GNSS_INITIALIZED | APP_EVENT_SMS_INITIALIZED, 0, K_FOREVER);
+    app_events_post(APP_EVENT_APPLICATION_INITIALIZED);
+
+    ztest_test_suite(integration,
+      ztest_unit_test(test_integration_idle),
+      ztest_unit_test(test_integration_movement_latency));
+    ztest_run_test_suite(integration);
+}
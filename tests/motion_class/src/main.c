@@ -0,0 +1,249 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/movement/motion_class.h"
+
+/* Replays motion traces through the classifier one FIFO batch at a time, with the uptime of each batch, and counts
+ *   the threshold triggers the accelerometer would have given, the windows per class and the GNSS requests.
+ */
+
+#define WINDOW_SAMPLES      CONFIG_ACCELEROMETER_FIFO_WATERMARK
+#define WINDOW_TIME         (WINDOW_SAMPLES * MSEC_PER_SEC * 1000 / ACCELEROMETER_ODR_MHZ)
+#define SUSTAINED_TIME      (CONFIG_MOVEMENT_CLASS_SUSTAINED_TIME * MSEC_PER_SEC)
+#define PI                  3.14159265f
+
+/* Activity threshold of the person profile, referenced to the device lying flat [mg] */
+#define TRIGGER_MG          300
+/* Sensor noise, peak [mg] */
+#define NOISE_MG            8
+
+/** @brief Motion of a trace segment. */
+enum trace_motion {
+    /** Lying flat. */
+    TRACE_STILL,
+    /** Flat, with a short knock at the start of the segment. */
+    TRACE_BUMP,
+    /** Carried while walking, two steps per second. */
+    TRACE_WALK,
+    /** Broadband road vibration. */
+    TRACE_VEHICLE,
+};
+
+/** @brief A segment of a motion trace. */
+struct trace_segment {
+    enum trace_motion motion;
+    /** Duration, a multiple of WINDOW_TIME [ms]. */
+    uint32_t duration;
+};
+
+/** @brief Result of a replay. */
+struct trace_result {
+    /** Windows with a sample above TRIGGER_MG. */
+    uint32_t triggers;
+    /** GNSS requests. */
+    uint32_t requests;
+    /** Trace time of the first GNSS request, -1 if none [ms]. */
+    int64_t first_request;
+    struct motion_class_stats stats;
+};
+
+static int16_t window[WINDOW_SAMPLES][ACCELEROMETER_CHANNELS];
+static uint32_t seed;
+
+/**
+ * @brief Uniform noise
+ *
+ * @param peak largest absolute value
+ * @return int16_t the noise
+ */
+static int16_t trace_noise(int16_t peak)
+{
+    seed = seed * 1103515245U + 12345U;
+
+    return (int16_t)((int32_t)((seed >> 16) % (2 * peak + 1)) - peak);
+}
+
+
+/**
+ * @brief Get a sample of a segment
+ *
+ * @param motion motion of the segment
+ * @param t time since the start of the segment [ms]
+ * @param xyz where the sample is stored [mg]
+ */
+static void trace_sample_get(enum trace_motion motion, uint32_t t, int16_t *xyz)
+{
+    float s = t / 1000.0f;
+
+    xyz[0] = trace_noise(NOISE_MG);
+    xyz[1] = trace_noise(NOISE_MG);
+    xyz[2] = 1000 + trace_noise(NOISE_MG);
+
+    switch (motion) {
+        case TRACE_BUMP:
+            if (t < 250) {
+                xyz[0] += 1500;
+            }
+            break;
+        case TRACE_WALK:
+            /* Vertical bounce at the step frequency and a sway at half of it */
+            xyz[0] += (int16_t)(150.0f * sinf(2.0f * PI * 1.0f * s));
+            xyz[2] += (int16_t)(350.0f * sinf(2.0f * PI * 2.0f * s));
+            break;
+        case TRACE_VEHICLE:
+            xyz[0] += trace_noise(60);
+            xyz[1] += trace_noise(60);
+            xyz[2] += trace_noise(100);
+            break;
+        default:
+            break;
+    }
+}
+
+
+/**
+ * @brief Replay a trace through a freshly initialized classifier
+ *
+ * @param trace the segments
+ * @param cnt number of segments
+ * @param result where the result is stored
+ */
+static void trace_replay(const struct trace_segment *trace, int cnt, struct trace_result *result)
+{
+    int64_t now = 0;
+    bool trigger;
+
+    motion_class_init();
+    memset(result, 0, sizeof(*result));
+    result->first_request = -1;
+    seed = 1;
+
+    for (int i = 0; i < cnt; i++) {
+        for (uint32_t start = 0; start < trace[i].duration; start += WINDOW_TIME) {
+            trigger = false;
+            for (int j = 0; j < WINDOW_SAMPLES; j++) {
+                trace_sample_get(trace[i].motion, start + j * WINDOW_TIME / WINDOW_SAMPLES, window[j]);
+                trigger |= (abs(window[j][0]) > TRIGGER_MG) || (abs(window[j][1]) > TRIGGER_MG) ||
+                  (abs(window[j][2] - 1000) > TRIGGER_MG);
+            }
+
+            /* The threshold interrupt comes before the FIFO batch it is in */
+            if (trigger) {
+                motion_class_trigger_count();
+                result->triggers++;
+            }
+
+            now += WINDOW_TIME;
+            if (motion_class_window_add(now, window, WINDOW_SAMPLES, NULL)) {
+                result->requests++;
+                if (result->first_request < 0) {
+                    result->first_request = now;
+                }
+            }
+        }
+    }
+
+    motion_class_stats_get(&result->stats);
+
+    TC_PRINT("%u triggers, %u requests, first at %d ms, still/handled/walk/vehicle %u/%u/%u/%u\n", result->triggers,
+      result->requests, (int)result->first_request, result->stats.windows[MOTION_CLASS_STILL],
+      result->stats.windows[MOTION_CLASS_HANDLED], result->stats.windows[MOTION_CLASS_WALKING],
+      result->stats.windows[MOTION_CLASS_VEHICLE]);
+} /* trace_replay */
+
+
+static void test_motion_class_still(void)
+{
+    static const struct trace_segment trace[] = {
+        { TRACE_STILL, 10 * 60 * MSEC_PER_SEC },
+    };
+    struct trace_result result;
+
+    trace_replay(trace, ARRAY_SIZE(trace), &result);
+
+    zassert_equal(result.triggers, 0, NULL);
+    zassert_equal(result.requests, 0, NULL);
+    zassert_equal(result.stats.windows[MOTION_CLASS_STILL], 10 * 60 * MSEC_PER_SEC / WINDOW_TIME, NULL);
+}
+
+
+static void test_motion_class_handled(void)
+{
+    struct trace_segment trace[2 * 30];
+    struct trace_result result;
+
+    /* Knocked every 20 s for ten minutes, e.g. on a shelf or a desk */
+    for (int i = 0; i < ARRAY_SIZE(trace); i += 2) {
+        trace[i] = (struct trace_segment) { TRACE_BUMP, WINDOW_TIME };
+        trace[i + 1] = (struct trace_segment) { TRACE_STILL, 20 * MSEC_PER_SEC - WINDOW_TIME };
+    }
+
+    trace_replay(trace, ARRAY_SIZE(trace), &result);
+
+    /* Every knock is a threshold trigger, and a false one */
+    zassert_equal(result.triggers, ARRAY_SIZE(trace) / 2, NULL);
+    zassert_equal(result.stats.triggers, result.triggers, NULL);
+    zassert_equal(result.requests, 0, "%u GNSS requests for knocks", result.requests);
+    zassert_equal(result.stats.windows[MOTION_CLASS_HANDLED], ARRAY_SIZE(trace) / 2, NULL);
+}
+
+
+static void test_motion_class_walking(void)
+{
+    static const struct trace_segment trace[] = {
+        { TRACE_STILL, 10 * MSEC_PER_SEC },
+        { TRACE_WALK, 52 * WINDOW_TIME },
+        { TRACE_STILL, 60 * MSEC_PER_SEC },
+    };
+    struct trace_result result;
+
+    trace_replay(trace, ARRAY_SIZE(trace), &result);
+
+    zassert_true(result.triggers > 0, NULL);
+    zassert_equal(result.stats.windows[MOTION_CLASS_WALKING], 52, NULL);
+
+    /* GNSS after the sustained time of walking, and again every sustained time while it goes on */
+    zassert_true(result.first_request >= 10 * MSEC_PER_SEC + SUSTAINED_TIME, "Requested at %d ms",
+      (int)result.first_request);
+    zassert_true(result.first_request <= 10 * MSEC_PER_SEC + SUSTAINED_TIME + WINDOW_TIME, "Requested at %d ms",
+      (int)result.first_request);
+    zassert_equal(result.requests, 3, NULL);
+}
+
+
+static void test_motion_class_vehicle_stops(void)
+{
+    static const struct trace_segment trace[] = {
+        { TRACE_VEHICLE, 8 * WINDOW_TIME },
+        /* A red light, shorter than the gap time */
+        { TRACE_STILL, 3 * WINDOW_TIME },
+        { TRACE_VEHICLE, 8 * WINDOW_TIME },
+        /* Parked, longer than the gap time, the run ends */
+        { TRACE_STILL, 10 * WINDOW_TIME },
+        { TRACE_VEHICLE, 8 * WINDOW_TIME },
+    };
+    struct trace_result result;
+
+    trace_replay(trace, ARRAY_SIZE(trace), &result);
+
+    /* Road vibration stays below the activity threshold */
+    zassert_equal(result.triggers, 0, NULL);
+    zassert_equal(result.stats.windows[MOTION_CLASS_VEHICLE], 24, NULL);
+
+    /* The red light does not restart the sustained time, the short drive after parking is not reported */
+    zassert_equal(result.requests, 1, NULL);
+}
+
+
+void test_main(void)
+{
+    ztest_test_suite(motion_class,
+      ztest_unit_test(test_motion_class_still),
+      ztest_unit_test(test_motion_class_handled),
+      ztest_unit_test(test_motion_class_walking),
+      ztest_unit_test(test_motion_class_vehicle_stops));
+    ztest_run_test_suite(motion_class);
+}
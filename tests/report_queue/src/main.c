@@ -0,0 +1,340 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "src/report/report_batch.h"
+#include "src/report/report_queue.h"
+#include "src/report/report_sink.h"
+#include "src/track_log/track_log.h"
+
+#define LOG_MAX     64
+#define SENT_MAX    64
+
+/* The track log, in RAM */
+static struct {
+    struct track_log_record record;
+    bool read;
+} log_entries[LOG_MAX];
+static int log_cnt;
+static uint32_t log_seq = 1000;
+
+/* Timestamps of the fixes the sink sent */
+static uint32_t sent[SENT_MAX];
+static int sent_cnt;
+/* Number of sends that succeed before the sink fails, negative to never fail */
+static int sink_ok_cnt = -1;
+
+int track_log_append(const struct position_record *record)
+{
+    if (log_cnt >= ARRAY_SIZE(log_entries)) {
+        return -ENOMEM;
+    }
+
+    log_entries[log_cnt].record.seq = log_seq++;
+    log_entries[log_cnt].record.record = *record;
+    log_entries[log_cnt].read = false;
+    log_cnt++;
+
+    return 0;
+}
+
+
+int track_log_read(struct track_log_record *records, size_t max_cnt)
+{
+    int cnt = 0;
+
+    for (int i = 0; (i < log_cnt) && (cnt < max_cnt); i++) {
+        if (!log_entries[i].read) {
+            records[cnt++] = log_entries[i].record;
+        }
+    }
+
+    return cnt;
+}
+
+
+int track_log_read_from(uint32_t seq, struct track_log_record *records, size_t max_cnt)
+{
+    int cnt = 0;
+
+    for (int i = 0; (i < log_cnt) && (cnt < max_cnt); i++) {
+        if (!log_entries[i].read && ((int32_t)(log_entries[i].record.seq - seq) >= 0)) {
+            records[cnt++] = log_entries[i].record;
+        }
+    }
+
+    return cnt;
+}
+
+
+int track_log_consume(uint32_t seq)
+{
+    for (int i = 0; i < log_cnt; i++) {
+        if ((int32_t)(log_entries[i].record.seq - seq) <= 0) {
+            log_entries[i].read = true;
+        }
+    }
+
+    return 0;
+}
+
+
+void track_log_stats_get(struct track_log_stats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < log_cnt; i++) {
+        stats->count += !log_entries[i].read;
+    }
+    stats->appended = log_cnt;
+}
+
+
+/**
+ * @brief Read a zigzag encoded varint
+ *
+ * @param data the report
+ * @param pos position of the varint, moved past it
+ * @return int32_t the value
+ */
+static int32_t varint_get(const uint8_t *data, size_t *pos)
+{
+    uint32_t zigzag = 0;
+    int shift = 0;
+
+    do {
+        zigzag |= (uint32_t)(data[*pos] & 0x7f) << shift;
+        shift += 7;
+    } while (data[(*pos)++] & 0x80);
+
+    return (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+}
+
+
+int report_sink_send(const uint8_t *data, size_t len)
+{
+    size_t pos = 2;
+    uint32_t timestamp = 0;
+
+    if (0 == sink_ok_cnt) {
+        return -EIO;
+    }
+    sink_ok_cnt -= (sink_ok_cnt > 0);
+
+    /* Voltage, then the timestamp, latitude, longitude and altitude deltas and the accuracy of each fix */
+    varint_get(data, &pos);
+    for (int i = 0; i <= (data[0] & 0x0f); i++) {
+        timestamp += varint_get(data, &pos);
+        zassert_true(sent_cnt < ARRAY_SIZE(sent), "Too many fixes sent");
+        sent[sent_cnt++] = timestamp;
+        for (int j = 0; j < 4; j++) {
+            varint_get(data, &pos);
+        }
+    }
+    zassert_equal(pos, len, "Report of %u bytes decoded to %u", len, pos);
+
+    return 0;
+}
+
+
+/**
+ * @brief Batch a fix and queue the batch, like the report module does
+ *
+ * @param timestamp timestamp of the fix
+ * @param movement true to queue a movement alert, false for a periodic position
+ */
+static void report_add(uint32_t timestamp, bool movement)
+{
+    const struct position_record record = {
+        .timestamp = timestamp,
+        .latitude = 576000000,
+        .longitude = 117000000,
+    };
+    struct report_batch_log log;
+    const uint8_t *data;
+    int len;
+    int retval;
+
+    if (movement) {
+        report_batch_movement_set();
+    }
+    zassert_true(report_batch_add(&record, 3700) >= 0, "Fix not batched");
+
+    len = report_batch_data_get(&data);
+    zassert_true(len > 0, "No batch");
+    retval = report_queue_put(movement ? REPORT_QUEUE_PRIO_ALERT : REPORT_QUEUE_PRIO_POSITION, data, len,
+      (0 == report_batch_log_get(&log)) ? &log : NULL);
+    zassert_ok(retval, "Batch not queued");
+    report_batch_sent(retval, REPORT_BATCH_FLUSH_COUNT);
+
+    report_queue_flush();
+}
+
+
+/**
+ * @brief Let the sink send everything queued, ending the back-off
+ *
+ */
+static void queue_send(void)
+{
+    sink_ok_cnt = -1;
+    report_queue_link_up();
+    report_queue_flush();
+}
+
+
+/**
+ * @brief Start a test with an empty queue and track log holding the fixes with timestamps 1 to cnt
+ *
+ * @param cnt number of fixes in the track log
+ */
+static void setup(int cnt)
+{
+    struct report_queue_stats stats;
+
+    queue_send();
+    report_queue_stats_get(&stats);
+    zassert_equal(stats.count, 0, "%u reports left in the queue", stats.count);
+
+    log_cnt = 0;
+    sent_cnt = 0;
+    for (uint32_t i = 1; i <= cnt; i++) {
+        const struct position_record record = { .timestamp = i };
+
+        zassert_ok(track_log_append(&record), NULL);
+    }
+}
+
+
+/**
+ * @brief Check that a fix was sent exactly once
+ *
+ * @param timestamp timestamp of the fix
+ */
+static void assert_sent_once(uint32_t timestamp)
+{
+    int cnt = 0;
+
+    for (int i = 0; i < sent_cnt; i++) {
+        cnt += (sent[i] == timestamp);
+    }
+    zassert_equal(cnt, 1, "Fix %u sent %d times", timestamp, cnt);
+}
+
+
+/* Each report queued while the sink fails carries the track log fixes no earlier report holds */
+static void test_report_queue_log_not_repeated(void)
+{
+    struct track_log_stats stats;
+    const struct position_record record = { .timestamp = 6 };
+
+    setup(5);
+    sink_ok_cnt = 0;
+
+    report_add(101, true);
+    zassert_ok(track_log_append(&record), NULL);
+    report_add(102, true);
+    zassert_equal(sent_cnt, 0, "Sent while the sink fails");
+
+    queue_send();
+
+    zassert_equal(sent_cnt, 8, "Sent %d fixes", sent_cnt);
+    for (uint32_t i = 1; i <= 6; i++) {
+        assert_sent_once(i);
+    }
+    assert_sent_once(101);
+    assert_sent_once(102);
+
+    track_log_stats_get(&stats);
+    zassert_equal(stats.count, 0, "%u fixes left unread", stats.count);
+}
+
+
+/* A periodic position that is superseded hands its track log fixes to the next one */
+static void test_report_queue_log_superseded(void)
+{
+    struct track_log_stats stats;
+
+    setup(3);
+    sink_ok_cnt = 0;
+
+    report_add(101, false);
+    report_add(102, false);
+    report_add(103, false);
+
+    queue_send();
+
+    zassert_equal(sent_cnt, 5, "Sent %d fixes", sent_cnt);
+    for (uint32_t i = 1; i <= 3; i++) {
+        assert_sent_once(i);
+    }
+    assert_sent_once(101);
+    assert_sent_once(103);
+
+    /* The fix of the second position went to the track log when the last one superseded it */
+    track_log_stats_get(&stats);
+    zassert_equal(stats.count, 1, "%u fixes left unread", stats.count);
+
+    report_add(104, false);
+    zassert_equal(sent_cnt, 7, "Sent %d fixes", sent_cnt);
+    assert_sent_once(102);
+    assert_sent_once(104);
+}
+
+
+/* A movement alert sent ahead of an older periodic position must not mark the fixes of the position as read */
+static void test_report_queue_log_sent_out_of_order(void)
+{
+    struct track_log_stats stats;
+    const struct position_record records[] = { { .timestamp = 4 }, { .timestamp = 5 } };
+
+    setup(3);
+    sink_ok_cnt = 0;
+
+    report_add(101, false);
+    zassert_ok(track_log_append(&records[0]), NULL);
+    zassert_ok(track_log_append(&records[1]), NULL);
+
+    /* The alert goes first, the position fails until it is dropped */
+    sink_ok_cnt = 1;
+    report_queue_link_up();
+    report_add(102, true);
+    for (int i = 2; i < CONFIG_REPORT_QUEUE_SEND_ATTEMPTS; i++) {
+        report_queue_link_up();
+        report_queue_flush();
+    }
+
+    zassert_equal(sent_cnt, 3, "Sent %d fixes", sent_cnt);
+    assert_sent_once(4);
+    assert_sent_once(5);
+    assert_sent_once(102);
+
+    /* The fixes of the position and its fresh fix, which went to the track log when it was dropped */
+    track_log_stats_get(&stats);
+    zassert_equal(stats.count, 6, "%u fixes left unread", stats.count);
+
+    report_add(103, false);
+    queue_send();
+    report_add(104, false);
+
+    zassert_equal(sent_cnt, 9, "Sent %d fixes", sent_cnt);
+    for (uint32_t i = 1; i <= 5; i++) {
+        assert_sent_once(i);
+    }
+    for (uint32_t i = 101; i <= 104; i++) {
+        assert_sent_once(i);
+    }
+
+    track_log_stats_get(&stats);
+    zassert_equal(stats.count, 0, "%u fixes left unread", stats.count);
+} /* test_report_queue_log_sent_out_of_order */
+
+
+void test_main(void)
+{
+    ztest_test_suite(report_queue,
+      ztest_unit_test(test_report_queue_log_not_repeated),
+      ztest_unit_test(test_report_queue_log_superseded),
+      ztest_unit_test(test_report_queue_log_sent_out_of_order));
+
+    ztest_run_test_suite(report_queue);
+}
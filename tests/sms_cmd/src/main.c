@@ -0,0 +1,137 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "src/lib/event_bus.h"
+#include "src/movement/movement_profile.h"
+#include "src/sms/sms_cmd.h"
+
+#define POSTED_MAX      8
+#define ARGS_LEN_MAX    64
+
+/* Events posted by the commands, in order */
+static app_events_t posted[POSTED_MAX];
+static int posted_cnt;
+/* Arguments of the last Profile command */
+static char profile_args[ARGS_LEN_MAX];
+static int profile_cnt;
+static int profile_result;
+
+void event_bus_post(app_events_t type)
+{
+    zassert_true(posted_cnt < POSTED_MAX, "More than %d events", POSTED_MAX);
+    posted[posted_cnt++] = type;
+}
+
+
+int movement_profile_request(const char *cmd)
+{
+    strncpy(profile_args, cmd, sizeof(profile_args) - 1);
+    profile_cnt++;
+
+    return profile_result;
+}
+
+
+/**
+ * @brief Dispatch a text and check the events it posts
+ *
+ * @param text the received text
+ * @param cnt number of commands expected to run
+ * @param events the events expected, in order
+ * @param events_cnt number of events
+ */
+static void dispatch(const char *text, int cnt, const app_events_t *events, int events_cnt)
+{
+    char buf[ARGS_LEN_MAX];
+
+    posted_cnt = 0;
+    profile_cnt = 0;
+    memset(profile_args, 0, sizeof(profile_args));
+
+    /* The dispatcher changes the text */
+    strncpy(buf, text, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    zassert_equal(sms_cmd_dispatch(buf), cnt, "Wrong number of commands in \"%s\"", text);
+    zassert_equal(posted_cnt, events_cnt, "%d events for \"%s\"", posted_cnt, text);
+    for (int i = 0; i < events_cnt; i++) {
+        zassert_equal(posted[i], events[i], "Event %d of \"%s\" is 0x%x", i, text, posted[i]);
+    }
+}
+
+
+static void test_sms_cmd_each(void)
+{
+    static const struct {
+        const char *text;
+        app_events_t event;
+    } cmds[] = {
+        { "Status", APP_EVENT_GNSS_SEARCH_REQ },
+        { "Log", APP_EVENT_SMS_LOG_SEND },
+        { "Stats", APP_EVENT_SMS_STATS_SEND },
+        { "Energy", APP_EVENT_SMS_ENERGY_SEND },
+        { "Uplink", APP_EVENT_SMS_UPLINK_SEND },
+    };
+
+    /* Every name is found through the hash table */
+    for (int i = 0; i < ARRAY_SIZE(cmds); i++) {
+        dispatch(cmds[i].text, 1, &cmds[i].event, 1);
+    }
+
+    dispatch("Profile", 1, NULL, 0);
+    zassert_equal(profile_cnt, 1, NULL);
+    zassert_equal(strcmp(profile_args, ""), 0, "Profile arguments \"%s\"", profile_args);
+}
+
+
+static void test_sms_cmd_several(void)
+{
+    static const app_events_t events[] = {
+        APP_EVENT_SMS_LOG_SEND, APP_EVENT_SMS_STATS_SEND, APP_EVENT_SMS_ENERGY_SEND,
+    };
+
+    dispatch("Log;Stats\nEnergy", 3, events, ARRAY_SIZE(events));
+
+    /* Empty commands, spaces around the names and a trailing separator are skipped */
+    dispatch(";;  ; Log ;\n", 1, events, 1);
+}
+
+
+static void test_sms_cmd_unknown(void)
+{
+    static const app_events_t events[] = { APP_EVENT_SMS_LOG_SEND };
+
+    /* Names match exactly, an unknown command does not stop the ones after it */
+    dispatch("Stat;Statsx;stats;Foo bar;Log", 1, events, 1);
+    dispatch("", 0, NULL, 0);
+}
+
+
+static void test_sms_cmd_args(void)
+{
+    static const app_events_t events[] = { APP_EVENT_SMS_STATS_SEND };
+
+    dispatch("Profile   vehicle 400 25 4 500;Stats", 2, events, ARRAY_SIZE(events));
+    zassert_equal(profile_cnt, 1, NULL);
+    zassert_equal(strcmp(profile_args, "vehicle 400 25 4 500"), 0, "Profile arguments \"%s\"", profile_args);
+
+    /* A failing command still counts as run */
+    profile_result = -EINVAL;
+    dispatch("Profile nope;Stats", 2, events, ARRAY_SIZE(events));
+    zassert_equal(strcmp(profile_args, "nope"), 0, "Profile arguments \"%s\"", profile_args);
+    profile_result = 0;
+}
+
+
+void test_main(void)
+{
+    sms_cmd_init();
+
+    ztest_test_suite(sms_cmd,
+      ztest_unit_test(test_sms_cmd_each),
+      ztest_unit_test(test_sms_cmd_several),
+      ztest_unit_test(test_sms_cmd_unknown),
+      ztest_unit_test(test_sms_cmd_args));
+    ztest_run_test_suite(sms_cmd);
+}
@@ -0,0 +1,168 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "src/sms/sms_concat.h"
+
+#define TIMEOUT     (CONFIG_SMS_CONCAT_TIMEOUT * MSEC_PER_SEC)
+
+static const char *const parts[] = { "Log;Sta", "ts;Prof", "ile person" };
+static const char full[] = "Log;Stats;Profile person";
+
+/* Uptime of the tests [ms], every test starts after the partial SMS of the ones before have timed out */
+static int64_t now;
+
+/**
+ * @brief Add a part of the test message
+ *
+ * @param ref reference number
+ * @param seq sequence number of the part, starting from 1
+ * @param out where the reassembled text is stored
+ * @return int the return value of sms_concat_add()
+ */
+static int part_add(uint16_t ref, uint8_t seq, char **out)
+{
+    return sms_concat_add(now, ref, seq, ARRAY_SIZE(parts), parts[seq - 1], strlen(parts[seq - 1]), out);
+}
+
+
+/**
+ * @brief Add the parts of the test message in an order and check the reassembled text
+ *
+ * @param ref reference number
+ * @param order sequence numbers in the order they are received, the text is complete after the last
+ * @param cnt number of sequence numbers
+ */
+static void message_add(uint16_t ref, const uint8_t *order, int cnt)
+{
+    char *text = NULL;
+
+    for (int i = 0; i < cnt - 1; i++) {
+        zassert_equal(part_add(ref, order[i], &text), 0, "Part %u completed the text", order[i]);
+        now += MSEC_PER_SEC;
+    }
+
+    zassert_equal(part_add(ref, order[cnt - 1], &text), strlen(full), "Text not complete");
+    zassert_not_null(text, NULL);
+    zassert_equal(strcmp(text, full), 0, "Reassembled \"%s\"", text);
+
+    sms_concat_release(text);
+}
+
+
+static void test_sms_concat_out_of_order(void)
+{
+    static const uint8_t in_order[] = { 1, 2, 3 };
+    static const uint8_t reversed[] = { 3, 2, 1 };
+    static const uint8_t mixed[] = { 2, 3, 1 };
+
+    message_add(1, in_order, ARRAY_SIZE(in_order));
+    message_add(2, reversed, ARRAY_SIZE(reversed));
+    message_add(3, mixed, ARRAY_SIZE(mixed));
+
+    zassert_equal(sms_concat_expire(now), -1, "Parts left after complete texts");
+}
+
+
+static void test_sms_concat_duplicates(void)
+{
+    static const uint8_t order[] = { 2, 2, 1, 2, 3 };
+    uint32_t evicted = sms_concat_evicted_get();
+    char *text = NULL;
+
+    /* A duplicate is ignored, also one with other text */
+    zassert_equal(sms_concat_add(now, 4, 1, ARRAY_SIZE(parts), parts[0], strlen(parts[0]), &text), 0, NULL);
+    zassert_equal(sms_concat_add(now, 4, 1, ARRAY_SIZE(parts), "Garbage", 7, &text), 0, NULL);
+    message_add(4, &order[3], 2);
+
+    message_add(5, order, ARRAY_SIZE(order));
+
+    /* A late duplicate after the text was handled starts a new SMS, which times out */
+    zassert_equal(part_add(5, 2, &text), 0, NULL);
+    zassert_equal(sms_concat_expire(now), now + TIMEOUT, NULL);
+    now += TIMEOUT;
+    zassert_equal(sms_concat_expire(now), -1, NULL);
+    zassert_equal(sms_concat_evicted_get() - evicted, 1, NULL);
+}
+
+
+static void test_sms_concat_timeout(void)
+{
+    uint32_t evicted = sms_concat_evicted_get();
+    int64_t first = now;
+    char *text = NULL;
+
+    zassert_equal(sms_concat_expire(now), -1, "Parts left from the tests before");
+
+    zassert_equal(part_add(6, 1, &text), 0, NULL);
+    now += TIMEOUT / 2;
+    zassert_equal(part_add(7, 1, &text), 0, NULL);
+
+    /* The timer wakes up for the oldest SMS first */
+    zassert_equal(sms_concat_expire(now), first + TIMEOUT, NULL);
+    now = first + TIMEOUT - 1;
+    zassert_equal(sms_concat_expire(now), first + TIMEOUT, NULL);
+    zassert_equal(sms_concat_evicted_get(), evicted, NULL);
+
+    /* Without another part, only the timer frees it */
+    now++;
+    zassert_equal(sms_concat_expire(now), first + TIMEOUT / 2 + TIMEOUT, NULL);
+    zassert_equal(sms_concat_evicted_get() - evicted, 1, NULL);
+
+    /* The rest of the timed out SMS does not complete it */
+    zassert_equal(part_add(6, 2, &text), 0, NULL);
+    zassert_equal(part_add(6, 3, &text), 0, NULL);
+
+    now += TIMEOUT;
+    zassert_equal(sms_concat_expire(now), -1, NULL);
+    zassert_equal(sms_concat_evicted_get() - evicted, 3, NULL);
+}
+
+
+static void test_sms_concat_slots_full(void)
+{
+    static const uint8_t order[] = { 2, 3 };
+    uint32_t evicted = sms_concat_evicted_get();
+    char *text = NULL;
+
+    /* One more SMS than slots, the oldest is dropped */
+    for (int i = 0; i <= CONFIG_SMS_CONCAT_SLOTS; i++) {
+        zassert_equal(part_add(10 + i, 1, &text), 0, NULL);
+        now += MSEC_PER_SEC;
+    }
+    zassert_equal(sms_concat_evicted_get() - evicted, 1, NULL);
+
+    zassert_equal(part_add(10, 2, &text), 0, NULL);
+    zassert_equal(sms_concat_evicted_get() - evicted, 2, NULL);
+
+    message_add(10 + CONFIG_SMS_CONCAT_SLOTS, order, ARRAY_SIZE(order));
+
+    now += TIMEOUT;
+    zassert_equal(sms_concat_expire(now), -1, NULL);
+}
+
+
+static void test_sms_concat_invalid(void)
+{
+    char *text = NULL;
+    char part[SMS_CONCAT_PART_LEN_MAX + 1] = { 0 };
+
+    zassert_equal(sms_concat_add(now, 20, 0, 2, "a", 1, &text), -EINVAL, NULL);
+    zassert_equal(sms_concat_add(now, 20, 3, 2, "a", 1, &text), -EINVAL, NULL);
+    zassert_equal(sms_concat_add(now, 20, 1, CONFIG_SMS_CONCAT_PARTS_MAX + 1, "a", 1, &text), -EINVAL, NULL);
+    zassert_equal(sms_concat_add(now, 20, 1, 2, part, sizeof(part), &text), -EINVAL, NULL);
+
+    zassert_equal(sms_concat_expire(now), -1, "An invalid part was stored");
+}
+
+
+void test_main(void)
+{
+    ztest_test_suite(sms_concat,
+      ztest_unit_test(test_sms_concat_out_of_order),
+      ztest_unit_test(test_sms_concat_duplicates),
+      ztest_unit_test(test_sms_concat_timeout),
+      ztest_unit_test(test_sms_concat_slots_full),
+      ztest_unit_test(test_sms_concat_invalid));
+    ztest_run_test_suite(sms_concat);
+}
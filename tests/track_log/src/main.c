@@ -0,0 +1,178 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+
+#include "src/track_log/track_log.h"
+
+#define READ_MAX            16
+#define OVERWRITE_APPENDS   4096
+
+static uint32_t appended_cnt;
+
+/**
+ * @brief Append a record and wait until the track log thread has written it
+ *
+ * @param timestamp timestamp of the record, used to tell records apart
+ */
+static void append(uint32_t timestamp)
+{
+    struct track_log_stats stats;
+    struct position_record record = {
+        .timestamp = timestamp,
+        .latitude = 576000000,
+        .longitude = 117000000,
+    };
+
+    while (-ENOMEM == track_log_append(&record)) {
+        k_msleep(1);
+    }
+
+    appended_cnt++;
+    do {
+        k_msleep(1);
+        track_log_stats_get(&stats);
+    } while (stats.appended < appended_cnt);
+}
+
+
+/**
+ * @brief Wait for the track log thread to scan the flash, then mark everything in the log as read
+ *
+ */
+static void drain(void)
+{
+    struct track_log_record records[READ_MAX];
+    struct track_log_stats stats;
+    int cnt;
+
+    while (-EAGAIN == track_log_read(records, 0)) {
+        k_msleep(1);
+    }
+
+    track_log_stats_get(&stats);
+    appended_cnt = stats.appended;
+
+    while ((cnt = track_log_read(records, ARRAY_SIZE(records))) > 0) {
+        zassert_ok(track_log_consume(records[cnt - 1].seq), "Consume failed");
+    }
+    zassert_equal(cnt, 0, "Read failed: %d", cnt);
+
+    track_log_stats_get(&stats);
+    zassert_equal(stats.count, 0, "%u records left after draining", stats.count);
+}
+
+
+static void test_track_log_read_consume(void)
+{
+    struct track_log_record records[READ_MAX];
+    struct track_log_stats stats;
+    int cnt;
+
+    drain();
+
+    for (uint32_t i = 1; i <= 5; i++) {
+        append(i);
+    }
+
+    cnt = track_log_read(records, ARRAY_SIZE(records));
+    zassert_equal(cnt, 5, "Read %d records", cnt);
+    for (int i = 0; i < cnt; i++) {
+        zassert_equal(records[i].record.timestamp, i + 1, "Record %d out of order", i);
+        zassert_equal(records[i].seq, records[0].seq + i, "Record %d has seq %u", i, records[i].seq);
+    }
+
+    zassert_ok(track_log_consume(records[2].seq), "Consume failed");
+
+    track_log_stats_get(&stats);
+    zassert_equal(stats.count, 2, "%u records left", stats.count);
+
+    cnt = track_log_read(records, ARRAY_SIZE(records));
+    zassert_equal(cnt, 2, "Read %d records", cnt);
+    zassert_equal(records[0].record.timestamp, 4, "Consumed the wrong records");
+    zassert_equal(records[1].record.timestamp, 5, "Consumed the wrong records");
+}
+
+
+static void test_track_log_read_from(void)
+{
+    struct track_log_record records[READ_MAX];
+    struct track_log_stats stats;
+    int cnt;
+
+    drain();
+
+    for (uint32_t i = 1; i <= 5; i++) {
+        append(i);
+    }
+
+    cnt = track_log_read(records, 1);
+    zassert_equal(cnt, 1, "Read %d records", cnt);
+
+    cnt = track_log_read_from(records[0].seq + 3, records, ARRAY_SIZE(records));
+    zassert_equal(cnt, 2, "Read %d records", cnt);
+    zassert_equal(records[0].record.timestamp, 4, "Read from the wrong record");
+    zassert_equal(records[1].record.timestamp, 5, "Read from the wrong record");
+
+    cnt = track_log_read_from(records[1].seq + 1, records, ARRAY_SIZE(records));
+    zassert_equal(cnt, 0, "Read %d records past the last one", cnt);
+
+    /* Reading does not mark anything as read */
+    track_log_stats_get(&stats);
+    zassert_equal(stats.count, 5, "%u records left", stats.count);
+}
+
+
+/* The records read are overwritten before they are consumed, consuming them must not touch the newer records that
+ *   took their place at the read position
+ */
+static void test_track_log_consume_after_overwrite(void)
+{
+    struct track_log_record records[READ_MAX];
+    struct track_log_stats stats;
+    uint32_t overwritten;
+    uint32_t last_seq;
+    uint32_t count;
+    int cnt;
+
+    drain();
+
+    for (uint32_t i = 1; i <= 4; i++) {
+        append(i);
+    }
+
+    cnt = track_log_read(records, ARRAY_SIZE(records));
+    zassert_equal(cnt, 4, "Read %d records", cnt);
+    last_seq = records[cnt - 1].seq;
+
+    track_log_stats_get(&stats);
+    overwritten = stats.overwritten;
+    for (uint32_t i = 0; stats.overwritten == overwritten; i++) {
+        zassert_true(i < OVERWRITE_APPENDS, "The log never wrapped");
+        append(1000 + i);
+        track_log_stats_get(&stats);
+    }
+    count = stats.count;
+
+    cnt = track_log_read(records, 1);
+    zassert_equal(cnt, 1, "Read %d records", cnt);
+    zassert_true(records[0].record.timestamp >= 1000, "The records read were not overwritten");
+
+    zassert_ok(track_log_consume(last_seq), "Consume failed");
+
+    track_log_stats_get(&stats);
+    zassert_equal(stats.count, count, "Consumed %u newer records", count - stats.count);
+
+    cnt = track_log_read(records, 1);
+    zassert_equal(cnt, 1, "Read %d records", cnt);
+    zassert_true(records[0].record.timestamp >= 1000, "Read an overwritten record");
+} /* test_track_log_consume_after_overwrite */
+
+
+void test_main(void)
+{
+    ztest_test_suite(track_log,
+      ztest_unit_test(test_track_log_read_consume),
+      ztest_unit_test(test_track_log_read_from),
+      ztest_unit_test(test_track_log_consume_after_overwrite));
+
+    ztest_run_test_suite(track_log);
+}
@@ -0,0 +1,119 @@
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <nrf_modem_gnss.h>
+#include <modem/lte_lc.h>
+#include <modem/modem_info.h>
+
+#include "src/lib/common_events.h"
+#include "src/battery/battery.h"
+#include "src/positioning/positioning.h"
+#include "src/positioning/ttff_test.h"
+#include "tests/fakes/fake_gnss.h"
+
+/* Runs the positioning module in TTFF test mode against a scripted GNSS in simulated time */
+
+/* The fix is handled by two threads after the GNSS event, allow a few ticks [ms] */
+#define TTFF_TOLERANCE  50
+#define TTFF_WAIT_MAX   (30 * 60)
+
+static const struct fake_gnss_search script[] = {
+    { .ttff = 30000, .latitude = 57.70, .longitude = 11.97, .sv_used = 6, .pdop = 1.5f, .hdop = 1.0f },
+    { .ttff = 45000, .latitude = 57.71, .longitude = 11.98, .sv_used = 8, .pdop = 2.0f, .hdop = 1.2f },
+    { .ttff = 90000, .latitude = 57.72, .longitude = 11.99, .sv_used = 10, .pdop = 2.5f, .hdop = 1.4f },
+};
+
+int lte_lc_init(void)
+{
+    return 0;
+}
+
+
+int modem_info_init(void)
+{
+    return 0;
+}
+
+
+void battery_sample_request(void)
+{
+}
+
+
+void battery_stats_get(struct battery_stats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+
+/**
+ * @brief Check that a TTFF is within TTFF_TOLERANCE of the scripted one
+ *
+ * @param ttff the measured TTFF [ms]
+ * @param expected the scripted TTFF [ms]
+ */
+static void ttff_check(uint32_t ttff, uint32_t expected)
+{
+    zassert_true((ttff >= expected) && (ttff <= expected + TTFF_TOLERANCE), "TTFF %u ms, expected %u ms", ttff,
+      expected);
+}
+
+
+static void test_ttff_test_results(void)
+{
+    struct ttff_test_stats stats;
+    struct fake_gnss_stats gnss;
+    uint32_t bin_width = CONFIG_GNSS_SAMPLE_MODE_TTFF_TEST_BIN_WIDTH * MSEC_PER_SEC;
+
+    fake_gnss_script_set(script, ARRAY_SIZE(script));
+    app_events_post(APP_EVENT_APPLICATION_INITIALIZED);
+
+    for (int i = 0; i < TTFF_WAIT_MAX; i++) {
+        ttff_test_stats_get(&stats);
+        if (stats.cnt >= ARRAY_SIZE(script)) {
+            break;
+        }
+        k_sleep(K_SECONDS(1));
+    }
+
+    zassert_equal(stats.cnt, ARRAY_SIZE(script), "%u of %u tests done", stats.cnt, ARRAY_SIZE(script));
+    ttff_check(stats.ttff_min, script[0].ttff);
+    ttff_check(stats.ttff_max, script[2].ttff);
+    ttff_check(stats.ttff_sum / stats.cnt, (script[0].ttff + script[1].ttff + script[2].ttff) / 3);
+    zassert_equal(stats.sv_used_sum, 6 + 8 + 10, "Satellites used: %u", stats.sv_used_sum);
+    zassert_equal(stats.pdop_sum, 15 + 20 + 25, "PDOP sum: %u", stats.pdop_sum);
+    zassert_equal(stats.hdop_sum, 10 + 12 + 14, "HDOP sum: %u", stats.hdop_sum);
+
+    for (int i = 0; i < ARRAY_SIZE(script); i++) {
+        zassert_equal(stats.histogram[script[i].ttff / bin_width], 1, "TTFF %u ms not in its bin", script[i].ttff);
+    }
+
+    /* Every test is a cold start with continuous tracking */
+    fake_gnss_stats_get(&gnss);
+    zassert_equal(gnss.fixes, ARRAY_SIZE(script), "%u fixes", gnss.fixes);
+    zassert_equal(gnss.nv_deletes, gnss.starts, "%u cold starts of %u", gnss.nv_deletes, gnss.starts);
+    zassert_equal(gnss.fix_interval, 1, "Fix interval %u", gnss.fix_interval);
+    zassert_equal(gnss.fix_retry, 0, "Fix retry %u", gnss.fix_retry);
+    zassert_equal(gnss.power_mode, NRF_MODEM_GNSS_PSM_DISABLED, "Power mode %u", gnss.power_mode);
+} /* test_ttff_test_results */
+
+
+static void test_ttff_test_snapshot(void)
+{
+    struct pos_snapshot snapshot;
+
+    /* The last fix of the script is the current snapshot */
+    zassert_ok(positioning_snapshot_get(&snapshot), "No snapshot");
+    zassert_within(snapshot.latitude, script[2].latitude, 1e-9, "Latitude %f", snapshot.latitude);
+    zassert_within(snapshot.longitude, script[2].longitude, 1e-9, "Longitude %f", snapshot.longitude);
+    zassert_equal(snapshot.sv_used, script[2].sv_used, "Satellites used: %u", snapshot.sv_used);
+}
+
+
+void test_main(void)
+{
+    ztest_test_suite(ttff_test,
+      ztest_unit_test(test_ttff_test_results),
+      ztest_unit_test(test_ttff_test_snapshot));
+    ztest_run_test_suite(ttff_test);
+}
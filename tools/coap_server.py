@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""Minimal CoAP server that receives the batches the tracker posts over UDP (see src/coap/coap_report.h).
+
+Usage: coap_server.py [PORT] [--drop N]
+Listens on all addresses, on port 5683 by default. Each confirmable POST is acknowledged with 2.04 Changed and its
+payload is printed as CSV like position_decode.py. --drop N ignores the first N requests to test retransmission.
+"""
+
+import socket
+import sys
+
+import position_decode
+
+TYPE_CON = 0
+TYPE_ACK = 2
+METHOD_POST = 0x02
+CODE_CHANGED = 0x44
+CODE_BAD_REQUEST = 0x80
+PAYLOAD_MARKER = 0xff
+
+
+def payload_get(msg):
+    """Return the payload of a CoAP message, skipping the token and options."""
+    pos = 4 + (msg[0] & 0x0f)
+    while pos < len(msg) and msg[pos] != PAYLOAD_MARKER:
+        delta, length = msg[pos] >> 4, msg[pos] & 0x0f
+        pos += 1
+        for nibble in (delta, length):
+            if nibble == 13:
+                pos += 1
+            elif nibble == 14:
+                pos += 2
+        if length == 13:
+            length = msg[pos - 1] + 13
+        elif length == 14:
+            length = (msg[pos - 2] << 8 | msg[pos - 1]) + 269
+        pos += length
+    return msg[pos + 1:]
+
+
+def main():
+    args = sys.argv[1:]
+    drop = 0
+    if "--drop" in args:
+        drop = int(args[args.index("--drop") + 1])
+        del args[args.index("--drop"):args.index("--drop") + 2]
+    port = int(args[0]) if args else 5683
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("", port))
+    print(position_decode.CSV_HEADER, flush=True)
+
+    while True:
+        msg, addr = sock.recvfrom(1500)
+        if len(msg) < 4 or msg[0] >> 6 != 1 or (msg[0] >> 4) & 0x3 != TYPE_CON:
+            continue
+        if drop > 0:
+            drop -= 1
+            print("# dropped request %d from %s" % (msg[2] << 8 | msg[3], addr[0]), file=sys.stderr, flush=True)
+            continue
+
+        code = CODE_CHANGED
+        try:
+            if msg[1] != METHOD_POST:
+                raise ValueError("unsupported method 0x%02x" % msg[1])
+            position_decode.print_csv(*position_decode.decode_data(payload_get(msg)))
+        except (IndexError, ValueError) as err:
+            print("# %s: %s" % (addr[0], err), file=sys.stderr, flush=True)
+            code = CODE_BAD_REQUEST
+
+        token_len = msg[0] & 0x0f
+        sock.sendto(bytes([0x40 | TYPE_ACK << 4 | token_len, code]) + msg[2:4 + token_len], addr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Decode position messages sent by the tracker (see src/lib/position_codec.h).
+
+Usage: position_decode.py [MESSAGE ...]
+Messages are read from stdin, one per line, when none are given.
+"""
+
+import base64
+import datetime
+import sys
+
+VERSION = 1
+FLAG_MOVEMENT = 1 << 0
+
+
+def varint_get(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    return (value >> 1) ^ -(value & 1), pos
+
+
+def decode(text):
+    return decode_data(base64.b64decode(text.strip() + "=" * (-len(text.strip()) % 4)))
+
+
+def decode_data(data):
+    version = data[0] >> 4
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+    cnt = (data[0] & 0x0f) + 1
+    flags = data[1]
+    voltage, pos = varint_get(data, 2)
+
+    fixes = []
+    prev = [0, 0, 0, 0]
+    for _ in range(cnt):
+        for i in range(4):
+            delta, pos = varint_get(data, pos)
+            prev[i] += delta
+        accuracy, pos = varint_get(data, pos)
+        fixes.append({
+            "time": datetime.datetime.fromtimestamp(prev[0], datetime.timezone.utc).isoformat(),
+            "latitude": prev[1] / 1e5,
+            "longitude": prev[2] / 1e5,
+            "altitude": prev[3],
+            "accuracy": accuracy,
+        })
+    return flags, voltage, fixes
+
+
+CSV_HEADER = "time,latitude,longitude,altitude,accuracy,voltage,movement"
+
+
+def print_csv(flags, voltage, fixes):
+    for fix in fixes:
+        print("%s,%.5f,%.5f,%d,%d,%d,%d" % (fix["time"], fix["latitude"], fix["longitude"], fix["altitude"],
+                                            fix["accuracy"], voltage, flags & FLAG_MOVEMENT), flush=True)
+
+
+def main():
+    messages = sys.argv[1:] or [line for line in sys.stdin if line.strip()]
+    print(CSV_HEADER)
+    for message in messages:
+        print_csv(*decode(message))
+
+
+if __name__ == "__main__":
+    main()